@@ -3,57 +3,60 @@
 #include <vector>
 #include <iostream>
 #include <optional> // Required for SFML 3.0
+#include <string>
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "pass_predictor.hpp"
+#include "visibility_matrix.hpp"
+#include "integrators.hpp"
+#include "render_batch.hpp"
+#include "trail_arena.hpp"
+#include "sim_thread.hpp"
+#include "tle_catalog.hpp"
+#include "sgp4.hpp"
+#include "coverage_map.hpp"
+#include "checkpoint.hpp"
+#include "time_warp.hpp"
+#include "state_publisher.hpp"
+#include "tracker_satellite.hpp"
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
 
-// --- PHYSICS CONSTANTS ---
-const double G = 6.67430e-11;
-const double M_EARTH = 5.972e24;
-const double R_EARTH = 6371000.0;
-const double EARTH_ROTATION_SPEED = 7.2921159e-5; // rad/s
-
-struct Vector3 {
-    double x, y, z;
-    Vector3 operator+(const Vector3& other) const { return {x+other.x, y+other.y, z+other.z}; }
-    Vector3 operator*(double s) const { return {x*s, y*s, z*s}; }
-    double magnitude() const { return std::sqrt(x*x + y*y + z*z); }
+// Everything the renderer needs from one physics step
+struct TrackerSnapshot {
+    Vector3 pos, vel;
+    double time = 0.0;
+    double dist = 0.0, elevationDeg = 0.0;
+    bool visible = false;
+    bool haveNextPass = false;
+    Pass nextPass = {};
+    std::vector<char> stationSees;      // network station k has the satellite in view
+    IntegratorKind integrator = IntegratorKind::ForestRuth;
+    WarpPath warpPath = WarpPath::Integrated;
+    int speedMultiplier = 0;
+    double step = 0.0, carriedStep = 0.0, lastFit = 0.0;    // the rest of the physics state, for checkpoints
 };
 
-class Satellite {
-public:
-    Vector3 pos;
-    Vector3 vel;
-
-    Satellite(Vector3 p, Vector3 v) : pos(p), vel(v) {}
-
-    void update(double dt) {
-        double r = pos.magnitude();
-        double accelMag = (G * M_EARTH) / (r * r * r);
-        Vector3 accel = pos * (-accelMag);
-        vel = vel + (accel * dt);
-        pos = pos + (vel * dt);
+// Usage: ./orbit_sim [stations.txt] [--coverage constellation.tle] [--checkpoint file.ckpt] [--publish /name]
+// (extra ground stations besides Agartala; a constellation drawn on the map
+// and used by the C key coverage overlay, which otherwise covers the
+// tracked satellite alone; the checkpoint
+// K writes, resumed from at startup when it exists; a shared-memory ring
+// that gets the satellite's state every physics step, see state_publisher.hpp)
+int main(int argc, char** argv) {
+    const char* stationPath = nullptr;
+    const char* coveragePath = nullptr;
+    std::string checkpointPath = "tracker.ckpt";
+    const char* publishName = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--coverage" && i + 1 < argc) coveragePath = argv[++i];
+        else if (std::string(argv[i]) == "--checkpoint" && i + 1 < argc) checkpointPath = argv[++i];
+        else if (std::string(argv[i]) == "--publish" && i + 1 < argc) publishName = argv[++i];
+        else stationPath = argv[i];
     }
-};
-
-// --- Geography Helper ---
-Vector3 getStationPos(double lat, double lon, double time) {
-    double latRad = lat * (M_PI / 180.0);
-    double lonRad = lon * (M_PI / 180.0);
-
-    // 1. Fixed Earth Position (ECEF)
-    double x = R_EARTH * std::cos(latRad) * std::cos(lonRad);
-    double y = R_EARTH * std::cos(latRad) * std::sin(lonRad);
-    double z = R_EARTH * std::sin(latRad);
-
-    // 2. Rotate with Earth 
-    double rotationAngle = EARTH_ROTATION_SPEED * time;
 
-    // Rotation Matrix (Z-axis)
-    double x_rot = x * std::cos(rotationAngle) - y * std::sin(rotationAngle);
-    double y_rot = x * std::sin(rotationAngle) + y * std::cos(rotationAngle);
-    
-    return {x_rot, y_rot, z};
-}
-
-int main() {
     sf::Texture mapTexture;
     if (!mapTexture.loadFromFile("earth.jpg")) {
         std::cerr << "Error: Could not find earth.jpg" << std::endl;
@@ -79,11 +82,21 @@ int main() {
 
     Satellite sat({r_init, 0, 0}, {vx, vy, vz});
 
-    // Trail logic
-    std::vector<sf::CircleShape> breadcrumbs;
     double totalTime = 0.0;
     double dt = 1.0; 
-    int speedMultiplier = 10;
+    std::atomic<int> speedMultiplier{10};     // sim seconds per physics step (+/- keys)
+
+    // Trail logic: last 1000 ECI samples, CRUMB_SPACING apart, sampled along
+    // the orbit between physics snapshots (closed form, so the track stays
+    // dense at any warp; at most CRUMB_MAX_PER_FRAME new ones per frame);
+    // mapped to the ground track at draw time with each sample's earth angle
+    TrailArena breadcrumbs(1, 1000, 0.0);
+    const double CRUMB_SPACING = 10.0;
+    const int CRUMB_MAX_PER_FRAME = 64;
+    double lastCrumb = 0.0;
+    bool haveCrumb = false;
+    RenderBatch crumbDots(sf::PrimitiveType::Triangles);     // all breadcrumbs, one draw
+    RenderBatch stationDots(sf::PrimitiveType::Triangles);
 
     // --- DEFINE CITY (Agartala) ---
     // Calculate static screen position once
@@ -98,64 +111,347 @@ int main() {
     cityDot.setPosition({cityScreenX, cityScreenY});
     cityDot.setOrigin({4, 4}); // Center it
 
+    // --- PASS PREDICTION ---
+    // Analytic orbit fitted to the integrated state, re-fitted every few
+    // hours so the Euler drift never piles up in the predicted times.
+    GroundStation station = {myLat, myLon, 0.0, 10.0};
+    PassPredictor predictor(station);
+    const double PASS_WINDOW = 24 * 3600.0;
+    const double REFIT_INTERVAL = 6 * 3600.0;
+    KeplerBatch fitted;
+    std::vector<Pass> passes;
+    double lastFit = -REFIT_INTERVAL;
+    auto refitPasses = [&]() {
+        fitted.clear();
+        fitted.addFromState(sat.pos, sat.vel, totalTime);
+        passes.clear();
+        predictor.findPasses([&](double t) { return fitted.position(0, t); }, fitted.period(0),
+                             totalTime, totalTime + PASS_WINDOW, 0, passes);
+    };
+
+    // --- STATION NETWORK ---
+    std::vector<GroundStation> network = {station};
+    std::vector<std::string> networkNames = {"Agartala"};
+    if (stationPath && !loadStationFile(stationPath, network, networkNames)) {
+        std::cerr << "WARNING: Could not read station list " << stationPath << std::endl;
+    }
+    VisibilityMatrix networkVis(network);
+    VisibilityStep networkLinks;
+    std::vector<sf::Vector2f> networkScreen;
+    for (const auto& st : network) {
+        networkScreen.push_back({(float)((st.lon * (M_PI/180.0) + M_PI) / (2 * M_PI) * width),
+                                 (float)((M_PI/2 - st.lat * (M_PI/180.0)) / M_PI * height)});
+    }
+
+    // --- COVERAGE OVERLAY ---
+    // C cycles access time / max gap / mean revisit / off. The first press
+    // computes 24 h of coverage on a 0.25 deg grid (10 deg mask) on a worker
+    // thread, from the current time, for the constellation file or the
+    // tracked satellite's current orbit.
+    const CoverageMap::Metric COVERAGE_METRICS[] = {CoverageMap::Metric::AccessTime, CoverageMap::Metric::MaxGap,
+                                                    CoverageMap::Metric::MeanGap};
+    CoverageMap coverage(0.25, 10.0);
+    std::thread coverageWorker;
+    std::atomic<bool> coverageReady{false};
+    int coverageMode = -1;                  // index into COVERAGE_METRICS, -1 = off
+    int shownMode = -1;
+    float coverageMax = 0;
+    sf::Texture coverageTexture;
+    sf::Sprite coverageSprite(coverageTexture);
+    TleCatalog constellation;
+    if (coveragePath && !constellation.load(coveragePath)) {
+        std::cerr << "WARNING: Could not read constellation " << coveragePath << std::endl;
+    }
+    // The constellation is also drawn, in closed form at the tracker's time
+    // (seconds from its newest epoch), so it costs the same at any warp
+    KeplerBatch constellationOrbits;
+    double constellationTheta0 = 0.0;
+    std::vector<double> constX, constY, constZ;
+    RenderBatch constellationDots(sf::PrimitiveType::Triangles);
+    if (!constellation.records.empty()) {
+        constellation.toKeplerBatch(constellationOrbits, constellation.latestEpochJD());
+        constellationTheta0 = gstime(constellation.latestEpochJD());
+        constX.resize(constellationOrbits.size());
+        constY.resize(constellationOrbits.size());
+        constZ.resize(constellationOrbits.size());
+    }
+
+    // --- CHECKPOINT ---
+    // K captures the latest physics snapshot and the breadcrumbs (a copy,
+    // on this thread) and writes them in the background. Restarting with
+    // the same file resumes there; with the same speed and integrator the
+    // run continues exactly as it would have.
+    CheckpointWriter checkpointWriter;
+    Checkpoint checkpoint;
+    {
+        CheckpointReader saved;
+        size_t n = 0;
+        bool intact = saved.open(checkpointPath.c_str()) && saved.verify();
+        const double* st = intact ? saved.get<double>("tracker.state", n) : nullptr;
+        // Nothing from the file is trusted: an unknown integrator would
+        // freeze the satellite, a step <= 0 stall the fixed-step loop
+        bool valid = st && n == 11 && st[6] >= 0 && st[6] < INTEGRATOR_KIND_COUNT && st[7] > 0 &&
+                     st[8] >= 0 && st[9] >= 1 && st[9] <= 10000;
+        if (valid && restoreTrails(saved, breadcrumbs)) {
+            sat.pos = {st[0], st[1], st[2]};
+            sat.vel = {st[3], st[4], st[5]};
+            sat.time = totalTime = saved.header.simTime;
+            sat.integrator.select((IntegratorKind)(int)st[6]);
+            sat.integrator.dt = st[7];
+            sat.integrator.setCarriedStep(st[8]);
+            speedMultiplier.store((int)st[9]);
+            lastFit = st[10];
+            // The pass list isn't saved: predict it now rather than at the
+            // next scheduled refit, which can be hours of sim time away
+            refitPasses();
+            std::cout << "Resumed from " << checkpointPath << " at t = " << totalTime << " s" << std::endl;
+        } else if (saved.isOpen()) {
+            std::cerr << "WARNING: " << checkpointPath << (intact ? " is not a valid tracker checkpoint" : " is corrupt")
+                      << ", starting fresh" << std::endl;
+        }
+    }
+
+    // --- PHYSICS THREAD ---
+    // 60 fixed steps per second of speedMultiplier sim-seconds each, off the
+    // render loop: a slow step (big multiplier, DP54) no longer drops frames
+    // and the frame limiter no longer throttles the simulation.
+    const double PHYSICS_RATE = 60.0;
+    std::atomic<int> integratorRequest{-1};
+    TripleBuffer<TrackerSnapshot> snapshots;
+    TrackerSnapshot blank;
+    blank.pos = sat.pos;
+    blank.integrator = sat.integrator.kind;
+    blank.step = sat.integrator.dt;
+    blank.speedMultiplier = speedMultiplier.load();
+    blank.stationSees.assign(network.size(), 0);
+    snapshots.fill(blank);
+
+    StatePublisher publisher;
+    if (publishName && !publisher.open(publishName, 1)) std::cerr << "WARNING: Could not create shared memory " << publishName << std::endl;
+
+    auto physicsStep = [&]() {
+        int request = integratorRequest.exchange(-1);
+        if (request >= 0) sat.integrator.select((IntegratorKind)request);
+
+        int multiplier = speedMultiplier.load();
+        sat.update(multiplier * dt);
+        totalTime += multiplier * dt;
+
+        if (totalTime - lastFit >= REFIT_INTERVAL) {
+            refitPasses();
+            lastFit = totalTime;
+        }
+
+        TrackerSnapshot& snap = snapshots.back();
+        snap.pos = sat.pos;
+        snap.vel = sat.vel;
+        snap.time = totalTime;
+        snap.integrator = sat.integrator.kind;
+        snap.warpPath = sat.warp.lastPath();
+        snap.speedMultiplier = multiplier;
+        snap.step = sat.integrator.dt;
+        snap.carriedStep = sat.integrator.carriedStep();
+        snap.lastFit = lastFit;
+
+        // Elevation above the station's 10 deg mask (not just "above the horizon plane")
+        Vector3 cityPos3D = getStationPos(myLat, myLon, totalTime);
+        snap.dist = (sat.pos - cityPos3D).magnitude();
+        snap.elevationDeg = predictor.elevation(sat.pos, totalTime) * 180.0 / M_PI;
+        snap.visible = snap.elevationDeg >= station.minElevation;
+
+        // Every other station that can see the satellite right now
+        networkVis.compute(totalTime, EARTH_ROTATION_SPEED * totalTime, &sat.pos.x, &sat.pos.y, &sat.pos.z, 1, networkLinks);
+        for (size_t k = 0; k < network.size(); k++) snap.stationSees[k] = networkLinks.count(k) > 0;
+        if (publisher.isOpen()) {
+            uint8_t flags = snap.visible ? STATE_VISIBLE_HOME | STATE_VISIBLE_ANY : 0;
+            if (networkLinks.pairs() > 0) flags |= STATE_VISIBLE_ANY;
+            publisher.publish(totalTime, 1, &sat.pos.x, &sat.pos.y, &sat.pos.z, &sat.vel.x, &sat.vel.y, &sat.vel.z, &flags);
+        }
+
+        // Next predicted pass that hasn't set yet
+        snap.haveNextPass = false;
+        for (const auto& p : passes) if (p.los > totalTime) { snap.nextPass = p; snap.haveNextPass = true; break; }
+
+        snapshots.publish();
+    };
+    FixedStepThread physics;
+    physics.start(PHYSICS_RATE, physicsStep);
+
+    sf::Clock frameClock;
+    double frameMs = 1000.0 / 60.0;
+
     while (window.isOpen()) {
         while (const std::optional event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) window.close();
+            if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                if (key->scancode == sf::Keyboard::Scancode::I) {
+                    integratorRequest.store(((int)snapshots.front().integrator + 1) % INTEGRATOR_KIND_COUNT);
+                }
+                if (key->scancode == sf::Keyboard::Scancode::Equal) speedMultiplier.store(std::min(10000, speedMultiplier.load() * 2));
+                if (key->scancode == sf::Keyboard::Scancode::Hyphen) speedMultiplier.store(std::max(1, speedMultiplier.load() / 2));
+                if (key->scancode == sf::Keyboard::Scancode::K) {
+                    const TrackerSnapshot& now = snapshots.front();
+                    checkpoint.clear();
+                    checkpoint.simTime = now.time;
+                    checkpoint.add("tracker.state", {now.pos.x, now.pos.y, now.pos.z, now.vel.x, now.vel.y, now.vel.z,
+                                                     (double)(int)now.integrator, now.step,
+                                                     now.carriedStep, (double)now.speedMultiplier, now.lastFit});
+                    saveTrails(checkpoint, breadcrumbs);
+                    if (checkpointWriter.submit(checkpoint, checkpointPath)) {
+                        std::cout << "Checkpoint at t = " << now.time << " s -> " << checkpointPath << std::endl;
+                    }
+                }
+                if (key->scancode == sf::Keyboard::Scancode::C) {
+                    coverageMode = coverageMode + 1 < 3 ? coverageMode + 1 : -1;
+                    if (coverageMode == 0 && !coverageWorker.joinable()) {
+                        const TrackerSnapshot& now = snapshots.front();
+                        KeplerBatch orbits;
+                        double start = now.time;
+                        if (!constellation.records.empty()) {
+                            // Catalog time runs from its newest epoch; the map is Earth-fixed either way
+                            double refJD = constellation.latestEpochJD();
+                            constellation.toKeplerBatch(orbits, refJD);
+                            coverage.theta0 = gstime(refJD);
+                            start = 0.0;
+                        } else {
+                            orbits.addFromState(now.pos, now.vel, now.time);
+                        }
+                        coverageWorker = std::thread([&, orbits, start] {
+                            WorkStealingPool pool;
+                            coverage.compute(orbits.size(), [&](double t, double* x, double* y, double* z) {
+                                orbits.propagate(t, x, y, z);
+                            }, start, start + 24 * 3600.0, 60.0, &pool);
+                            coverageReady.store(true);
+                        });
+                    }
+                }
+            }
         }
+        frameMs += 0.1 * (frameClock.restart().asSeconds() * 1000.0 - frameMs);
 
-        // --- 1. PHYSICS UPDATE ---
-        for(int i=0; i<speedMultiplier; i++) {
-            sat.update(dt);
-            totalTime += dt;
+        // --- 1. LATEST PHYSICS STATE (never waits for the physics thread) ---
+        if (snapshots.acquire()) {
+            const TrackerSnapshot& fresh = snapshots.front();
+            double from = haveCrumb ? lastCrumb : fresh.time;
+            double spacing = std::max(CRUMB_SPACING, (fresh.time - from) / CRUMB_MAX_PER_FRAME);
+            for (double t = from + spacing; t <= fresh.time + 1e-6; t += spacing) {
+                OrbitState s = {fresh.pos, fresh.vel};
+                if (!keplerJump(s, t - fresh.time)) s.pos = fresh.pos;
+                breadcrumbs.push(0, t, s.pos.x, s.pos.y, s.pos.z);
+                lastCrumb = t;
+            }
+            if (!haveCrumb) {
+                breadcrumbs.push(0, fresh.time, fresh.pos.x, fresh.pos.y, fresh.pos.z);
+                lastCrumb = fresh.time;
+                haveCrumb = true;
+            }
         }
+        const TrackerSnapshot& snap = snapshots.front();
 
         // --- 2. MATH: SATELLITE MAPPING ---
-        double lon = std::atan2(sat.pos.y, sat.pos.x);
-        lon -= (EARTH_ROTATION_SPEED * totalTime); 
+        double lon = std::atan2(snap.pos.y, snap.pos.x);
+        lon -= (EARTH_ROTATION_SPEED * snap.time); 
         
         while (lon < -M_PI) lon += 2*M_PI;
         while (lon >  M_PI) lon -= 2*M_PI;
 
-        double lat = std::asin(sat.pos.z / sat.pos.magnitude());
+        double lat = std::asin(snap.pos.z / snap.pos.magnitude());
 
         float screenX = (lon + M_PI) / (2 * M_PI) * width;
         float screenY = (M_PI/2 - lat) / M_PI * height;
 
-        // Add trail
-        sf::CircleShape dot(2);
-        dot.setFillColor(sf::Color::Red);
-        dot.setPosition({screenX, screenY});
-        breadcrumbs.push_back(dot);
-        if (breadcrumbs.size() > 1000) breadcrumbs.erase(breadcrumbs.begin());
-
-        // --- 3. MATH: VISIBILITY CHECK ---
-        Vector3 cityPos3D = getStationPos(myLat, myLon, totalTime);
-        Vector3 rangeVec = {sat.pos.x - cityPos3D.x, sat.pos.y - cityPos3D.y, sat.pos.z - cityPos3D.z};
-        double dist = rangeVec.magnitude();
-        double dotProd = cityPos3D.x * rangeVec.x + cityPos3D.y * rangeVec.y + cityPos3D.z * rangeVec.z;
-
-
-        // --- 4. RENDER SECTION (Order is Critical!) ---
+        // --- 3. RENDER SECTION (Order is Critical!) ---
         window.clear(); // 1. Wipe screen
         
         window.draw(mapSprite); // 2. Draw Background
 
+        if (coverageMode >= 0 && coverageReady.load()) {
+            if (shownMode != coverageMode) {
+                std::vector<uint8_t> rgba;
+                coverageMax = coverage.colorize(COVERAGE_METRICS[coverageMode], rgba);
+                sf::Image overlay;
+                overlay.resize({(unsigned)coverage.cols, (unsigned)coverage.rows}, rgba.data());
+                if (coverageTexture.loadFromImage(overlay)) {
+                    coverageSprite.setTexture(coverageTexture, true);
+                    coverageSprite.setScale({(float)width / coverage.cols, (float)height / coverage.rows});
+                }
+                shownMode = coverageMode;
+            }
+            window.draw(coverageSprite);
+        }
+
         window.draw(cityDot);   // 3. Draw City (on top of map)
 
+        // Network stations (dim) and their links
+        sf::VertexArray networkLines(sf::PrimitiveType::Lines);
+        stationDots.clear();
+        for (size_t k = 1; k < network.size(); k++) {
+            stationDots.disc(networkScreen[k], 2, sf::Color(255, 220, 120));
+            if (snap.stationSees[k]) {
+                networkLines.append(sf::Vertex{networkScreen[k], sf::Color(0, 160, 0)});
+                networkLines.append(sf::Vertex{sf::Vector2f(screenX, screenY), sf::Color(0, 160, 0)});
+            }
+        }
+        stationDots.draw(window);
+        window.draw(networkLines);
+
         // 4. Draw Visibility Line (on top of city)
-        if (dotProd > 0) {
+        char metrics[192];
+        int used = std::snprintf(metrics, sizeof(metrics), " | %s | %dx (%s) | sim %.0f steps/s (%.2f ms) | frame %.1f ms",
+                                 integratorName(snap.integrator), snap.speedMultiplier, warpPathName(snap.warpPath),
+                                 physics.measuredRate(), physics.stepSeconds() * 1000.0, frameMs);
+        if (coverageMode >= 0) {
+            if (coverageReady.load()) {
+                CoverageMap::Metric m = COVERAGE_METRICS[coverageMode];
+                std::snprintf(metrics + used, sizeof(metrics) - used, " | coverage: %s, red = %.1f %s",
+                              CoverageMap::metricName(m), m == CoverageMap::Metric::AccessTime ? coverageMax / 3600.0 : coverageMax / 60.0,
+                              m == CoverageMap::Metric::AccessTime ? "h" : "min");
+            } else {
+                std::snprintf(metrics + used, sizeof(metrics) - used, " | coverage: computing...");
+            }
+        }
+        if (snap.visible) {
             sf::VertexArray line(sf::PrimitiveType::Lines, 2);
             line[0] = sf::Vertex{ sf::Vector2f(cityScreenX, cityScreenY), sf::Color::Green };
             line[1] = sf::Vertex{ sf::Vector2f(screenX, screenY), sf::Color::Green };
             window.draw(line);
             
-            window.setTitle("Satellite Ground Track | VISIBLE: " + std::to_string((int)(dist/1000)) + " km");
+            window.setTitle("Satellite Ground Track | VISIBLE: " + std::to_string((int)(snap.dist/1000)) + " km | El "
+                            + std::to_string((int)snap.elevationDeg) + " deg" + metrics);
+        } else if (snap.haveNextPass) {
+            int wait = (int)(snap.nextPass.aos - snap.time);
+            window.setTitle("Satellite Ground Track | NO SIGNAL | Next AOS in " + std::to_string(wait / 3600) + "h "
+                            + std::to_string(wait / 60 % 60) + "m (max el " + std::to_string((int)snap.nextPass.maxElevation) + " deg)" + metrics);
         } else {
-            window.setTitle("Satellite Ground Track | NO SIGNAL");
+            window.setTitle(std::string("Satellite Ground Track | NO SIGNAL") + metrics);
+        }
+
+        // Constellation (if any)
+        constellationDots.clear();
+        constellationOrbits.propagate(snap.time, constX.data(), constY.data(), constZ.data());
+        double constTheta = constellationTheta0 + EARTH_ROTATION_SPEED * snap.time;
+        for (size_t i = 0; i < constellationOrbits.size(); i++) {
+            double r = std::sqrt(constX[i] * constX[i] + constY[i] * constY[i] + constZ[i] * constZ[i]);
+            double cLon = std::remainder(std::atan2(constY[i], constX[i]) - constTheta, 2 * M_PI);
+            double cLat = std::asin(constZ[i] / r);
+            constellationDots.square({(float)((cLon + M_PI) / (2 * M_PI) * width) - 1.0f,
+                                      (float)((M_PI/2 - cLat) / M_PI * height) - 1.0f}, 2, sf::Color(180, 180, 255));
         }
+        constellationDots.draw(window);
 
         // 5. Draw Trails & Satellite (on top of everything)
-        for (const auto& crumb : breadcrumbs) window.draw(crumb);
+        // CircleShape(2) at the crumb's top-left: centre is 2 px in
+        crumbDots.clear();
+        breadcrumbs.forEach(0, [&](const TrailSample& c) {
+            double r = std::sqrt((double)c.x * c.x + (double)c.y * c.y + (double)c.z * c.z);
+            double cLon = std::atan2(c.y, c.x) - EARTH_ROTATION_SPEED * (breadcrumbs.epoch + c.t);
+            cLon = std::remainder(cLon, 2 * M_PI);
+            double cLat = std::asin(c.z / r);
+            float cx = (cLon + M_PI) / (2 * M_PI) * width;
+            float cy = (M_PI/2 - cLat) / M_PI * height;
+            crumbDots.disc({cx + 2, cy + 2}, 2, sf::Color::Red, 6);
+        });
+        crumbDots.draw(window);
         
         sf::CircleShape head(5);
         head.setFillColor(sf::Color::Cyan);
@@ -164,5 +460,8 @@ int main() {
 
         window.display(); // 6. Show frame
     }
+    physics.stop();
+    if (coverageWorker.joinable()) coverageWorker.join();
+    if (!checkpointWriter.wait()) std::cerr << "WARNING: Could not write " << checkpointPath << std::endl;
     return 0;
 }
\ No newline at end of file
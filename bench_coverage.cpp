@@ -0,0 +1,89 @@
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "work_stealing.hpp"
+#include "coverage_map.hpp"
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Coverage map of a Walker constellation: wall time of the footprint /
+// row-interval method at full resolution, and a cell-by-cell check against
+// brute force (every cell x every satellite x every step) on a coarse grid.
+//
+// Build: clang++ bench_coverage.cpp -o bench_coverage -std=c++17 -O3 -march=native -fno-trapping-math -pthread
+// Run:   ./bench_coverage [satellites] [hours] [cell_deg] [step_s]   (default 1000 24 0.25 60)
+
+int main(int argc, char** argv) {
+    size_t sats = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    double hours = argc > 2 ? std::atof(argv[2]) : 24.0;
+    double cell = argc > 3 ? std::atof(argv[3]) : 0.25;
+    double step = argc > 4 ? std::atof(argv[4]) : 60.0;
+    const double MASK = 10.0;
+
+    // Walker delta, 550 km at 53 deg (sats / 25 planes)
+    size_t planes = sats >= 25 ? 25 : 1, perPlane = (sats + planes - 1) / planes;
+    KeplerBatch batch;
+    double a = R_EARTH + 550e3, n = std::sqrt(MU_EARTH / (a * a * a));
+    for (size_t i = 0; i < sats; i++) {
+        size_t p = i / perPlane, k = i % perPlane;
+        batch.add(53.0 * M_PI / 180.0, 2 * M_PI * p / planes, 0.0, 0.0,
+                  2 * M_PI * k / perPlane + 2 * M_PI * p / (planes * perPlane), n);
+    }
+    auto positions = [&](double t, double* x, double* y, double* z) { batch.propagate(t, x, y, z); };
+
+    WorkStealingPool pool;
+    CoverageMap map(cell, MASK);
+    auto t0 = std::chrono::steady_clock::now();
+    map.compute(sats, positions, 0.0, hours * 3600.0, step, &pool);
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    double meanAccess = 0, worstGap = 0, meanRevisit = 0;
+    size_t never = 0;
+    for (size_t c = 0; c < map.cells(); c++) {
+        meanAccess += map.accessTime[c];
+        worstGap = std::fmax(worstGap, map.maxGap[c]);
+        meanRevisit += map.meanGap[c];
+        never += map.accesses[c] == 0;
+    }
+    long steps = (long)std::floor(hours * 3600.0 / step + 1e-9) + 1;
+    std::printf("--- Coverage (%zu sats, %.0f h at %.0f s, %.2f deg grid = %zu cells, %u threads) ---\n",
+                sats, hours, step, cell, map.cells(), std::thread::hardware_concurrency());
+    std::printf("Wall time    : %.2f s | %.1f ns per cell-step\n", sec, sec / (map.cells() * (double)steps) * 1e9);
+    std::printf("Cells        : mean access %.1f%% of the window | mean revisit %.1f min | worst gap %.1f h | never seen %zu\n",
+                100.0 * meanAccess / map.cells() / (hours * 3600.0), meanRevisit / map.cells() / 60.0, worstGap / 3600.0, never);
+
+    // --- Brute force on a coarse grid ---
+    CoverageMap coarse(2.0, MASK);
+    coarse.compute(sats, positions, 0.0, hours * 3600.0, step);
+    std::vector<float> access(coarse.cells(), 0.0f);
+    std::vector<double> x(sats), y(sats), z(sats);
+    double sinMask = std::sin(MASK * M_PI / 180.0);
+    for (long s = 0; s < steps; s++) {
+        double t = s * step, th = EARTH_ROTATION_SPEED * t;
+        batch.propagate(t, x.data(), y.data(), z.data());
+        for (int r = 0; r < coarse.rows; r++) {
+            for (int c = 0; c < coarse.cols; c++) {
+                double lat = coarse.cellLat(r) * M_PI / 180.0, lon = coarse.cellLon(c) * M_PI / 180.0 + th;
+                Vector3 up = {std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat)};
+                Vector3 site = up * R_EARTH;
+                bool seen = false;
+                for (size_t i = 0; i < sats && !seen; i++) {
+                    Vector3 rho = Vector3{x[i], y[i], z[i]} - site;
+                    seen = rho.dot(up) >= sinMask * rho.magnitude();
+                }
+                if (seen && s + 1 < steps) access[(size_t)r * coarse.cols + c] += (float)step;
+            }
+        }
+    }
+    size_t mismatched = 0;
+    double worstDiff = 0;
+    for (size_t c = 0; c < coarse.cells(); c++) {
+        double d = std::fabs(access[c] - coarse.accessTime[c]);
+        worstDiff = std::fmax(worstDiff, d);
+        mismatched += d > 2 * step;
+    }
+    std::printf("Brute check  : %zu cells at 2 deg, access time differs by > 2 steps in %zu (worst %.0f s)\n",
+                coarse.cells(), mismatched, worstDiff);
+    return mismatched * 1000 <= coarse.cells() ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "orbit_common.hpp"
+#include "force_models.hpp"
+#include "work_stealing.hpp"
+#include "debris_cloud.hpp"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Debris cloud: particles*steps/s and bytes per fragment for a breakup of
+// `fragments` pieces at ISS altitude under Earth only, + J2, + Sun/Moon and
+// + mutual gravity (Barnes-Hut); the Barnes-Hut pull against the direct
+// O(N^2) sum on a sample; J2 against Zonal<2>; and the energy drift of the
+// leapfrog over a day of two-body motion.
+//
+// Build: clang++ bench_debris.cpp -o bench_debris -std=c++17 -O3 -march=native -fno-trapping-math -fno-math-errno -pthread
+// Run:   ./bench_debris [fragments] [steps]      (default 100000 50)
+
+using Clock = std::chrono::steady_clock;
+static double secSince(Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); }
+
+// A 420 t parent on a 420 km, 51.6 deg circular orbit
+static void breakup(DebrisCloud& cloud, size_t n, uint64_t seed) {
+    double r = R_EARTH + 420e3, v = std::sqrt(MU_EARTH / r), inc = 51.6 * M_PI / 180.0;
+    cloud.breakup({r, 0, 0}, {0, v * std::cos(inc), v * std::sin(inc)}, n, 420e3, 20.0, seed);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 50;
+    const double H = 10.0;
+    WorkStealingPool pool;
+
+    std::printf("--- Debris Cloud (%zu fragments, %d leapfrog steps of %.0f s, %u threads) ---\n", n, steps, H,
+                std::thread::hardware_concurrency());
+    std::printf("%-22s %16s %14s\n", "model", "particle*steps/s", "bytes/particle");
+    struct Mode { const char* name; DebrisOptions opt; size_t n; };
+    DebrisOptions earth, j2, sunMoon, mutual;
+    earth.j2 = false;
+    sunMoon.sunMoon = true;
+    mutual.mutual = true;
+    // The tree walk costs ~1000x the external field, so it runs on a smaller,
+    // denser cloud (the first minutes after the event)
+    for (const Mode& m : {Mode{"Earth", earth, n}, Mode{"Earth + J2", j2, n}, Mode{"+ Sun/Moon", sunMoon, n},
+                          Mode{"+ mutual (Barnes-Hut)", mutual, n / 5}}) {
+        DebrisCloud cloud;
+        breakup(cloud, m.n, 21);
+        cloud.step(0.0, H, m.opt, &pool);       // warm-up (first accelerations)
+        auto t0 = Clock::now();
+        for (int s = 1; s <= steps; s++) cloud.step(s * H, H, m.opt, &pool);
+        double sec = secSince(t0);
+        std::printf("%-22s %16.3e %14.1f", m.name, m.n * (double)steps / sec, cloud.bytesPerParticle());
+        if (m.opt.mutual) std::printf("   (%zu fragments, %zu nodes, depth %d)", m.n, cloud.tree().nodeCount(), cloud.tree().depth());
+        std::printf("\n");
+    }
+
+    // --- Barnes-Hut vs direct sum ---
+    DebrisCloud dense;
+    breakup(dense, n / 5, 22);
+    DebrisOptions drift;
+    drift.j2 = false;
+    for (int s = 0; s < 30; s++) dense.step(s * H, H, drift, &pool);     // 5 min of spreading
+    BarnesHut tree;
+    auto t0 = Clock::now();
+    tree.build(dense.x.data(), dense.y.data(), dense.z.data(), dense.mass.data(), dense.size());
+    double buildSec = secSince(t0);
+    const size_t SAMPLE = 500;
+    std::mt19937_64 rng(23);
+    std::vector<size_t> pick(SAMPLE);
+    for (auto& p : pick) p = rng() % dense.size();
+    double worst = 0, mean = 0, bhSec = 0, directSec = 0;
+    for (size_t i : pick) {
+        double bx = 0, by = 0, bz = 0;
+        t0 = Clock::now();
+        tree.accumulate(dense.x[i], dense.y[i], dense.z[i], mutual.theta, mutual.softening, bx, by, bz);
+        bhSec += secSince(t0);
+        double dx = 0, dy = 0, dz = 0, eps2 = mutual.softening * mutual.softening;
+        t0 = Clock::now();
+        for (size_t j = 0; j < dense.size(); j++) {
+            double ex = dense.x[j] - dense.x[i], ey = dense.y[j] - dense.y[i], ez = dense.z[j] - dense.z[i];
+            double inv = 1.0 / std::sqrt(ex * ex + ey * ey + ez * ez + eps2), f = G * dense.mass[j] * inv * inv * inv;
+            dx += f * ex; dy += f * ey; dz += f * ez;
+        }
+        directSec += secSince(t0);
+        double err = std::sqrt((bx - dx) * (bx - dx) + (by - dy) * (by - dy) + (bz - dz) * (bz - dz)) /
+                     std::sqrt(dx * dx + dy * dy + dz * dz);
+        worst = std::fmax(worst, err);
+        mean += err / SAMPLE;
+    }
+    std::printf("Barnes-Hut (theta %.1f, %zu fragments): build %.1f ms | per fragment %.2f us vs direct %.2f us (%.0fx) | "
+                "force error mean %.1e, worst %.1e\n",
+                mutual.theta, dense.size(), buildSec * 1e3, bhSec / SAMPLE * 1e6, directSec / SAMPLE * 1e6,
+                directSec / bhSec, mean, worst);
+
+    // --- J2 term against the force model ---
+    double j2Err = 0;
+    ForceModel<TwoBody, J2> reference;
+    DebrisCloud probe;
+    breakup(probe, 64, 24);
+    for (int s = 0; s < 60; s++) probe.step(s * 60.0, 60.0, j2);
+    DebrisCloud single;
+    for (size_t i = 0; i < probe.size(); i++) {
+        Vector3 r = {probe.x[i], probe.y[i], probe.z[i]};
+        single.breakup(r, {0, 0, 0}, 1, 1.0, 0.0, 0);
+    }
+    // a = (v' - v) / h for one step from rest isolates the acceleration
+    single.step(0.0, 1e-3, j2);
+    for (size_t i = 0; i < single.size(); i++) {
+        Vector3 r = {probe.x[i], probe.y[i], probe.z[i]}, want = reference(r, {0, 0, 0}, 0.0);
+        Vector3 got = {single.vx[i] / 1e-3, single.vy[i] / 1e-3, single.vz[i] / 1e-3};
+        j2Err = std::fmax(j2Err, (got - want).magnitude() / want.magnitude());
+    }
+
+    // --- Energy drift: one day of two-body leapfrog ---
+    DebrisCloud day;
+    breakup(day, 1000, 25);
+    double e0 = day.orbitalEnergy();
+    for (int s = 0; s < 8640; s++) day.step(s * H, H, drift, &pool);
+    double energyDrift = std::fabs(day.orbitalEnergy() / e0 - 1);
+    size_t decayed = day.removeDecayed(drift);
+    std::printf("J2 vs Zonal<2>: %.1e relative | energy drift after 1 day (10 s steps): %.1e | decayed %zu of 1000\n",
+                j2Err, energyDrift, decayed);
+    return worst < 0.05 && mean < 5e-3 && j2Err < 1e-6 && energyDrift < 1e-6 ? 0 : 1;
+}
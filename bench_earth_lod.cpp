@@ -0,0 +1,90 @@
+#include "view_transform.hpp"
+#include "earth_lod.hpp"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Earth mesh cost per frame against zoom, as main_3d_sat draws it (radius
+// 200, camera 1000 away, focal 600 * zoom, 1200 x 900 window): the old
+// 5 deg lat/lon grid (every point transformed) against EarthLod (tile
+// culling, level picked for the point budget). For each zoom: points
+// transformed, points actually on screen and in front, level, tiles kept,
+// and CPU time for cull + gather + project. Also checks that EarthLod never
+// drops a point of its level that is in front and on screen.
+//
+// Build: clang++ bench_earth_lod.cpp -o bench_earth_lod -std=c++17 -O3 -march=native -fno-trapping-math
+// Run:   ./bench_earth_lod [views per zoom]      (default 200)
+
+using Clock = std::chrono::steady_clock;
+const double RADIUS = 200.0, CAM_DIST = 1000.0, W = 1200, H = 900;
+
+static bool onScreen(float sx, float sy) { return sx >= 0 && sx <= W && sy >= 0 && sy <= H; }
+
+// Points of `pc` in front of the horizon and on screen
+static size_t shown(const PointCloud& pc, const ProjectedPoints& scr, const ViewTransform& v) {
+    double cx, cy, cz;
+    v.cameraInModel(cx, cy, cz);
+    double d = std::sqrt(cx * cx + cy * cy + cz * cz);
+    size_t n = 0;
+    for (size_t i = 0; i < pc.size(); i++) {
+        bool front = (pc.nx[i] * cx + pc.ny[i] * cy + pc.nz[i] * cz) / d > RADIUS / d;
+        n += front && onScreen(scr.sx[i], scr.sy[i]);
+    }
+    return n;
+}
+
+int main(int argc, char** argv) {
+    int views = argc > 1 ? std::atoi(argv[1]) : 200;
+    PointCloud grid;
+    for (int lat = -90; lat <= 90; lat += 5) {
+        for (int lon = 0; lon < 360; lon += 5) {
+            double la = lat * M_PI / 180.0, lo = lon * M_PI / 180.0;
+            grid.addOnSphere(RADIUS * cos(la) * cos(lo), RADIUS * sin(la), RADIUS * cos(la) * sin(lo));
+        }
+    }
+    auto t0 = Clock::now();
+    EarthLod lod(RADIUS);
+    double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    std::printf("--- Earth LOD (%d views per zoom, budget %zu points, %zu tiles, built in %.0f ms) ---\n", views,
+                EarthLod::DEFAULT_BUDGET, lod.tileCount(), buildMs);
+    std::printf("%6s | %9s %8s %9s | %9s %8s %6s %6s %9s\n", "zoom", "grid pts", "shown", "us/frame",
+                "LOD pts", "shown", "level", "tiles", "us/frame");
+    std::mt19937_64 rng(23);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    ProjectedPoints scr, full;
+    size_t missed = 0;
+    for (double zoom : {0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0}) {
+        double gridUs = 0, lodUs = 0, gridShown = 0, lodShown = 0, lodPts = 0, level = 0, tiles = 0;
+        for (int k = 0; k < views; k++) {
+            ViewTransform view = ViewTransform::orbitCamera(U(rng) * 2 - 1, U(rng) * 2 * M_PI, zoom * 600.0, CAM_DIST, W / 2, H / 2, 500);
+            ViewTransform ev = view.withModel(Mat3::rotateY(U(rng) * 2 * M_PI));
+
+            t0 = Clock::now();
+            ev.project(grid, scr);
+            gridUs += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            gridShown += shown(grid, scr, ev);
+
+            t0 = Clock::now();
+            const PointCloud& pts = lod.update(ev, W, H);
+            ev.project(pts, scr);
+            lodUs += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            size_t s = shown(pts, scr, ev);
+            lodShown += s;
+            lodPts += pts.size();
+            level += lod.level();
+            tiles += lod.visibleTiles();
+
+            // Brute force over the whole chosen level
+            ev.project(lod.levelPoints(lod.level()), full);
+            size_t want = shown(lod.levelPoints(lod.level()), full, ev);
+            missed += want - std::min(want, s);
+        }
+        std::printf("%5.1fx | %9zu %8.0f %9.1f | %9.0f %8.0f %6.1f %6.0f %9.1f\n", zoom, grid.size(), gridShown / views,
+                    gridUs / views, lodPts / views, lodShown / views, level / views, tiles / views, lodUs / views);
+    }
+    std::printf("Points in front and on screen dropped by tile culling: %zu\n", missed);
+    return missed == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "tle_catalog.hpp"
+#include "sgp4.hpp"
+#include "ephemeris_cache.hpp"
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+
+// Chebyshev ephemeris cache against its sources: lookup cost vs direct
+// SGP4 and batch Kepler, position/velocity error over a viewer-like run
+// (positions every `step` seconds for `hours`), hit/miss and memory.
+//
+// Build: clang++ bench_ephemeris.cpp -o bench_ephemeris -std=c++17 -O3 -march=native -fno-trapping-math -pthread
+// Run:   ./bench_ephemeris [objects] [hours] [step_s]     (default 10000 6 10)
+
+int main(int argc, char** argv) {
+    size_t N = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    double hours = argc > 2 ? std::atof(argv[2]) : 6.0;
+    double step = argc > 3 ? std::atof(argv[3]) : 10.0;
+    const double WINDOW = 900.0;
+    const int DEGREE = 10;
+    const double refJD = 2460310.5;
+
+    // Mixed LEO catalog with a tail of eccentric and MEO orbits
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<Sgp4> sgp(N);
+    KeplerBatch batch;
+    for (size_t i = 0; i < N; i++) {
+        TleRecord r = {};
+        r.satnum = (int)i + 1;
+        r.epochYear = 2024; r.epochDay = 1.0;
+        r.inclination = U(rng) * M_PI;
+        r.raan = U(rng) * 2 * M_PI;
+        r.argPerigee = U(rng) * 2 * M_PI;
+        r.meanAnomaly = U(rng) * 2 * M_PI;
+        bool eccentric = i % 10 == 0;
+        r.ecc = eccentric ? 0.05 + U(rng) * 0.2 : U(rng) * 0.01;
+        r.revsPerDay = eccentric ? 4.0 + U(rng) * 8.0 : 13.5 + U(rng) * 2.0;
+        r.bstar = 1e-5 * U(rng);
+        sgp[i].init(r);
+        batch.add(r.inclination, r.raan, r.ecc, r.argPerigee, r.meanAnomaly, r.meanMotion());
+    }
+    auto sgpAt = [&](size_t i, double t) {
+        Vector3 p;
+        if (sgp[i].positionAt(refJD, t, p) != Sgp4::OK) p.x = p.y = p.z = std::numeric_limits<double>::quiet_NaN();
+        return p;
+    };
+
+    size_t steps = (size_t)(hours * 3600.0 / step);
+    std::vector<double> x(N), y(N), z(N);
+    double sink = 0;
+
+    // --- Direct sources ---
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t s = 0; s < steps; s++) {
+        double t = s * step;
+        for (size_t i = 0; i < N; i++) sink += sgpAt(i, t).x;
+    }
+    double sgpSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t s = 0; s < steps; s++) {
+        batch.propagate(s * step, x.data(), y.data(), z.data());
+        sink += x[s % N];
+    }
+    double keplerSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // --- Cache, lazy builds only (fits counted in the time) ---
+    EphemerisCache cache;
+    cache.reset(N, sgpAt, WINDOW, DEGREE);
+    t0 = std::chrono::steady_clock::now();
+    for (size_t s = 0; s < steps; s++) {
+        cache.positions(0, N, s * step, x.data(), y.data(), z.data());
+        sink += x[s % N];
+    }
+    double lazySec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    uint64_t lazyHits = cache.hits(), lazyMisses = cache.misses();
+
+    // --- Hit path alone: every window prebuilt, then timed lookups ---
+    double hitSec = 0;
+    uint64_t hitLookups = 0;
+    for (size_t s = 0; s < steps; s++) {
+        double t = s * step;
+        if (s == 0 || cache.windowOf(t) != cache.windowOf(t - step)) {
+            for (size_t i = 0; i < N; i++) cache.position(i, t);       // build outside the timer
+        }
+        auto h0 = std::chrono::steady_clock::now();
+        cache.positions(0, N, t, x.data(), y.data(), z.data());
+        hitSec += std::chrono::duration<double>(std::chrono::steady_clock::now() - h0).count();
+        hitLookups += N;
+        sink += x[s % N];
+    }
+
+    // --- Accuracy: position and velocity at off-node times ---
+    double maxPos = 0, maxVel = 0, sumPos = 0;
+    size_t samples = 0;
+    std::uniform_real_distribution<double> T(0.0, hours * 3600.0);
+    for (size_t k = 0; k < 20000; k++) {
+        size_t i = k % N;
+        double t = T(rng);
+        Vector3 v, exact = sgpAt(i, t);
+        Vector3 p = cache.position(i, t, &v);
+        // Sub-surface perigees decay under SGP4: no position, or a window without a fit
+        if (exact.x != exact.x || p.x != p.x) continue;
+        const double H = 0.05;
+        Vector3 vExact = (sgpAt(i, t + H) - sgpAt(i, t - H)) * (1.0 / (2 * H));
+        double e = (p - exact).magnitude();
+        maxPos = std::fmax(maxPos, e);
+        sumPos += e;
+        maxVel = std::fmax(maxVel, (v - vExact).magnitude());
+        samples++;
+    }
+
+    double lookups = (double)N * steps;
+    std::printf("--- Ephemeris Cache (%zu objects, %.1f h at %.0f s, window %.0f s, degree %d) ---\n",
+                N, hours, step, WINDOW, DEGREE);
+    std::printf("SGP4 direct   : %7.1f ns/query\n", sgpSec / lookups * 1e9);
+    std::printf("Kepler batch  : %7.1f ns/query\n", keplerSec / lookups * 1e9);
+    std::printf("Cache (lazy)  : %7.1f ns/query incl. fits | %llu hits, %llu misses (%.2f%% hit)\n",
+                lazySec / lookups * 1e9, (unsigned long long)lazyHits, (unsigned long long)lazyMisses,
+                100.0 * lazyHits / (lazyHits + lazyMisses));
+    std::printf("Cache (hit)   : %7.1f ns/query | %.1fx vs SGP4, %.1fx vs Kepler\n",
+                hitSec / hitLookups * 1e9, sgpSec / lookups / (hitSec / hitLookups), keplerSec / lookups / (hitSec / hitLookups));
+    std::printf("Error vs SGP4 : max %.4f m, mean %.2e m | velocity max %.5f m/s | estimate %.4f m\n",
+                maxPos, sumPos / samples, maxVel, cache.maxErrorEstimate());
+    std::printf("Memory        : %.1f MB (%.0f B/object) | %llu windows fitted\n",
+                cache.bytes() / 1e6, (double)cache.bytes() / N, (unsigned long long)cache.windowsBuilt());
+    if (sink == 12345.678) std::printf("%f\n", sink);
+    return maxPos < 1.0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "integrators.hpp"
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Integrator cost/accuracy benchmark: position error after N orbits against
+// the analytic Kepler solution, with force evaluations and wall time, for a
+// near-circular LEO and an eccentric Molniya orbit.
+//
+// Build: clang++ bench_integrators.cpp -o bench_integrators -std=c++17 -O3 -march=native
+// Run:   ./bench_integrators [orbits]      (default 10)
+
+struct Orbit {
+    const char* name;
+    double a, e, inc;
+    double n() const { return std::sqrt(MU_EARTH / (a * a * a)); }
+    double period() const { return 2 * M_PI / n(); }
+
+    // Exact two-body state at time t (perigee at t = 0, node on +X)
+    OrbitState at(double t) const {
+        double M = std::fmod(n() * t, 2 * M_PI);
+        double E = e < 0.8 ? M : M_PI;
+        for (int k = 0; k < 50; k++) {
+            double dE = (E - e * std::sin(E) - M) / (1 - e * std::cos(E));
+            E -= dE;
+            if (std::fabs(dE) < 1e-15) break;
+        }
+        double b = a * std::sqrt(1 - e * e);
+        double x = a * (std::cos(E) - e), y = b * std::sin(E);
+        double Edot = n() / (1 - e * std::cos(E));
+        double vx = -a * std::sin(E) * Edot, vy = b * std::cos(E) * Edot;
+        double ci = std::cos(inc), si = std::sin(inc);
+        return {{x, y * ci, y * si}, {vx, vy * ci, vy * si}};
+    }
+};
+
+struct Result {
+    const char* method;
+    double setting;         // steps per orbit, or tolerance for DP54
+    double error;           // m
+    uint64_t evals;
+    double ms;
+};
+
+Result run(Integrator integrator, const Orbit& orbit, int orbits, double setting) {
+    OrbitState s = orbit.at(0.0);
+    double tEnd = orbits * orbit.period();
+    auto t0 = std::chrono::steady_clock::now();
+    integrator.advance(s, 0.0, tEnd, TwoBodyForce());
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    double err = (s.pos - orbit.at(tEnd).pos).magnitude();
+    return {integrator.name(), setting, err, integrator.forceEvaluations(), ms};
+}
+
+int main(int argc, char** argv) {
+    int orbits = (argc > 1) ? std::atoi(argv[1]) : 10;
+    const Orbit ORBITS[] = {
+        {"LEO 400 km, e = 0.001", R_EARTH + 400e3, 0.001, 51.6 * M_PI / 180},
+        {"Molniya, e = 0.74", 26600e3, 0.74, 63.4 * M_PI / 180},
+    };
+    const IntegratorKind FIXED[] = {IntegratorKind::SemiImplicitEuler, IntegratorKind::Verlet, IntegratorKind::ForestRuth,
+                                    IntegratorKind::Yoshida6, IntegratorKind::RK4};
+    const double STEPS_PER_ORBIT[] = {100, 300, 1000, 3000, 10000, 30000};
+    const double TOLERANCES[] = {1e-6, 1e-8, 1e-10, 1e-12};
+    const double TARGETS[] = {1000.0, 10.0, 0.1};
+
+    for (const Orbit& orbit : ORBITS) {
+        std::printf("--- %s, %d orbits (period %.0f s) ---\n", orbit.name, orbits, orbit.period());
+        std::printf("%-22s %12s %14s %12s %10s\n", "method", "steps/orbit", "pos error [m]", "force evals", "wall [ms]");
+        std::vector<Result> results;
+        for (IntegratorKind k : FIXED) {
+            for (double spo : STEPS_PER_ORBIT) {
+                results.push_back(run(Integrator(k, orbit.period() / spo), orbit, orbits, spo));
+                const Result& r = results.back();
+                std::printf("%-22s %12.0f %14.3e %12llu %10.2f\n", r.method, spo, r.error, (unsigned long long)r.evals, r.ms);
+            }
+        }
+        for (double tol : TOLERANCES) {
+            results.push_back(run(Integrator(IntegratorKind::DormandPrince54, orbit.period() / 100, tol), orbit, orbits, tol));
+            const Result& r = results.back();
+            std::printf("%-22s %12s %14.3e %12llu %10.2f   (tol %.0e)\n", r.method, "adaptive", r.error,
+                        (unsigned long long)r.evals, r.ms, tol);
+        }
+
+        // Cheapest configuration (fewest force evaluations) per accuracy target
+        for (double target : TARGETS) {
+            const Result* best = nullptr;
+            for (const Result& r : results) {
+                if (r.error <= target && (!best || r.evals < best->evals)) best = &r;
+            }
+            if (best) {
+                std::printf("Cheapest under %g m: %s (%s %g) -> %.3g m, %llu evals, %.2f ms\n", target, best->method,
+                            best->setting < 1 ? "tol" : "steps/orbit", best->setting, best->error,
+                            (unsigned long long)best->evals, best->ms);
+            } else {
+                std::printf("Cheapest under %g m: none of the tested settings\n", target);
+            }
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "kepler_batch.hpp"
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Throughput benchmark: scalar getSatellitePosition() vs KeplerBatch.
+//
+// Build: clang++ bench_propagation.cpp -o bench_propagation -std=c++17 -O3 -march=native -fno-trapping-math
+// Run:   ./bench_propagation [objects]   (default 30000 ~ public catalog)
+
+// --- BASELINE: copy of the viewer's scalar path (main_3d_sat.cpp) ---
+// Kept verbatim (by-value struct, name + 150-point trail) so the numbers
+// reflect what the viewer actually pays per call.
+struct ScalarElements {
+    std::string name;
+    double inclination; double raan; double ecc; double argPerigee; double meanAnomaly; double meanMotion;
+    std::vector<Vector3> trail;
+};
+
+Vector3 scalarSatellitePosition(ScalarElements oe, double t) {
+    double M = fmod(oe.meanAnomaly + oe.meanMotion * t, 2 * M_PI);
+    double E = M;
+    for (int i = 0; i < 5; i++) E = E - (E - oe.ecc * sin(E) - M) / (1 - oe.ecc * cos(E));
+
+    double a = pow(G * M_EARTH / (oe.meanMotion * oe.meanMotion), 1.0/3.0);
+    double P = a * (cos(E) - oe.ecc);
+    double Q = a * sqrt(1 - oe.ecc * oe.ecc) * sin(E);
+
+    double cO = cos(oe.raan), sO = sin(oe.raan), ci = cos(oe.inclination), si = sin(oe.inclination), cw = cos(oe.argPerigee), sw = sin(oe.argPerigee);
+    double x = P * (cO*cw - sO*ci*sw) - Q * (cO*sw + sO*ci*cw);
+    double y = P * (sO*cw + cO*ci*sw) - Q * (sO*sw - cO*ci*cw);
+    double z = P * (si*sw)           + Q * (si*cw);
+    return {x, y, z};
+}
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t N = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 30000;
+    const int STEPS = 20;
+
+    // --- RANDOM CATALOG (fixed seed: LEO..GEO, low..moderate eccentricity) ---
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<ScalarElements> sats(N);
+    KeplerBatch batch;
+    batch.reserve(N);
+    for (size_t i = 0; i < N; i++) {
+        ScalarElements& s = sats[i];
+        s.name = "OBJ-" + std::to_string(i);
+        s.inclination = U(rng) * M_PI;
+        s.raan = U(rng) * 2 * M_PI;
+        s.ecc = U(rng) * 0.2;
+        s.argPerigee = U(rng) * 2 * M_PI;
+        s.meanAnomaly = U(rng) * 2 * M_PI;
+        s.meanMotion = (1.0 + U(rng) * 15.0) * (2 * M_PI / 86400);
+        s.trail.assign(150, {0, 0, 0});
+        batch.add(s.inclination, s.raan, s.ecc, s.argPerigee, s.meanAnomaly, s.meanMotion);
+    }
+
+    std::vector<double> x(N), y(N), z(N);
+    double sink = 0;
+
+    // --- SCALAR ---
+    auto t0 = std::chrono::steady_clock::now();
+    for (int step = 0; step < STEPS; step++) {
+        double t = step * 60.0;
+        for (size_t i = 0; i < N; i++) {
+            Vector3 p = scalarSatellitePosition(sats[i], t);
+            sink += p.x;
+        }
+    }
+    double scalarTime = secondsSince(t0);
+
+    // --- BATCH ---
+    t0 = std::chrono::steady_clock::now();
+    for (int step = 0; step < STEPS; step++) {
+        batch.propagate(step * 60.0, x.data(), y.data(), z.data());
+        sink += x[step % N];
+    }
+    double batchTime = secondsSince(t0);
+
+    // --- ACCURACY (batch vs scalar at the last step) ---
+    double maxErr = 0;
+    double tLast = (STEPS - 1) * 60.0;
+    for (size_t i = 0; i < N; i++) {
+        Vector3 p = scalarSatellitePosition(sats[i], tLast);
+        Vector3 d = {p.x - x[i], p.y - y[i], p.z - z[i]};
+        if (d.magnitude() > maxErr) maxErr = d.magnitude();
+    }
+
+    double total = (double)N * STEPS;
+    std::printf("--- Kepler Propagation Benchmark (%zu objects x %d steps) ---\n", N, STEPS);
+    std::printf("Scalar : %12.0f objects/s\n", total / scalarTime);
+    std::printf("Batch  : %12.0f objects/s\n", total / batchTime);
+    std::printf("Speedup: %.1fx | max |batch - scalar| = %.3e m\n", scalarTime / batchTime, maxErr);
+    std::printf("(checksum %g)\n", sink);
+    return 0;
+}
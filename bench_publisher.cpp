@@ -0,0 +1,164 @@
+#include "state_publisher.hpp"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <sched.h>
+#include <sys/wait.h>
+
+// Shared-memory state publisher: a forked reader process maps the ring
+// read-only while the parent publishes frames of `objects` states.
+//
+//   flat out   the writer publishes `frames` frames back to back; writer
+//              cost per frame, frames the reader copied out, frames it
+//              missed (lapped) and torn copies it accepted (must be 0)
+//   paced      1000 frames/s for a second; commit-to-reader latency (until
+//              the reader notices the frame; the copy is reported apart)
+//   in place   view() + stillValid() against read() for one frame
+//
+// Every element encodes its frame number, so the reader checks each copy
+// it accepts for mixing. With a single core the reader only runs when the
+// writer yields, so latency is mostly scheduler wake-up.
+//
+// Build: clang++ bench_publisher.cpp -o bench_publisher -std=c++17 -O3 -march=native -fno-trapping-math
+// Run:   ./bench_publisher [objects] [frames]      (default 30000 2000)
+
+using Clock = std::chrono::steady_clock;
+
+struct ReaderResult {
+    uint64_t read, missed, torn, lastFrame;
+    double p50Us, p99Us, maxUs;
+    double copyUs, viewUs;
+};
+
+static double value(uint64_t frame, size_t i, int column) { return frame * 1e6 + i * 8.0 + column; }
+
+static bool consistent(const StateFrame& f) {
+    for (size_t i = 0; i < f.size(); i++) {
+        if (f.x[i] != value(f.frame, i, 0) || f.vz[i] != value(f.frame, i, 5) || f.flags[i] != (uint8_t)f.frame) return false;
+    }
+    return true;
+}
+
+static void publishFrame(StatePublisher& pub, uint64_t frame, size_t n) {
+    StatePublisher::Slot s = pub.begin(frame * 0.1, n);
+    double* cols[6] = {s.x, s.y, s.z, s.vx, s.vy, s.vz};
+    for (int c = 0; c < 6; c++) for (size_t i = 0; i < n; i++) cols[c][i] = value(frame, i, c);
+    std::memset(s.flags, (uint8_t)frame, n);
+    pub.commit();
+}
+
+// Child: follow the ring until frame `last`, then report through `fd`
+static int runReader(const char* name, uint64_t last, int fd) {
+    StateSubscriber sub;
+    while (!sub.open(name)) sched_yield();
+    ReaderResult res = {};
+    std::vector<double> latency;
+    StateFrame frame;
+    uint64_t seen = 0;
+    while (seen < last) {
+        uint64_t f = sub.latest();
+        if (f == seen) { sched_yield(); continue; }
+        StateView v;
+        if (sub.view(f, v)) latency.push_back((stateClockNs() - v.publishNs) * 1e-3);
+        if (!sub.read(f, frame)) continue;
+        res.read++;
+        res.missed += f - seen - 1;
+        res.torn += !consistent(frame);
+        seen = f;
+    }
+    res.lastFrame = seen;
+    std::sort(latency.begin(), latency.end());
+    if (!latency.empty()) {
+        res.p50Us = latency[latency.size() / 2];
+        res.p99Us = latency[latency.size() * 99 / 100];
+        res.maxUs = latency.back();
+    }
+    // Copy-out vs in place on the final frame
+    const int REPS = 50;
+    auto t0 = Clock::now();
+    for (int r = 0; r < REPS; r++) sub.read(last, frame);
+    res.copyUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / REPS;
+    double sum = 0;
+    t0 = Clock::now();
+    for (int r = 0; r < REPS; r++) {
+        StateView v;
+        if (!sub.view(last, v)) continue;
+        for (size_t i = 0; i < v.count; i++) sum += v.columns.x[i];
+        if (!sub.stillValid(v)) sum = 0;
+    }
+    res.viewUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / REPS;
+    if (sum == 0) res.torn++;
+    return write(fd, &res, sizeof(res)) == (ssize_t)sizeof(res) ? 0 : 1;
+}
+
+static bool collect(pid_t pid, int fd, ReaderResult& res) {
+    bool ok = read(fd, &res, sizeof(res)) == (ssize_t)sizeof(res);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    close(fd);
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static pid_t forkReader(const char* name, uint64_t last, int& fd) {
+    int p[2];
+    if (pipe(p) != 0) return -1;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(p[0]);
+        _exit(runReader(name, last, p[1]));
+    }
+    close(p[1]);
+    fd = p[0];
+    return pid;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 30000;
+    uint64_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    const char* NAME = "/orbit_bench_publisher";
+    bool pass = true;
+
+    std::printf("--- State Publisher (%zu objects, %.2f MB/frame, %u slots, %u cores) ---\n", n,
+                stateSlotBytes(n) / 1e6, StatePublisher::DEFAULT_SLOTS, std::thread::hardware_concurrency());
+
+    // --- Flat out ---
+    StatePublisher pub;
+    if (!pub.open(NAME, n)) { std::fprintf(stderr, "shm_open %s failed\n", NAME); return 1; }
+    int fd;
+    pid_t pid = forkReader(NAME, frames, fd);
+    // Let the reader map the object first, or it only sees the last frames
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto t0 = Clock::now();
+    for (uint64_t f = 1; f <= frames; f++) publishFrame(pub, f, n);
+    double writeUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / frames;
+    ReaderResult flat;
+    pass = collect(pid, fd, flat) && pass;
+    std::printf("Flat out : writer %.1f us/frame (%.0f frames/s, %.2f GB/s) | reader copied %llu, missed %llu, torn %llu\n",
+                writeUs, 1e6 / writeUs, stateSlotBytes(n) / (writeUs * 1e3), (unsigned long long)flat.read,
+                (unsigned long long)flat.missed, (unsigned long long)flat.torn);
+
+    // --- Paced ---
+    pub.open(NAME, n);
+    const uint64_t PACED = 1000;
+    pid = forkReader(NAME, PACED, fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto next = Clock::now();
+    for (uint64_t f = 1; f <= PACED; f++) {
+        std::this_thread::sleep_until(next);
+        next += std::chrono::microseconds(1000);
+        publishFrame(pub, f, n);
+    }
+    ReaderResult paced;
+    pass = collect(pid, fd, paced) && pass;
+    std::printf("Paced    : 1000 frames/s -> commit to reader p50 %.1f us, p99 %.1f us, max %.1f us | read %llu, missed %llu, torn %llu\n",
+                paced.p50Us, paced.p99Us, paced.maxUs, (unsigned long long)paced.read,
+                (unsigned long long)paced.missed, (unsigned long long)paced.torn);
+    std::printf("Reader   : read() copy %.1f us/frame | view() in place (sum of x) %.1f us/frame\n", paced.copyUs, paced.viewUs);
+    pub.close();
+
+    pass = pass && flat.torn == 0 && paced.torn == 0 && flat.lastFrame == frames && paced.lastFrame == PACED;
+    return pass ? 0 : 1;
+}
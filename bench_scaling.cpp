@@ -0,0 +1,103 @@
+#include "kepler_batch.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+// Thread-scaling benchmark for WorkStealingPool on a mixed catalog.
+//
+// Build: clang++ bench_scaling.cpp -o bench_scaling -std=c++17 -O3 -march=native -fno-trapping-math -pthread
+// Run:   ./bench_scaling [objects] [maxThreads]   (default 100000 64)
+//
+// The catalog is deliberately lopsided: the last 20% of objects are
+// "integrated" (semi-implicit Euler like Satellite::update, 60 x 1 s steps
+// per output step) and cost several times more than the analytic Kepler
+// objects in front of them. A static split would leave the first threads
+// idle; stealing keeps them busy.
+
+const double STEP = 60.0;       // output cadence [s]
+const int SUBSTEPS = 60;        // Euler steps per output step (dt = 1 s)
+
+struct IntegratedSet {
+    std::vector<double> px, py, pz, vx, vy, vz;
+
+    void advance(size_t i) {
+        double x = px[i], y = py[i], z = pz[i], u = vx[i], v = vy[i], w = vz[i];
+        for (int k = 0; k < SUBSTEPS; k++) {
+            double r = std::sqrt(x*x + y*y + z*z);
+            double am = -MU_EARTH / (r*r*r);
+            u += am * x; v += am * y; w += am * z;
+            x += u; y += v; z += w;
+        }
+        px[i] = x; py[i] = y; pz[i] = z; vx[i] = u; vy[i] = v; vz[i] = w;
+    }
+};
+
+int main(int argc, char** argv) {
+    size_t N = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    unsigned maxThreads = (argc > 2) ? (unsigned)std::strtoul(argv[2], nullptr, 10) : 64;
+    const int STEPS = 10;
+    const size_t GRAIN = 256;
+
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+
+    size_t nAnalytic = N - N / 5;
+    KeplerBatch batch;
+    batch.reserve(nAnalytic);
+    for (size_t i = 0; i < nAnalytic; i++) {
+        batch.add(U(rng) * M_PI, U(rng) * 2 * M_PI, U(rng) * 0.7, U(rng) * 2 * M_PI, U(rng) * 2 * M_PI,
+                  (1.0 + U(rng) * 15.0) * (2 * M_PI / 86400));
+    }
+
+    IntegratedSet initial;
+    for (size_t i = nAnalytic; i < N; i++) {
+        double r = R_EARTH + 300e3 + U(rng) * 1500e3, ang = U(rng) * 2 * M_PI, inc = U(rng) * M_PI;
+        double v = std::sqrt(MU_EARTH / r);
+        initial.px.push_back(r * std::cos(ang)); initial.py.push_back(r * std::sin(ang)); initial.pz.push_back(0);
+        initial.vx.push_back(-v * std::sin(ang) * std::cos(inc));
+        initial.vy.push_back(v * std::cos(ang) * std::cos(inc));
+        initial.vz.push_back(v * std::sin(inc));
+    }
+
+    // Shared output buffer, indexed by object id
+    std::vector<double> X(N), Y(N), Z(N), refX;
+
+    auto runOnce = [&](WorkStealingPool& pool, IntegratedSet& integ, double t) {
+        pool.parallelFor(N, GRAIN, [&](size_t begin, size_t end) {
+            if (begin < nAnalytic) batch.propagate(t, begin, std::min(end, nAnalytic), X.data(), Y.data(), Z.data());
+            for (size_t i = std::max(begin, nAnalytic); i < end; i++) {
+                size_t k = i - nAnalytic;
+                integ.advance(k);
+                X[i] = integ.px[k]; Y[i] = integ.py[k]; Z[i] = integ.pz[k];
+            }
+        });
+    };
+
+    std::printf("--- Work-Stealing Scaling (%zu objects, %zu integrated, grain %zu, %u hw threads) ---\n",
+                N, N - nAnalytic, GRAIN, std::thread::hardware_concurrency());
+    std::printf("%8s %12s %14s %9s %11s %10s\n", "threads", "ms/step", "objects/s", "speedup", "efficiency", "stolen");
+
+    double base = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        WorkStealingPool pool(threads);
+        IntegratedSet integ = initial;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int step = 1; step <= STEPS; step++) runOnce(pool, integ, step * STEP);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        // Results must not depend on the thread count
+        if (threads == 1) refX = X;
+        else if (X != refX) { std::fprintf(stderr, "MISMATCH at %u threads\n", threads); return 1; }
+
+        double perStep = sec / STEPS;
+        if (threads == 1) base = perStep;
+        std::printf("%8u %12.3f %14.0f %8.2fx %10.0f%% %10llu\n", threads, perStep * 1e3, N / perStep,
+                    base / perStep, 100.0 * base / perStep / threads, (unsigned long long)pool.stealCount());
+    }
+    return 0;
+}
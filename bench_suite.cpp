@@ -0,0 +1,297 @@
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "tle_catalog.hpp"
+#include "sgp4.hpp"
+#include "integrators.hpp"
+#include "pass_predictor.hpp"
+#include "visibility_matrix.hpp"
+#include "view_transform.hpp"
+#include "trail_arena.hpp"
+#include "ephemeris_cache.hpp"
+#include "tracker_satellite.hpp"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Regression benchmark suite for the hot paths, no window needed: every
+// case runs at catalog sizes 10 .. 1M on a catalog built from a fixed
+// seed, and the results go out as JSON (ns/op, ops/s, heap allocations
+// per op, checksum of the first pass) so two runs can be diffed.
+//
+// Build: clang++ bench_suite.cpp -o bench_suite -std=c++17 -O3 -march=native -fno-trapping-math -pthread
+// Run:   ./bench_suite [--max N] [--min-time s] [--filter name] [--seed n] [--out results.json]
+//
+// An "op" is one object (or mesh point) handled once. Each case runs one
+// untimed warm-up pass, then timed passes until --min-time has elapsed
+// (at least 3); ns/op is the median pass, best is the fastest. Tiny
+// catalogs are timed a few hundred passes at a time.
+//
+//   propagate.kepler_scalar   KeplerBatch::position(i, t), the old getSatellitePosition per object
+//   propagate.kepler_batch    KeplerBatch::propagate, whole catalog per call
+//   propagate.sgp4            Sgp4::positionAt per object
+//   propagate.ephemeris_hit   EphemerisCache::positions inside a fitted window
+//   integrate.satellite       Satellite::update(60 s) from the tracker (Forest-Ruth, 10 s steps)
+//   visibility.station        getStationPos + elevation test against one station
+//   visibility.matrix         VisibilityMatrix::compute, 100 stations
+//   render.mesh_transform     ViewTransform::project + lighting over a point cloud
+//   render.trail_push         TrailArena::push, one sample per object
+
+// --- Heap accounting: every operator new in the process is counted (the
+// profiler's replacement allocator) ---
+#define FRAME_PROFILER_COUNT_ALLOCATIONS
+#include "frame_profiler.hpp"
+
+// --- Catalog: mixed LEO with a tail of eccentric / MEO orbits ---
+std::vector<TleRecord> makeCatalog(size_t n, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<TleRecord> recs(n);
+    for (size_t i = 0; i < n; i++) {
+        TleRecord& r = recs[i];
+        r.satnum = (int)(i % 99999) + 1;
+        r.epochYear = 2024; r.epochDay = 1.0;
+        r.inclination = U(rng) * M_PI;
+        r.raan = U(rng) * 2 * M_PI;
+        r.argPerigee = U(rng) * 2 * M_PI;
+        r.meanAnomaly = U(rng) * 2 * M_PI;
+        bool eccentric = i % 10 == 0;
+        r.ecc = eccentric ? 0.05 + U(rng) * 0.2 : U(rng) * 0.01;
+        r.revsPerDay = eccentric ? 4.0 + U(rng) * 8.0 : 13.5 + U(rng) * 2.0;
+        r.bstar = 1e-5 * U(rng);
+    }
+    return recs;
+}
+
+struct Options {
+    size_t maxObjects = 1000000;
+    double minTime = 0.1;
+    uint64_t seed = 42;
+    std::string filter;
+    const char* out = nullptr;
+};
+
+struct Result {
+    std::string name;
+    size_t objects = 0;
+    uint64_t opsPerPass = 0;
+    int passes = 0;
+    double nsPerOp = 0, bestNsPerOp = 0;
+    double allocsPerOp = 0, bytesPerOp = 0;
+    double checksum = 0;
+};
+
+// pass(k) runs pass k and returns a checksum of its output
+Result measure(const std::string& name, size_t objects, uint64_t opsPerPass, double minTime,
+               const std::function<double(int)>& pass) {
+    using Clock = std::chrono::steady_clock;
+    Result r;
+    r.name = name;
+    r.objects = objects;
+    r.opsPerPass = opsPerPass;
+    auto w0 = Clock::now();
+    r.checksum = pass(0);
+    // Small catalogs: several passes per timed sample so the clock is noise
+    double warm = std::chrono::duration<double>(Clock::now() - w0).count();
+    int reps = warm >= 20e-6 ? 1 : (int)std::min(10000.0, 20e-6 / std::max(warm, 1e-8)) + 1;
+
+    std::vector<double> times;
+    times.reserve(4096);
+    uint64_t allocs = 0, bytes = 0;
+    auto start = Clock::now();
+    for (int k = 1; times.size() < 3 || std::chrono::duration<double>(Clock::now() - start).count() < minTime; ) {
+        uint64_t a0 = profilerAllocations.load(), b0 = profilerAllocatedBytes.load();
+        auto t0 = Clock::now();
+        volatile double sink = 0;
+        for (int j = 0; j < reps; j++, k++) sink = pass(k);
+        (void)sink;
+        double dt = std::chrono::duration<double>(Clock::now() - t0).count();
+        allocs += profilerAllocations.load() - a0;
+        bytes += profilerAllocatedBytes.load() - b0;
+        if (times.size() == times.capacity()) break;
+        times.push_back(dt / reps);
+    }
+    r.passes = (int)times.size() * reps;
+    r.allocsPerOp = (double)allocs / (opsPerPass * r.passes);
+    r.bytesPerOp = (double)bytes / (opsPerPass * r.passes);
+    std::sort(times.begin(), times.end());
+    r.nsPerOp = times[times.size() / 2] / opsPerPass * 1e9;
+    r.bestNsPerOp = times[0] / opsPerPass * 1e9;
+    return r;
+}
+
+void writeJson(FILE* f, const Options& opt, const std::vector<Result>& results) {
+    std::fprintf(f, "{\n  \"suite\": \"orbitview\",\n  \"schema\": 1,\n  \"seed\": %llu,\n  \"min_time_s\": %g,\n",
+                 (unsigned long long)opt.seed, opt.minTime);
+#ifdef __VERSION__
+    std::fprintf(f, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+    std::fprintf(f, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::fprintf(f, "    {\"name\": \"%s\", \"objects\": %zu, \"ops_per_pass\": %llu, \"passes\": %d, "
+                        "\"ns_per_op\": %.3f, \"best_ns_per_op\": %.3f, \"ops_per_sec\": %.1f, "
+                        "\"allocs_per_op\": %.6f, \"bytes_per_op\": %.3f, \"checksum\": %.17g}%s\n",
+                     r.name.c_str(), r.objects, (unsigned long long)r.opsPerPass, r.passes, r.nsPerOp, r.bestNsPerOp,
+                     1e9 / r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.checksum, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        bool more = i + 1 < argc;
+        if (a == "--max" && more) opt.maxObjects = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--min-time" && more) opt.minTime = std::atof(argv[++i]);
+        else if (a == "--seed" && more) opt.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (a == "--filter" && more) opt.filter = argv[++i];
+        else if (a == "--out" && more) opt.out = argv[++i];
+        else {
+            std::fprintf(stderr, "Usage: %s [--max N] [--min-time s] [--filter name] [--seed n] [--out file]\n", argv[0]);
+            return 2;
+        }
+    }
+    auto enabled = [&](const char* name) { return opt.filter.empty() || std::strstr(name, opt.filter.c_str()); };
+
+    const double refJD = 2460310.5;
+    const double STEP = 60.0;       // sim seconds between passes
+    std::vector<Result> results;
+    std::fprintf(stderr, "--- Benchmark Suite (seed %llu, min %.2f s per case) ---\n", (unsigned long long)opt.seed, opt.minTime);
+    auto report = [&](Result r) {
+        std::fprintf(stderr, "%-26s %8zu : %10.1f ns/op | %12.0f ops/s | %.3f allocs/op\n",
+                     r.name.c_str(), r.objects, r.nsPerOp, 1e9 / r.nsPerOp, r.allocsPerOp);
+        results.push_back(std::move(r));
+    };
+
+    for (size_t N = 10; N <= opt.maxObjects; N *= 10) {
+        std::vector<TleRecord> catalog = makeCatalog(N, opt.seed);
+        std::vector<double> x(N), y(N), z(N);
+
+        KeplerBatch batch;
+        batch.reserve(N);
+        for (const auto& r : catalog) batch.add(r.inclination, r.raan, r.ecc, r.argPerigee, r.meanAnomaly, r.meanMotion());
+
+        if (enabled("propagate.kepler_scalar")) {
+            report(measure("propagate.kepler_scalar", N, N, opt.minTime, [&](int k) {
+                double sum = 0;
+                for (size_t i = 0; i < N; i++) sum += batch.position(i, k * STEP).x;
+                return sum;
+            }));
+        }
+        if (enabled("propagate.kepler_batch")) {
+            report(measure("propagate.kepler_batch", N, N, opt.minTime, [&](int k) {
+                batch.propagate(k * STEP, x.data(), y.data(), z.data());
+                return x[0] + y[N / 2] + z[N - 1];
+            }));
+        }
+        if (enabled("propagate.sgp4")) {
+            std::vector<Sgp4> sgp(N);
+            for (size_t i = 0; i < N; i++) sgp[i].init(catalog[i]);
+            report(measure("propagate.sgp4", N, N, opt.minTime, [&](int k) {
+                double sum = 0;
+                for (size_t i = 0; i < N; i++) {
+                    Vector3 p;
+                    if (sgp[i].positionAt(refJD, k * STEP, p) == Sgp4::OK) sum += p.x;
+                }
+                return sum;
+            }));
+        }
+        if (enabled("propagate.ephemeris_hit")) {
+            EphemerisCache cache;
+            cache.reset(N, [&](size_t i, double t) { return batch.position(i, t); });
+            cache.positions(0, N, 0.0, x.data(), y.data(), z.data());       // fit window 0
+            report(measure("propagate.ephemeris_hit", N, N, opt.minTime, [&](int k) {
+                double t = std::fmod(k * 7.0, cache.window());
+                cache.positions(0, N, t, x.data(), y.data(), z.data());
+                return x[0] + y[N / 2] + z[N - 1];
+            }));
+        }
+        if (enabled("integrate.satellite")) {
+            std::vector<Satellite> sats;
+            sats.reserve(N);
+            for (size_t i = 0; i < N; i++) {
+                Vector3 p = batch.position(i, 0.0), p1 = batch.position(i, 1.0);
+                sats.emplace_back(p, p1 - p);
+            }
+            report(measure("integrate.satellite", N, N, opt.minTime, [&](int) {
+                double sum = 0;
+                for (auto& s : sats) { s.update(STEP); sum += s.pos.x; }
+                return sum;
+            }));
+        }
+        if (enabled("visibility.station")) {
+            GroundStation home = {23.83, 91.28, 0.0, 10.0};
+            PassPredictor predictor(home);
+            batch.propagate(0.0, x.data(), y.data(), z.data());
+            report(measure("visibility.station", N, N, opt.minTime, [&](int k) {
+                double t = k * STEP, sum = 0;
+                for (size_t i = 0; i < N; i++) {
+                    Vector3 sat = {x[i], y[i], z[i]};
+                    Vector3 city = getStationPos(home.lat, home.lon, t);
+                    double dist = (sat - city).magnitude();
+                    bool visible = predictor.elevation(sat, t) * 180.0 / M_PI >= home.minElevation;
+                    sum += visible ? dist : 0.0;
+                }
+                return sum;
+            }));
+        }
+        if (enabled("visibility.matrix")) {
+            std::mt19937_64 rng(opt.seed + 1);
+            std::uniform_real_distribution<double> U(0.0, 1.0);
+            std::vector<GroundStation> stations(100);
+            for (auto& st : stations) st = {std::asin(2 * U(rng) - 1) * 180.0 / M_PI, U(rng) * 360.0 - 180.0, 0.0, 10.0};
+            VisibilityMatrix vis(stations);
+            VisibilityStep links;
+            batch.propagate(0.0, x.data(), y.data(), z.data());
+            report(measure("visibility.matrix", N, N, opt.minTime, [&](int k) {
+                double t = k * STEP;
+                vis.compute(t, EARTH_ROTATION_SPEED * t, x.data(), y.data(), z.data(), N, links);
+                return (double)links.pairs();
+            }));
+        }
+        if (enabled("render.mesh_transform")) {
+            PointCloud cloud;
+            std::mt19937_64 rng(opt.seed + 2);
+            std::normal_distribution<double> G(0.0, 1.0);
+            for (size_t i = 0; i < N; i++) cloud.addOnSphere(200 * G(rng), 200 * G(rng), 200 * G(rng) + 1e-9);
+            ProjectedPoints proj;
+            std::vector<uint8_t> lit(N);
+            report(measure("render.mesh_transform", N, N, opt.minTime, [&](int k) {
+                ViewTransform view = ViewTransform::orbitCamera(0.3 + k * 0.01, k * 0.02, 600.0, 1000.0, 600, 450, 500);
+                ViewTransform earth = view.withModel(Mat3::rotateY(-EARTH_ROTATION_SPEED * k * STEP));
+                earth.project(cloud, proj);
+                float lx, ly, lz;
+                earth.lightInModel(-1, 0, 0, lx, ly, lz);
+                for (size_t i = 0; i < N; i++) lit[i] = cloud.nx[i] * lx + cloud.ny[i] * ly + cloud.nz[i] * lz > 0;
+                return (double)proj.sx[0] + proj.sy[N - 1] + lit[N / 2];
+            }));
+        }
+        if (enabled("render.trail_push")) {
+            TrailArena trails(N, 150, 0.0, 64 << 20);
+            batch.propagate(0.0, x.data(), y.data(), z.data());
+            report(measure("render.trail_push", N, N, opt.minTime, [&](int k) {
+                double t = k * STEP;
+                for (size_t i = 0; i < N; i++) trails.push(i, t, x[i], y[i], z[i]);
+                return (double)trails.size(N - 1);
+            }));
+        }
+    }
+
+    FILE* f = opt.out ? std::fopen(opt.out, "w") : stdout;
+    if (!f) {
+        std::fprintf(stderr, "Cannot write %s\n", opt.out);
+        return 1;
+    }
+    writeJson(f, opt, results);
+    if (opt.out) std::fclose(f);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "tle_catalog.hpp"
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <string>
+
+// TLE ingestion benchmark: full-catalog load + incremental reload.
+//
+// Build: clang++ bench_tle.cpp -o bench_tle -std=c++17 -O3
+// Run:   ./bench_tle [records] [file]        (default 30000 /tmp/bench_catalog.tle)
+//        ./bench_tle path/to/catalog.tle     (time a real CelesTrak file instead)
+
+// Append the mod-10 checksum as column 69
+void sealLine(char* line) {
+    int sum = 0;
+    for (int i = 0; i < 68; i++) {
+        if (line[i] >= '0' && line[i] <= '9') sum += line[i] - '0';
+        else if (line[i] == '-') sum += 1;
+    }
+    line[68] = (char)('0' + sum % 10);
+    line[69] = '\0';
+}
+
+void writeRecord(FILE* f, int satnum, double meanAnomalyDeg, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    char l1[80], l2[80];
+    std::snprintf(l1, sizeof(l1), "1 %05dU 24001A   24%012.8f  .00001234  00000-0  12345-3 0  999 ",
+                  satnum, 1.0 + U(rng) * 300.0);
+    std::snprintf(l2, sizeof(l2), "2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f12345 ",
+                  satnum, U(rng) * 180.0, U(rng) * 360.0, (int)(U(rng) * 0.1 * 1e7),
+                  U(rng) * 360.0, meanAnomalyDeg, 1.0 + U(rng) * 15.0);
+    sealLine(l1);
+    sealLine(l2);
+    std::fprintf(f, "OBJECT %05d\n%s\n%s\n", satnum, l1, l2);
+}
+
+double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    TleCatalog catalog;
+
+    // Real catalog file given: just time it
+    if (argc == 2 && !std::isdigit((unsigned char)argv[1][0])) {
+        auto t0 = std::chrono::steady_clock::now();
+        if (!catalog.load(argv[1])) { std::fprintf(stderr, "Cannot open %s\n", argv[1]); return 1; }
+        std::printf("%s: %zu records (%zu bad) in %.2f ms\n", argv[1], catalog.records.size(), catalog.badRecords, msSince(t0));
+        return 0;
+    }
+
+    int N = (argc > 1) ? std::atoi(argv[1]) : 30000;
+    std::string path = (argc > 2) ? argv[2] : "/tmp/bench_catalog.tle";
+    if (N > 99999) N = 99999;   // 5-digit catalog numbers
+
+    std::mt19937_64 rng(1234);
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", path.c_str()); return 1; }
+    for (int i = 1; i <= N; i++) writeRecord(f, i, 10.0, rng);
+    std::fclose(f);
+
+    auto t0 = std::chrono::steady_clock::now();
+    catalog.load(path.c_str());
+    double fullMs = msSince(t0);
+    std::printf("--- TLE Ingestion (%d records) ---\n", N);
+    std::printf("Full load : %8.2f ms | %zu records, %zu bad, %.0f records/s\n",
+                fullMs, catalog.records.size(), catalog.badRecords, catalog.records.size() / (fullMs / 1000.0));
+
+    // Rewrite with 1% of the records changed (same rng stream -> same others)
+    rng.seed(1234);
+    f = std::fopen(path.c_str(), "w");
+    for (int i = 1; i <= N; i++) writeRecord(f, i, (i % 100 == 0) ? 20.0 : 10.0, rng);
+    std::fclose(f);
+    // Make sure the mtime moves even on coarse-timestamp filesystems
+    std::string touch = "touch -d '+2 seconds' " + path + " 2>/dev/null || touch -A 02 " + path + " 2>/dev/null";
+    if (std::system(touch.c_str()) != 0) {}
+
+    t0 = std::chrono::steady_clock::now();
+    size_t changed = catalog.reload();
+    double reloadMs = msSince(t0);
+    std::printf("Reload    : %8.2f ms | %zu changed, %zu of %zu records re-parsed\n", reloadMs, changed, catalog.reparsed,
+                catalog.records.size());
+
+    t0 = std::chrono::steady_clock::now();
+    size_t none = catalog.reload();
+    std::printf("No change : %8.3f ms | %zu re-parsed\n", msSince(t0), none);
+
+    // Drop every 50th record, nothing else edited: still a change (same
+    // rng stream, the dropped ones go to /dev/null)
+    rng.seed(1234);
+    f = std::fopen(path.c_str(), "w");
+    FILE* sink = std::fopen("/dev/null", "w");
+    for (int i = 1; i <= N; i++) writeRecord(i % 50 == 0 && sink ? sink : f, i, (i % 100 == 0) ? 20.0 : 10.0, rng);
+    std::fclose(f);
+    if (sink) std::fclose(sink);
+    if (std::system(touch.c_str()) != 0) {}
+    t0 = std::chrono::steady_clock::now();
+    size_t dropped = catalog.reload();
+    std::printf("Deletion  : %8.2f ms | %zu changed (%zu removed, %zu re-parsed) -> %zu records\n", msSince(t0), dropped,
+                catalog.removed, catalog.reparsed, catalog.records.size());
+    bool pass = none == 0 && dropped != TleCatalog::NO_FILE && catalog.removed == (size_t)(N / 50) &&
+                catalog.reparsed == 0 && catalog.records.size() == (size_t)(N - N / 50);
+
+    KeplerBatch batch;
+    t0 = std::chrono::steady_clock::now();
+    catalog.toKeplerBatch(batch, catalog.latestEpochJD());
+    std::printf("To batch  : %8.2f ms | %zu objects\n", msSince(t0), batch.size());
+    if (!pass) std::printf("FAILED: reload change accounting\n");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include "orbit_common.hpp"
+#include "view_transform.hpp"
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+
+// Per-frame CPU cost of the earth mesh and trail projection in main_3d_sat:
+// the original per-point rotateY/rotateX + spin + sqrt lighting against one
+// ViewTransform matrix over SoA floats. Drawing is not included.
+//
+// Build: clang++ bench_view_transform.cpp -o bench_view_transform -std=c++17 -O3 -march=native -fno-trapping-math
+// Run:   ./bench_view_transform [satellites] [trail samples]   (default 1000 150)
+
+Vector3 rotateX(Vector3 p, double angle) {
+    return {p.x, p.y * cos(angle) - p.z * sin(angle), p.y * sin(angle) + p.z * cos(angle)};
+}
+Vector3 rotateY(Vector3 p, double angle) {
+    return {p.x * cos(angle) + p.z * sin(angle), p.y, -p.x * sin(angle) + p.z * cos(angle)};
+}
+
+struct ScreenPoint { float x, y; unsigned char lit, keep; };
+
+int main(int argc, char** argv) {
+    size_t sats = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    size_t samples = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 150;
+    const int FRAMES = 200;
+    const double SCALE = 200.0 / R_EARTH;
+
+    // Earth mesh as main_3d_sat builds it (5 deg grid)
+    std::vector<Vector3> meshAos;
+    PointCloud mesh;
+    for (int lat = -90; lat <= 90; lat += 5) {
+        for (int lon = 0; lon < 360; lon += 5) {
+            double latRad = lat * M_PI / 180.0, lonRad = lon * M_PI / 180.0;
+            Vector3 p = {200 * cos(latRad) * cos(lonRad), 200 * sin(latRad), 200 * cos(latRad) * sin(lonRad)};
+            meshAos.push_back(p);
+            mesh.addOnSphere(p.x, p.y, p.z);
+        }
+    }
+
+    // Trails: visual-space points (old) and float ECI (new), same orbits
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> U(-1.0, 1.0);
+    std::vector<Vector3> trailAos(sats * samples);
+    std::vector<float> trailEci(sats * samples * 4);
+    for (size_t i = 0; i < trailAos.size(); i++) {
+        Vector3 p = {U(rng) * 7e6, U(rng) * 7e6, U(rng) * 7e6};
+        trailAos[i] = {p.x * SCALE, p.z * SCALE, p.y * SCALE};
+        trailEci[i * 4] = (float)p.x; trailEci[i * 4 + 1] = (float)p.y; trailEci[i * 4 + 2] = (float)p.z;
+    }
+
+    std::vector<ScreenPoint> outOld(meshAos.size() + trailAos.size());
+    ProjectedPoints proj;
+    std::vector<float> tsx(trailAos.size()), tsy(trailAos.size());
+    std::vector<uint8_t> lit(mesh.size());
+    double checksumOld = 0, checksumNew = 0, maxDiff = 0;
+
+    // --- Original: per point trig, spin, sqrt ---
+    auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        double camX = 0.3 + f * 0.01, camY = f * 0.02, zoom = 1.0, time = f * 100.0;
+        size_t k = 0;
+        for (auto& p : meshAos) {
+            double theta = EARTH_ROTATION_SPEED * time;
+            double x_spin = p.x * cos(theta) - p.z * sin(theta);
+            double z_spin = p.x * sin(theta) + p.z * cos(theta);
+            Vector3 pSpin = {x_spin, p.y, z_spin};
+            Vector3 r = rotateY(pSpin, camY); r = rotateX(r, camX);
+            double mag = sqrt(pSpin.x * pSpin.x + pSpin.y * pSpin.y + pSpin.z * pSpin.z);
+            double light = -pSpin.x / mag;
+            double perspective = zoom * 600.0 / (1000.0 - r.z);
+            outOld[k++] = {(float)(r.x * perspective + 600), (float)(r.y * perspective + 450), light > 0, r.z < 500};
+        }
+        for (auto& tp : trailAos) {
+            Vector3 tr = rotateY(tp, camY); tr = rotateX(tr, camX);
+            double tpP = zoom * 600.0 / (1000.0 - tr.z);
+            outOld[k++] = {(float)(tr.x * tpP + 600), (float)(tr.y * tpP + 450), 0, 1};
+        }
+        checksumOld += outOld[f % outOld.size()].x;
+    }
+    double oldSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // --- Matrix pipeline ---
+    t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < FRAMES; f++) {
+        double camX = 0.3 + f * 0.01, camY = f * 0.02, zoom = 1.0, time = f * 100.0;
+        ViewTransform view = ViewTransform::orbitCamera(camX, camY, zoom * 600.0, 1000.0, 600, 450, 500);
+        ViewTransform earth = view.withModel(Mat3::rotateY(-EARTH_ROTATION_SPEED * time));
+        Mat3 eciToVisual = {{{SCALE, 0, 0}, {0, 0, SCALE}, {0, SCALE, 0}}};
+        ViewTransform orbits = view.withModel(eciToVisual);
+
+        earth.project(mesh, proj);
+        float lx, ly, lz;
+        earth.lightInModel(-1, 0, 0, lx, ly, lz);
+        for (size_t i = 0; i < mesh.size(); i++) lit[i] = mesh.nx[i] * lx + mesh.ny[i] * ly + mesh.nz[i] * lz > 0;
+        orbits.projectStrided(trailEci.data(), 4, trailAos.size(), tsx.data(), tsy.data());
+        checksumNew += f % outOld.size() < mesh.size() ? proj.sx[f % outOld.size()] : tsx[f % outOld.size() - mesh.size()];
+
+        if (f == FRAMES - 1) {
+            // Compare the last frame with the original path
+            size_t k = 0;
+            for (size_t i = 0; i < mesh.size(); i++, k++) {
+                maxDiff = std::fmax(maxDiff, std::fabs(proj.sx[i] - outOld[k].x) + std::fabs(proj.sy[i] - outOld[k].y));
+                if (lit[i] != outOld[k].lit || proj.keep[i] != outOld[k].keep) maxDiff = 1e9;
+            }
+            for (size_t i = 0; i < trailAos.size(); i++, k++) {
+                maxDiff = std::fmax(maxDiff, std::fabs(tsx[i] - outOld[k].x) + std::fabs(tsy[i] - outOld[k].y));
+            }
+        }
+    }
+    double newSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    size_t points = mesh.size() + trailAos.size();
+    std::printf("--- View Transform (%zu mesh points + %zu sats x %zu trail samples, %d frames) ---\n",
+                mesh.size(), sats, samples, FRAMES);
+    std::printf("Per-point trig : %8.3f ms/frame | %6.1f ns/point\n", oldSec / FRAMES * 1e3, oldSec / FRAMES / points * 1e9);
+    std::printf("Frame matrix   : %8.3f ms/frame | %6.1f ns/point\n", newSec / FRAMES * 1e3, newSec / FRAMES / points * 1e9);
+    std::printf("Speedup        : %.1fx | max screen difference %.4f px (checksums %.0f %.0f)\n",
+                oldSec / newSec, maxDiff, checksumOld, checksumNew);
+    return maxDiff < 0.05 ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include "kepler_batch.hpp"
+#include "visibility_matrix.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Station x satellite visibility benchmark: grid-pruned VisibilityMatrix vs
+// the all-pairs reference, with an exact-match check on every step.
+//
+// Build: clang++ bench_visibility.cpp -o bench_visibility -std=c++17 -O3 -march=native -fno-trapping-math -pthread
+// Run:   ./bench_visibility [satellites] [stations] [steps]     (default 20000 500 30)
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t N = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    size_t S = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 500;
+    int steps = (argc > 3) ? std::atoi(argv[3]) : 30;
+
+    std::mt19937_64 rng(6);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+
+    // Catalog mix: 85% LEO, 10% MEO, 5% GEO-ish
+    KeplerBatch batch;
+    for (size_t i = 0; i < N; i++) {
+        double u = U(rng);
+        double revs = u < 0.85 ? 12.0 + U(rng) * 4.0 : (u < 0.95 ? 2.0 + U(rng) * 0.2 : 1.0027);
+        batch.add(U(rng) * M_PI, U(rng) * 2 * M_PI, U(rng) * 0.02, U(rng) * 2 * M_PI, U(rng) * 2 * M_PI,
+                  revs * (2 * M_PI / 86400));
+    }
+
+    // Stations uniform on the sphere, 5-15 deg masks
+    std::vector<GroundStation> stations;
+    for (size_t k = 0; k < S; k++) {
+        stations.push_back({std::asin(2 * U(rng) - 1) * 180.0 / M_PI, U(rng) * 360.0 - 180.0, U(rng) * 2000.0, 5.0 + U(rng) * 10.0});
+    }
+
+    WorkStealingPool pool;
+    VisibilityMatrix vis(stations);
+    VisibilityStep grid, brute;
+    std::vector<double> x(N), y(N), z(N);
+
+    double gridSec = 0, bruteSec = 0;
+    uint64_t pairs = 0, tested = 0;
+    int mismatches = 0;
+    for (int s = 0; s < steps; s++) {
+        double t = s * 120.0;
+        batch.propagate(t, x.data(), y.data(), z.data());
+        double theta = EARTH_ROTATION_SPEED * t;
+
+        auto t0 = std::chrono::steady_clock::now();
+        vis.compute(t, theta, x.data(), y.data(), z.data(), N, grid, &pool);
+        gridSec += secondsSince(t0);
+        tested += vis.candidatesTested();
+        pairs += grid.pairs();
+
+        t0 = std::chrono::steady_clock::now();
+        vis.computeBruteForce(t, theta, x.data(), y.data(), z.data(), N, brute);
+        bruteSec += secondsSince(t0);
+
+        if (grid.offsets != brute.offsets || grid.sats != brute.sats) mismatches++;
+    }
+
+    double allPairs = (double)N * S * steps;
+    std::printf("--- Visibility Matrix (%zu satellites x %zu stations, %d steps, %u threads) ---\n",
+                N, S, steps, pool.threadCount());
+    std::printf("All pairs : %8.2f ms/step | %.0f pair tests/step\n", bruteSec / steps * 1e3, allPairs / steps);
+    std::printf("Grid      : %8.2f ms/step | %.0f pair tests/step (%.2f%% of S*N)\n",
+                gridSec / steps * 1e3, (double)tested / steps, 100.0 * tested / allPairs);
+    std::printf("Visible   : %.0f pairs/step (%.1f candidates per visible pair) | CSR %.1f KB/step\n",
+                (double)pairs / steps, pairs ? (double)tested / pairs : 0.0,
+                ((S + 1) + (double)pairs / steps) * 4 / 1024.0);
+    std::printf("Speedup   : %.1fx | output %s\n", bruteSec / gridSec, mismatches ? "MISMATCH" : "identical on every step");
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+#include "orbit_common.hpp"
+#include "integrators.hpp"
+#include "force_models.hpp"
+#include "time_warp.hpp"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Time warp: per-frame cost of advancing `objects` orbits at warp factors
+// 10x..100000x (60 frames per second of wall time), stepping the
+// integrator through every interval versus TimeWarp; and the accuracy of
+// the analytic jump against a fine RK4 run.
+//
+// Build: clang++ bench_warp.cpp -o bench_warp -std=c++17 -O3 -march=native -fno-trapping-math
+// Run:   ./bench_warp [objects]      (default 2000)
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<OrbitState> makeOrbits(size_t n) {
+    std::mt19937_64 rng(20);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<OrbitState> orbits(n);
+    for (auto& s : orbits) {
+        double r = R_EARTH + 400e3 + U(rng) * 1500e3, v = std::sqrt(MU_EARTH / r) * (1.0 + 0.02 * U(rng));
+        double inc = U(rng) * M_PI, phase = U(rng) * 2 * M_PI;
+        s.pos = {r * std::cos(phase), r * std::sin(phase), 0};
+        s.vel = {-v * std::sin(phase) * std::cos(inc), v * std::cos(phase) * std::cos(inc), v * std::sin(inc)};
+    }
+    return orbits;
+}
+
+// Mean ms per frame over `frames` frames of `frameSeconds` sim time each
+template <class Step>
+double msPerFrame(std::vector<OrbitState> orbits, int frames, double frameSeconds, Step step) {
+    auto t0 = Clock::now();
+    double t = 0;
+    for (int f = 0; f < frames; f++, t += frameSeconds) {
+        for (size_t i = 0; i < orbits.size(); i++) step(i, orbits[i], t, frameSeconds);
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count() / frames;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    std::vector<OrbitState> orbits = makeOrbits(n);
+
+    std::printf("--- Time Warp (%zu objects, 60 frames/s, Forest-Ruth 10 s below the warp threshold) ---\n", n);
+    std::printf("%10s %14s %14s %10s %12s\n", "warp", "stepping ms", "TimeWarp ms", "path", "fits 60 FPS");
+    bool fast = true;
+    for (double warp : {10.0, 100.0, 1000.0, 10000.0, 100000.0}) {
+        double frameSeconds = warp / 60.0;
+        int frames = warp >= 10000 ? 5 : 30;
+        std::vector<Integrator> stepping(n, Integrator(IntegratorKind::ForestRuth));
+        double old = msPerFrame(orbits, frames, frameSeconds, [&](size_t i, OrbitState& s, double t, double h) {
+            stepping[i].advance(s, t, h, TwoBodyForce());
+        });
+        std::vector<Integrator> integ(n, Integrator(IntegratorKind::ForestRuth));
+        std::vector<TimeWarp> warps(n);
+        double now = msPerFrame(orbits, frames, frameSeconds, [&](size_t i, OrbitState& s, double t, double h) {
+            warps[i].advance(integ[i], s, t, h, TwoBodyForce());
+        });
+        bool ok = now < 1000.0 / 60.0;
+        fast = fast && (warp < 100000 || ok);
+        std::printf("%9.0fx %14.3f %14.3f %10s %12s\n", warp, old, now, warpPathName(warps[0].lastPath()), ok ? "yes" : "no");
+    }
+
+    // --- Accuracy: one jump vs RK4 at 1 s, over a day ---
+    double worst = 0;
+    TwoBodyForce twoBody;
+    for (size_t i = 0; i < 20 && i < n; i++) {
+        OrbitState jump = orbits[i], fine = orbits[i];
+        keplerJump(jump, 86400.0);
+        for (int k = 0; k < 86400; k++) RK4::step(fine, k, 1.0, twoBody);
+        worst = std::fmax(worst, (jump.pos - fine.pos).magnitude());
+    }
+    // Round trip: a day forward, a day back
+    OrbitState trip = orbits[0];
+    keplerJump(trip, 86400.0);
+    keplerJump(trip, -86400.0);
+    double roundTrip = (trip.pos - orbits[0].pos).magnitude();
+    // A perturbed force falls back to adaptive steps
+    TimeWarp warp;
+    Integrator integ;
+    OrbitState s = orbits[0];
+    warp.advance(integ, s, 0.0, 3600.0, ForceModel<TwoBody, J2>());
+    std::printf("Jump vs RK4 (1 s, 1 day): worst %.2e m | round trip +-1 day: %.2e m | with J2: %s path\n",
+                worst, roundTrip, warpPathName(warp.lastPath()));
+    return fast && worst < 1.0 && roundTrip < 1e-3 && warp.lastPath() == WarpPath::Adaptive ? 0 : 1;
+}
@@ -0,0 +1,435 @@
+#pragma once
+#include "kepler_batch.hpp"
+#include "trail_arena.hpp"
+#include "ephemeris_cache.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <initializer_list>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ============================================================================
+// Checkpoints: simulation state as one versioned, checksummed binary file.
+//
+//   header   CheckpointHeader (64 bytes, little endian)
+//   table    CheckpointSection[sections] (64 bytes each)
+//   data     one block per section, each starting on a 64-byte boundary
+//
+// A section is a named flat array ("kepler.meanMotion", "trails.samples",
+// ...). The header carries the sim time and step count and checksums of
+// itself and of the table; every section has its own checksum.
+//
+// Writing is split so the simulation never waits on the disk: capturing
+// a Checkpoint copies the arrays (memcpy speed, on the thread that owns
+// the state), and CheckpointWriter checksums and writes it on its own
+// thread, to `path`.tmp and then rename()s it over `path`, so readers
+// only ever see complete files.
+//
+// CheckpointReader mmap()s the file and hands out pointers straight into
+// the mapping: open() touches only the header and table, so it takes
+// microseconds at any size, and pages are read as sections are used.
+// verify() checks every section checksum (reads the whole file).
+//
+// Deterministic replay: a run restored from a checkpoint and stepped with
+// the same step sizes reproduces the original bit for bit, as long as
+// everything a step reads was saved (bench_checkpoint checks this).
+// save*/restore* below cover KeplerBatch, TrailArena and EphemerisCache.
+// ============================================================================
+
+struct CheckpointHeader {
+    char magic[8];              // "ORBCKPT\0"
+    uint32_t version;           // 1
+    uint32_t sections;
+    uint64_t fileBytes;
+    double simTime;             // s
+    uint64_t step;              // physics steps taken
+    uint64_t tableChecksum;     // over the section table
+    uint64_t headerChecksum;    // over the 48 bytes above
+    uint64_t reserved;
+};
+static_assert(sizeof(CheckpointHeader) == 64, "checkpoint header layout");
+
+struct CheckpointSection {
+    char name[32];              // NUL-terminated
+    uint64_t offset, bytes;     // from the start of the file
+    uint64_t checksum;
+    uint32_t elemSize;          // bytes per element (type check on read)
+    uint32_t reserved;
+};
+static_assert(sizeof(CheckpointSection) == 64, "checkpoint section layout");
+
+const char CHECKPOINT_MAGIC[8] = {'O', 'R', 'B', 'C', 'K', 'P', 'T', '\0'};
+const uint32_t CHECKPOINT_VERSION = 1;
+
+// 64-bit checksum: four independent multiply-rotate lanes over 8-byte
+// words (runs at memory speed), folded with the length. Catches corruption
+// and truncation; not cryptographic.
+inline uint64_t checkpointChecksum(const void* data, size_t bytes) {
+    const uint64_t P1 = 0x9E3779B185EBCA87ULL, P2 = 0xC2B2AE3D27D4EB4FULL;
+    auto round = [&](uint64_t h, uint64_t w) {
+        h += w * P2;
+        h = (h << 31) | (h >> 33);
+        return h * P1;
+    };
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h[4] = {P1 + P2, P2, 0, 0 - P1};
+    size_t blocks = bytes / 32;
+    for (size_t b = 0; b < blocks; b++, p += 32) {
+        uint64_t w[4];
+        std::memcpy(w, p, 32);
+        h[0] = round(h[0], w[0]); h[1] = round(h[1], w[1]);
+        h[2] = round(h[2], w[2]); h[3] = round(h[3], w[3]);
+    }
+    uint64_t r = bytes * P1;
+    for (int k = 0; k < 4; k++) r = round(r ^ h[k], (uint64_t)k + 1);
+    for (size_t k = blocks * 32; k < bytes; k++, p++) r = (r ^ *p) * 0x100000001B3ULL;
+    r ^= r >> 33; r *= P2;
+    r ^= r >> 29; r *= P1;
+    return r ^ (r >> 32);
+}
+
+// Captured state, ready to be written. Sections own copies of the data;
+// clear() keeps their buffers, so capturing the same state again costs a
+// memcpy and no page faults (fresh pages dominate the first capture).
+class Checkpoint {
+public:
+    double simTime = 0;
+    uint64_t step = 0;
+
+    Checkpoint() = default;
+    Checkpoint(Checkpoint&&) = default;
+    Checkpoint& operator=(Checkpoint&&) = default;
+
+    // Drop the sections, keep their memory for the next capture
+    void clear() { used = 0; }
+
+    // Uninitialised room for `count` elements, filled by the caller
+    template <class T>
+    T* alloc(const char* name, size_t count) {
+        if (used == sections.size()) sections.emplace_back();
+        Section& s = sections[used++];
+        std::snprintf(s.name, sizeof(s.name), "%s", name);
+        s.elemSize = sizeof(T);
+        s.bytes = count * sizeof(T);
+        if (s.bytes > s.capacity || !s.data) {
+            s.capacity = s.bytes;
+            s.data.reset(new char[s.bytes ? s.bytes : 1]);
+        }
+        return (T*)s.data.get();
+    }
+
+    template <class T>
+    void add(const char* name, const T* data, size_t count) {
+        std::memcpy(alloc<T>(name, count), data, count * sizeof(T));
+    }
+    template <class T>
+    void add(const char* name, const std::vector<T>& v) { add(name, v.data(), v.size()); }
+    void add(const char* name, std::initializer_list<double> values) { add(name, values.begin(), values.size()); }
+
+    size_t sectionCount() const { return used; }
+    size_t bytes() const {
+        size_t total = 0;
+        for (size_t k = 0; k < used; k++) total += sections[k].bytes;
+        return total;
+    }
+
+    // Write to path.tmp, fsync, rename over path. Runs on the caller's thread.
+    bool write(const std::string& path) const {
+        CheckpointHeader h = {};
+        std::vector<CheckpointSection> table(used);
+        uint64_t offset = align(sizeof(h) + table.size() * sizeof(CheckpointSection));
+        for (size_t k = 0; k < used; k++) {
+            CheckpointSection& e = table[k];
+            std::memcpy(e.name, sections[k].name, sizeof(e.name));
+            e.offset = offset;
+            e.bytes = sections[k].bytes;
+            e.checksum = checkpointChecksum(sections[k].data.get(), e.bytes);
+            e.elemSize = sections[k].elemSize;
+            offset = align(offset + e.bytes);
+        }
+        std::memcpy(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic));
+        h.version = CHECKPOINT_VERSION;
+        h.sections = (uint32_t)table.size();
+        h.fileBytes = offset;
+        h.simTime = simTime;
+        h.step = step;
+        h.tableChecksum = checkpointChecksum(table.data(), table.size() * sizeof(CheckpointSection));
+        h.headerChecksum = checkpointChecksum(&h, offsetof(CheckpointHeader, headerChecksum));
+
+        std::string tmp = path + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        bool ok = ftruncate(fd, (off_t)offset) == 0 && writeAt(fd, &h, sizeof(h), 0) &&
+                  writeAt(fd, table.data(), table.size() * sizeof(CheckpointSection), sizeof(h));
+        for (size_t k = 0; ok && k < used; k++) {
+            ok = writeAt(fd, sections[k].data.get(), table[k].bytes, table[k].offset);
+        }
+        ok = ok && fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (ok) ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+        if (!ok) std::remove(tmp.c_str());
+        return ok;
+    }
+
+private:
+    struct Section {
+        char name[32] = {};
+        uint32_t elemSize = 1;
+        size_t bytes = 0, capacity = 0;
+        std::unique_ptr<char[]> data;
+    };
+
+    static uint64_t align(uint64_t offset) { return (offset + 63) & ~(uint64_t)63; }
+
+    // pwrite() until everything is out (handles short writes)
+    static bool writeAt(int fd, const void* p, size_t bytes, uint64_t offset) {
+        const char* c = (const char*)p;
+        while (bytes > 0) {
+            ssize_t w = pwrite(fd, c, bytes, (off_t)offset);
+            if (w <= 0) return false;
+            c += w; bytes -= (size_t)w; offset += (uint64_t)w;
+        }
+        return true;
+    }
+
+    std::vector<Section> sections;
+    size_t used = 0;
+};
+
+// Writes checkpoints on a background thread, one at a time. submit()
+// swaps buffers with the caller: it gets back the previously written
+// checkpoint (cleared), to capture into next time.
+class CheckpointWriter {
+public:
+    CheckpointWriter() = default;
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+    ~CheckpointWriter() { wait(); }
+
+    // Take over `ckpt` and write it to `path` in the background. Returns
+    // false (and leaves ckpt alone) while the previous checkpoint is still
+    // being written.
+    bool submit(Checkpoint& ckpt, const std::string& path) {
+        if (busy()) return false;
+        if (worker.joinable()) worker.join();
+        std::swap(pending, ckpt);
+        ckpt.clear();
+        running.store(true);
+        worker = std::thread([this, path] {
+            auto t0 = std::chrono::steady_clock::now();
+            bool ok = pending.write(path);
+            lastSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            lastBytes = pending.bytes();
+            lastOk.store(ok);
+            written.fetch_add(ok);
+            running.store(false);
+        });
+        return true;
+    }
+
+    bool busy() const { return running.load(); }
+
+    // Block until the current write (if any) is done; its result
+    bool wait() {
+        if (worker.joinable()) worker.join();
+        return lastOk.load();
+    }
+
+    uint64_t checkpointsWritten() const { return written.load(); }
+    bool lastSucceeded() const { return lastOk.load(); }
+    // Valid once busy() is false
+    double lastWriteSeconds() const { return lastSeconds; }
+    size_t lastWriteBytes() const { return lastBytes; }
+
+private:
+    Checkpoint pending;
+    std::thread worker;
+    std::atomic<bool> running{false}, lastOk{true};
+    std::atomic<uint64_t> written{0};
+    double lastSeconds = 0;
+    size_t lastBytes = 0;
+};
+
+// mmap'd checkpoint; sections are read in place
+class CheckpointReader {
+public:
+    CheckpointHeader header = {};
+
+    CheckpointReader() = default;
+    CheckpointReader(const CheckpointReader&) = delete;
+    CheckpointReader& operator=(const CheckpointReader&) = delete;
+    ~CheckpointReader() { close(); }
+
+    // Map the file and check the header, the table and the section bounds
+    // (not the section data: see verify())
+    bool open(const char* path) {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CheckpointHeader)) { ::close(fd); return false; }
+        size = (size_t)st.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        data = (const char*)p;
+
+        std::memcpy(&header, data, sizeof(header));
+        bool ok = std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) == 0 &&
+                  header.version == CHECKPOINT_VERSION && header.fileBytes == size &&
+                  header.headerChecksum == checkpointChecksum(&header, offsetof(CheckpointHeader, headerChecksum)) &&
+                  sizeof(header) + (uint64_t)header.sections * sizeof(CheckpointSection) <= size;
+        if (ok) {
+            table = (const CheckpointSection*)(data + sizeof(header));
+            ok = header.tableChecksum == checkpointChecksum(table, header.sections * sizeof(CheckpointSection));
+        }
+        for (uint32_t k = 0; ok && k < header.sections; k++) {
+            const CheckpointSection& s = table[k];
+            ok = s.offset % 64 == 0 && s.offset <= size && s.bytes <= size - s.offset && s.elemSize > 0 &&
+                 s.bytes % s.elemSize == 0 && std::memchr(s.name, 0, sizeof(s.name));
+        }
+        if (!ok) close();
+        return ok;
+    }
+
+    void close() {
+        if (data) munmap((void*)data, size);
+        data = nullptr;
+        table = nullptr;
+        size = 0;
+    }
+
+    bool isOpen() const { return data != nullptr; }
+    size_t bytes() const { return size; }
+
+    // Every section's checksum
+    bool verify() const {
+        for (uint32_t k = 0; data && k < header.sections; k++) {
+            if (checkpointChecksum(data + table[k].offset, table[k].bytes) != table[k].checksum) return false;
+        }
+        return data != nullptr;
+    }
+
+    // Section `name` as an array of T inside the mapping, or nullptr if it
+    // is missing or was written with a different element size
+    template <class T>
+    const T* get(const char* name, size_t& count) const {
+        const CheckpointSection* s = find(name);
+        count = 0;
+        if (!s || s->elemSize != sizeof(T)) return nullptr;
+        count = s->bytes / sizeof(T);
+        return (const T*)(data + s->offset);
+    }
+
+    // Same, but only if it holds exactly `count` elements
+    template <class T>
+    const T* getExact(const char* name, size_t count) const {
+        size_t n;
+        const T* p = get<T>(name, n);
+        return n == count ? p : nullptr;
+    }
+
+private:
+    const CheckpointSection* find(const char* name) const {
+        for (uint32_t k = 0; data && k < header.sections; k++) {
+            if (std::strncmp(table[k].name, name, sizeof(table[k].name)) == 0) return &table[k];
+        }
+        return nullptr;
+    }
+
+    const char* data = nullptr;
+    const CheckpointSection* table = nullptr;
+    size_t size = 0;
+};
+
+// --- Module state ---
+// Each save* writes `prefix`.<field> sections; the matching restore*
+// returns false and leaves the target alone if anything is missing or
+// does not fit.
+
+inline std::string checkpointName(const char* prefix, const char* field) { return std::string(prefix) + "." + field; }
+
+// KeplerBatch columns, all per-object doubles
+const std::pair<const char*, std::vector<double> KeplerBatch::*> KEPLER_BATCH_COLUMNS[] = {
+    {"meanAnomaly", &KeplerBatch::meanAnomaly}, {"meanMotion", &KeplerBatch::meanMotion},
+    {"ecc", &KeplerBatch::ecc}, {"semiMajor", &KeplerBatch::semiMajor}, {"semiMinor", &KeplerBatch::semiMinor},
+    {"Px", &KeplerBatch::Px}, {"Py", &KeplerBatch::Py}, {"Pz", &KeplerBatch::Pz},
+    {"Qx", &KeplerBatch::Qx}, {"Qy", &KeplerBatch::Qy}, {"Qz", &KeplerBatch::Qz}};
+
+inline void saveKeplerBatch(Checkpoint& ck, const KeplerBatch& b, const char* prefix = "kepler") {
+    for (const auto& col : KEPLER_BATCH_COLUMNS) ck.add(checkpointName(prefix, col.first).c_str(), b.*col.second);
+}
+
+inline bool restoreKeplerBatch(const CheckpointReader& r, KeplerBatch& b, const char* prefix = "kepler") {
+    size_t n;
+    if (!r.get<double>(checkpointName(prefix, "meanMotion").c_str(), n)) return false;
+    for (const auto& col : KEPLER_BATCH_COLUMNS) {
+        if (!r.getExact<double>(checkpointName(prefix, col.first).c_str(), n)) return false;
+    }
+    for (const auto& col : KEPLER_BATCH_COLUMNS) {
+        const double* p = r.getExact<double>(checkpointName(prefix, col.first).c_str(), n);
+        (b.*col.second).assign(p, p + n);
+    }
+    return true;
+}
+
+inline void saveTrails(Checkpoint& ck, const TrailArena& trails, const char* prefix = "trails") {
+    size_t n = trails.objects();
+    ck.add(checkpointName(prefix, "params").c_str(), {(double)n, (double)trails.capacity(), trails.interval, trails.epoch});
+    ck.add(checkpointName(prefix, "samples").c_str(), trails.data(), n * trails.capacity());
+    ck.add(checkpointName(prefix, "head").c_str(), trails.heads(), n);
+    ck.add(checkpointName(prefix, "count").c_str(), trails.counts(), n);
+    ck.add(checkpointName(prefix, "lastT").c_str(), trails.lastTimes(), n);
+}
+
+inline bool restoreTrails(const CheckpointReader& r, TrailArena& trails, const char* prefix = "trails") {
+    const double* params = r.getExact<double>(checkpointName(prefix, "params").c_str(), 4);
+    if (!params || !(params[0] >= 0 && params[0] <= UINT32_MAX && params[1] >= 1 && params[1] <= UINT32_MAX)) return false;
+    size_t n = (size_t)params[0];
+    uint32_t cap = (uint32_t)params[1];
+    const TrailSample* s = r.getExact<TrailSample>(checkpointName(prefix, "samples").c_str(), n * cap);
+    const uint32_t* head = r.getExact<uint32_t>(checkpointName(prefix, "head").c_str(), n);
+    const uint32_t* count = r.getExact<uint32_t>(checkpointName(prefix, "count").c_str(), n);
+    const double* lastT = r.getExact<double>(checkpointName(prefix, "lastT").c_str(), n);
+    if (!s || !head || !count || !lastT) return false;
+    // A ring position or fill past the capacity would write out of bounds on the next push
+    for (size_t i = 0; i < n; i++) {
+        if (head[i] >= cap || count[i] > cap) return false;
+    }
+    trails.restore(n, cap, params[2], params[3], s, head, count, lastT);
+    return true;
+}
+
+inline void saveEphemeris(Checkpoint& ck, const EphemerisCache& eph, const char* prefix = "ephemeris") {
+    ck.add(checkpointName(prefix, "params").c_str(),
+           {(double)eph.objects(), eph.window(), (double)eph.degree(), eph.epochTime()});
+    double* c = ck.alloc<double>(checkpointName(prefix, "coeffs").c_str(), eph.coefficientCount());
+    int64_t* w = ck.alloc<int64_t>(checkpointName(prefix, "windows").c_str(), eph.slotCount());
+    eph.snapshot(c, w);
+}
+
+// The source function is not state; pass the same one the cache was built with
+inline bool restoreEphemeris(const CheckpointReader& r, EphemerisCache& eph, EphemerisCache::PositionFn fn,
+                             const char* prefix = "ephemeris") {
+    const double* params = r.getExact<double>(checkpointName(prefix, "params").c_str(), 4);
+    if (!params || !(params[0] >= 0 && params[0] <= UINT32_MAX)) return false;
+    size_t n = (size_t)params[0], slots = n * EphemerisCache::SLOTS;
+    int degree = (int)params[2];
+    if (degree < 2 || degree > EphemerisCache::MAX_DEGREE || !(params[1] > 0)) return false;
+    const double* c = r.getExact<double>(checkpointName(prefix, "coeffs").c_str(), slots * 3 * (degree + 1));
+    const int64_t* w = r.getExact<int64_t>(checkpointName(prefix, "windows").c_str(), slots);
+    if (!c || !w) return false;
+    eph.restore(n, std::move(fn), params[1], degree, params[3], c, w);
+    return true;
+}
@@ -0,0 +1,307 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+
+// ============================================================================
+// ConjunctionScreener: all object pairs closer than `threshold` in [t0, t1].
+//
+// Three stages, each only sees what the previous one let through:
+//   1. Apogee/perigee filter. Objects whose [perigee, apogee] shell (padded
+//      by the threshold) overlaps nobody else's are dropped outright, and
+//      every pair from stage 2 is re-checked against its two shells.
+//   2. Coarse time steps of `coarseStep` seconds. Positions are binned into
+//      a spatial hash for a search radius R = threshold + the distance two objects
+//      can close in half a step, so any pair that gets within the threshold
+//      is within R of each other at the nearest sample. Cells are 2R wide,
+//      so each object probes only the 8 cells on its near side.
+//   3. Time of closest approach. Hits are grouped per pair over consecutive
+//      steps; each local minimum of the sampled distance brackets a TCA,
+//      found by Brent's method on the two analytic orbits.
+// Time steps are independent, so stage 2 is spread over the pool in blocks.
+// ============================================================================
+
+struct Conjunction {
+    int a, b;                   // object indices, a < b
+    double tca;                 // s
+    double missDistance;        // m
+    double relativeSpeed;       // m/s at TCA
+};
+
+struct ConjunctionStats {
+    size_t objects = 0, activeObjects = 0, steps = 0;
+    uint64_t pairChecks = 0;        // distance tests after the shell check
+    uint64_t candidateHits = 0;     // (pair, step) samples within R
+    uint64_t refinements = 0;       // TCA searches
+    double screenRadius = 0;        // R [m]
+    double filterSec = 0, hashSec = 0, refineSec = 0;
+};
+
+class ConjunctionScreener {
+public:
+    ConjunctionScreener(const KeplerBatch& objects, double threshold, double coarseStep = 10.0)
+        : batch(objects), threshold(threshold), step(coarseStep) {}
+
+    const ConjunctionStats& stats() const { return st; }
+
+    void screen(double t0, double t1, std::vector<Conjunction>& out, WorkStealingPool* pool = nullptr) {
+        st = ConjunctionStats();
+        st.objects = batch.size();
+        out.clear();
+
+        auto clock = std::chrono::steady_clock::now();
+        shellFilter();
+        st.filterSec = lap(clock);
+
+        // Fastest possible closing speed: both objects at the fastest perigee
+        // in the set. Curvature adds up to g * (step/2)^2 / 2 per object.
+        double vmax = 0;
+        for (uint32_t i : active) {
+            double a = batch.semiMajor[i], rp = batch.perigeeRadius(i);
+            vmax = std::fmax(vmax, std::sqrt(MU_EARTH * (2.0 / rp - 1.0 / a)));
+        }
+        double half = 0.5 * step;
+        double gMax = MU_EARTH / (R_EARTH * R_EARTH);
+        R = threshold + 2 * vmax * half + gMax * half * half;
+        st.screenRadius = R;
+
+        steps = (size_t)std::ceil((t1 - t0) / step) + 1;     // last sample clamped to t1
+        st.steps = steps;
+        firstTime = t0;
+        lastTime = t1;
+
+        const size_t BLOCK = 32;    // steps per work item
+        size_t blocks = (steps + BLOCK - 1) / BLOCK;
+        blockHits.assign(blocks, {});
+        blockChecks.assign(blocks, 0);
+        auto work = [&](size_t begin, size_t end) { screenSteps(begin, end, begin / BLOCK); };
+        if (pool && active.size() > 1) pool->parallelFor(steps, BLOCK, work);
+        else for (size_t b = 0; b < steps; b += BLOCK) work(b, std::min(steps, b + BLOCK));
+        st.hashSec = lap(clock);
+
+        std::vector<Hit> hits;
+        for (auto& bh : blockHits) { hits.insert(hits.end(), bh.begin(), bh.end()); std::vector<Hit>().swap(bh); }
+        for (uint64_t c : blockChecks) st.pairChecks += c;
+        st.candidateHits = hits.size();
+        refine(hits, out);
+        st.refineSec = lap(clock);
+    }
+
+private:
+    struct Hit {
+        uint64_t pair;          // a << 32 | b
+        uint32_t step;
+        float dist2;
+    };
+
+    static double lap(std::chrono::steady_clock::time_point& t) {
+        auto now = std::chrono::steady_clock::now();
+        double s = std::chrono::duration<double>(now - t).count();
+        t = now;
+        return s;
+    }
+
+    bool shellsOverlap(uint32_t a, uint32_t b) const {
+        double lo = std::fmax(batch.perigeeRadius(a), batch.perigeeRadius(b));
+        double hi = std::fmin(batch.apogeeRadius(a), batch.apogeeRadius(b));
+        return lo - hi <= threshold;
+    }
+
+    // Keep objects whose radial shell overlaps at least one other shell.
+    // Sorted by perigee: i overlaps an earlier interval iff its perigee is
+    // below the running max apogee, and a later one iff its apogee reaches
+    // the next perigee.
+    void shellFilter() {
+        size_t n = batch.size();
+        std::vector<uint32_t> order(n);
+        for (size_t i = 0; i < n; i++) order[i] = (uint32_t)i;
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return batch.perigeeRadius(a) < batch.perigeeRadius(b); });
+        std::vector<char> keep(n, 0);
+        double maxApo = -1e300;
+        for (size_t k = 0; k < n; k++) {
+            uint32_t i = order[k];
+            if (batch.perigeeRadius(i) - threshold <= maxApo) keep[i] = 1;
+            if (k + 1 < n && batch.apogeeRadius(i) + threshold >= batch.perigeeRadius(order[k + 1])) keep[i] = 1;
+            maxApo = std::fmax(maxApo, batch.apogeeRadius(i));
+        }
+        active.clear();
+        for (size_t i = 0; i < n; i++) if (keep[i]) active.push_back((uint32_t)i);
+        st.activeObjects = active.size();
+    }
+
+    // --- STAGE 2: one block of coarse steps (own scratch, no sharing) ---
+    static constexpr uint64_t EMPTY = ~0ull;
+
+    static uint64_t cellKey(int64_t cx, int64_t cy, int64_t cz) {
+        const int64_t BIAS = 1 << 20;       // 21 bits per axis
+        return (uint64_t)(cx + BIAS) | (uint64_t)(cy + BIAS) << 21 | (uint64_t)(cz + BIAS) << 42;
+    }
+
+    static size_t slotOf(uint64_t key, size_t mask) {
+        key ^= key >> 29; key *= 0xbf58476d1ce4e5b9ull; key ^= key >> 32;
+        return (size_t)key & mask;
+    }
+
+    // Cells are 2R wide, so everything within R of an object lies in the
+    // 2x2x2 block made of its own cell and the neighbours on the side of
+    // each axis it is closer to: 8 probes per object. Each pair is found
+    // from both ends; only the lower active index reports it.
+    void screenSteps(size_t begin, size_t end, size_t block) {
+        size_t n = batch.size(), m = active.size();
+        std::vector<double> x(n), y(n), z(n);
+        size_t cap = 16;
+        while (cap < 2 * m) cap <<= 1;
+        std::vector<uint64_t> keys(cap);
+        std::vector<int32_t> head(cap);
+        std::vector<int32_t> next(m);
+        std::vector<int64_t> cell(3 * m);
+        std::vector<int8_t> side(3 * m);
+        std::vector<Hit>& hits = blockHits[block];
+        uint64_t checks = 0;
+        double inv = 0.5 / R, R2 = R * R;
+
+        auto find = [&](uint64_t key) {
+            size_t slot = slotOf(key, cap - 1);
+            while (keys[slot] != EMPTY && keys[slot] != key) slot = (slot + 1) & (cap - 1);
+            return slot;
+        };
+
+        for (size_t s = begin; s < end; s++) {
+            double t = timeOf(s);
+            if (2 * m > n) {
+                batch.propagate(t, x.data(), y.data(), z.data());
+            } else {
+                for (uint32_t i : active) { Vector3 p = batch.position(i, t); x[i] = p.x; y[i] = p.y; z[i] = p.z; }
+            }
+
+            // Bin: open addressing, one linked list of objects per cell
+            std::fill(keys.begin(), keys.end(), EMPTY);
+            for (size_t k = 0; k < m; k++) {
+                uint32_t i = active[k];
+                double fx = x[i] * inv, fy = y[i] * inv, fz = z[i] * inv;
+                int64_t cx = (int64_t)std::floor(fx), cy = (int64_t)std::floor(fy), cz = (int64_t)std::floor(fz);
+                cell[3 * k] = cx; cell[3 * k + 1] = cy; cell[3 * k + 2] = cz;
+                side[3 * k] = fx - cx < 0.5 ? -1 : 1;
+                side[3 * k + 1] = fy - cy < 0.5 ? -1 : 1;
+                side[3 * k + 2] = fz - cz < 0.5 ? -1 : 1;
+                uint64_t key = cellKey(cx, cy, cz);
+                size_t slot = find(key);
+                if (keys[slot] == EMPTY) { keys[slot] = key; head[slot] = -1; }
+                next[k] = head[slot];
+                head[slot] = (int32_t)k;
+            }
+
+            for (size_t k = 0; k < m; k++) {
+                uint32_t a = active[k];
+                for (int d = 0; d < 8; d++) {
+                    uint64_t key = cellKey(cell[3 * k] + (d & 1 ? side[3 * k] : 0),
+                                           cell[3 * k + 1] + (d & 2 ? side[3 * k + 1] : 0),
+                                           cell[3 * k + 2] + (d & 4 ? side[3 * k + 2] : 0));
+                    size_t slot = find(key);
+                    if (keys[slot] == EMPTY) continue;
+                    for (int32_t q = head[slot]; q >= 0; q = next[q]) {
+                        if (q <= (int32_t)k) continue;
+                        uint32_t b = active[q];
+                        if (!shellsOverlap(a, b)) continue;
+                        checks++;
+                        double dx = x[a] - x[b], dy = y[a] - y[b], dz = z[a] - z[b];
+                        double d2 = dx * dx + dy * dy + dz * dz;
+                        if (d2 < R2) hits.push_back({(uint64_t)std::min(a, b) << 32 | std::max(a, b), (uint32_t)s, (float)d2});
+                    }
+                }
+            }
+        }
+        blockChecks[block] = checks;
+    }
+
+    double timeOf(size_t s) const { return std::fmin(firstTime + s * step, lastTime); }
+
+    // --- STAGE 3: TCA per local minimum of each pair's sampled distance ---
+    void refine(std::vector<Hit>& hits, std::vector<Conjunction>& out) {
+        std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) {
+            return a.pair != b.pair ? a.pair < b.pair : a.step < b.step;
+        });
+        for (size_t k = 0; k < hits.size(); k++) {
+            const Hit& h = hits[k];
+            // Neighbours outside the run were farther than R, i.e. farther than h
+            bool prevCloser = k > 0 && hits[k - 1].pair == h.pair && hits[k - 1].step + 1 == h.step && hits[k - 1].dist2 < h.dist2;
+            bool nextCloser = k + 1 < hits.size() && hits[k + 1].pair == h.pair && hits[k + 1].step == h.step + 1 && hits[k + 1].dist2 <= h.dist2;
+            if (prevCloser || nextCloser) continue;
+
+            uint32_t a = (uint32_t)(h.pair >> 32), b = (uint32_t)h.pair;
+            double lo = std::fmax(firstTime, timeOf(h.step) - step), hi = std::fmin(lastTime, timeOf(h.step) + step);
+            st.refinements++;
+            double tca = closestApproach(a, b, lo, timeOf(h.step), hi);
+            double d = (batch.position(a, tca) - batch.position(b, tca)).magnitude();
+            if (d > threshold) continue;
+
+            // Skip a duplicate of the same encounter from a flat-bottomed run
+            if (!out.empty() && out.back().a == (int)a && out.back().b == (int)b && std::fabs(out.back().tca - tca) < step) continue;
+
+            const double DT = 0.5;
+            Vector3 va = (batch.position(a, tca + DT) - batch.position(a, tca - DT)) * (1.0 / (2 * DT));
+            Vector3 vb = (batch.position(b, tca + DT) - batch.position(b, tca - DT)) * (1.0 / (2 * DT));
+            out.push_back({(int)a, (int)b, tca, d, (va - vb).magnitude()});
+        }
+    }
+
+    double dist2(uint32_t a, uint32_t b, double t) const {
+        Vector3 d = batch.position(a, t) - batch.position(b, t);
+        return d.dot(d);
+    }
+
+    // Brent's method on |ra - rb|^2 over [lo, hi] starting from the sampled
+    // minimum at tk, to 1 ms. d^2 is close to a parabola around a fly-by,
+    // so the parabolic steps converge in a handful of evaluations.
+    double closestApproach(uint32_t a, uint32_t b, double lo, double tk, double hi) const {
+        const double CGOLD = 0.3819660112501051, TOL = 1e-3;
+        double x = tk, w = tk, v = tk;
+        double fx = dist2(a, b, x), fw = fx, fv = fx;
+        double d = 0, e = 0;
+        for (int it = 0; it < 100; it++) {
+            double xm = 0.5 * (lo + hi);
+            if (std::fabs(x - xm) <= 2 * TOL - 0.5 * (hi - lo)) break;
+            bool golden = true;
+            if (std::fabs(e) > TOL) {
+                double r = (x - w) * (fx - fv), q = (x - v) * (fx - fw), p = (x - v) * q - (x - w) * r;
+                q = 2 * (q - r);
+                if (q > 0) p = -p;
+                q = std::fabs(q);
+                if (std::fabs(p) < std::fabs(0.5 * q * e) && p > q * (lo - x) && p < q * (hi - x)) {
+                    e = d;
+                    d = p / q;
+                    double u = x + d;
+                    if (u - lo < 2 * TOL || hi - u < 2 * TOL) d = xm > x ? TOL : -TOL;
+                    golden = false;
+                }
+            }
+            if (golden) { e = (x >= xm ? lo : hi) - x; d = CGOLD * e; }
+            double u = std::fabs(d) >= TOL ? x + d : x + (d > 0 ? TOL : -TOL);
+            double fu = dist2(a, b, u);
+            if (fu <= fx) {
+                if (u >= x) lo = x; else hi = x;
+                v = w; fv = fw; w = x; fw = fx; x = u; fx = fu;
+            } else {
+                if (u < x) lo = u; else hi = u;
+                if (fu <= fw || w == x) { v = w; fv = fw; w = u; fw = fu; }
+                else if (fu <= fv || v == x || v == w) { v = u; fv = fu; }
+            }
+        }
+        return x;
+    }
+
+    const KeplerBatch& batch;
+    double threshold, step;
+    double R = 0;
+    double firstTime = 0, lastTime = 0;
+    size_t steps = 0;
+    std::vector<uint32_t> active;
+    std::vector<std::vector<Hit>> blockHits;
+    std::vector<uint64_t> blockChecks;
+    ConjunctionStats st;
+};
@@ -0,0 +1,242 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// ============================================================================
+// CoverageMap: constellation coverage statistics on a lat/lon grid.
+//
+// The grid is equirectangular like earth.jpg: row 0 is the north edge and
+// column 0 is lon -180. A cell counts as covered at a time step when some
+// satellite is at least `minElevation` above the horizon seen from the
+// cell centre (spherical Earth). For each cell, over [t0, t1]:
+//
+//   accessTime   total covered seconds
+//   maxGap       longest uncovered stretch (counting the window edges)
+//   meanGap      mean uncovered stretch, i.e. the mean revisit time
+//   accesses     number of separate coverage intervals
+//
+// No cell is tested against every satellite. A satellite covers a
+// spherical cap of half-angle lambda = acos(R cos e / r) - e around its
+// sub-satellite point. For each grid row inside the cap, the covered
+// longitudes form one interval, |dlon| <= acos((cos lambda - sin phi sin
+// phi_s) / (cos phi cos phi_s)). Each interval is one +1/-1 pair in a
+// per-row difference array. A prefix sum over the row then gives the
+// covered/uncovered state of every cell, and the cell statistics advance
+// in the same sweep. Rows are split into tiles that run in parallel on a
+// WorkStealingPool; each tile owns its difference rows, so nothing is
+// shared.
+//
+// Times are sampled every `step` seconds, so interval edges (and the
+// gaps) are good to one step.
+// ============================================================================
+
+class CoverageMap {
+public:
+    // Fills ECI positions [m] of all satellites at time t
+    using PositionsFn = std::function<void(double t, double* x, double* y, double* z)>;
+
+    enum class Metric { AccessTime, MaxGap, MeanGap, Accesses };
+
+    int rows = 0, cols = 0;
+    double cellDeg = 1.0;
+    double minElevation = 10.0;     // deg
+    double theta0 = 0.0;            // Earth rotation angle at t = 0 [rad]
+    double t0 = 0, t1 = 0;          // window of the last compute()
+
+    std::vector<float> accessTime, maxGap, meanGap;
+    std::vector<uint32_t> accesses;
+
+    CoverageMap(double cellSizeDeg, double minElevationDeg, double earthAngle0 = 0.0)
+        : cellDeg(cellSizeDeg), minElevation(minElevationDeg), theta0(earthAngle0) {
+        rows = (int)std::lround(180.0 / cellDeg);
+        cols = (int)std::lround(360.0 / cellDeg);
+    }
+
+    size_t cells() const { return (size_t)rows * cols; }
+    double cellLat(int row) const { return 90.0 - (row + 0.5) * cellDeg; }
+    double cellLon(int col) const { return -180.0 + (col + 0.5) * cellDeg; }
+
+    // Coverage of n satellites from t0 to t1 (inclusive) every `step` seconds
+    void compute(size_t n, const PositionsFn& positions, double tStart, double tEnd, double step,
+                 WorkStealingPool* pool = nullptr) {
+        t0 = tStart; t1 = tEnd;
+        size_t N = cells();
+        accessTime.assign(N, 0.0f); maxGap.assign(N, 0.0f); meanGap.assign(N, 0.0f);
+        accesses.assign(N, 0);
+        gapSum.assign(N, 0.0f); gapCount.assign(N, 0);
+        lastChange.assign(N, (float)0.0f);
+        covered.assign(N, 0);
+
+        const int TILE_ROWS = 8;
+        int tiles = (rows + TILE_ROWS - 1) / TILE_ROWS;
+        diff.assign((size_t)tiles * TILE_ROWS * (cols + 1), 0);
+        std::vector<double> x(n), y(n), z(n);
+        sats.resize(n);
+        rowSin.resize(rows); rowCos.resize(rows);
+        for (int r = 0; r < rows; r++) {
+            rowSin[r] = std::sin(cellLat(r) * M_PI / 180.0);
+            rowCos[r] = std::cos(cellLat(r) * M_PI / 180.0);
+        }
+
+        long steps = (long)std::floor((tEnd - tStart) / step + 1e-9) + 1;
+        double eps = minElevation * M_PI / 180.0;
+        for (long s = 0; s < steps; s++) {
+            double t = tStart + s * step;
+            positions(t, x.data(), y.data(), z.data());
+
+            // Sub-satellite points and footprint half-angles (Earth-fixed)
+            double th = theta0 + EARTH_ROTATION_SPEED * t;
+            for (size_t i = 0; i < n; i++) {
+                double r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+                Footprint& f = sats[i];
+                f.lambda = r > R_EARTH ? std::acos(R_EARTH * std::cos(eps) / r) - eps : -1.0;
+                if (f.lambda <= 0) continue;
+                f.lat = std::asin(z[i] / r);
+                f.lon = std::remainder(std::atan2(y[i], x[i]) - th, 2 * M_PI);
+                f.sinLat = std::sin(f.lat); f.cosLat = std::cos(f.lat);
+                f.cosLambda = std::cos(f.lambda);
+            }
+
+            float tf = (float)(t - tStart);
+            auto tileFn = [&](size_t begin, size_t end) {
+                for (size_t tile = begin; tile < end; tile++) {
+                    int r0 = (int)tile * TILE_ROWS, r1 = std::min(rows, r0 + TILE_ROWS);
+                    int* d = &diff[tile * TILE_ROWS * (cols + 1)];
+                    markTile(n, r0, r1, d);
+                    for (int r = r0; r < r1; r++) sweepRow(r, d + (r - r0) * (cols + 1), tf);
+                }
+            };
+            if (pool) pool->parallelFor(tiles, 1, tileFn);
+            else tileFn(0, tiles);
+        }
+
+        // Close the open intervals at the end of the window
+        float tEndF = (float)((steps - 1) * step);
+        for (size_t c = 0; c < N; c++) {
+            if (covered[c]) accessTime[c] += tEndF - lastChange[c];
+            else addGap(c, tEndF - lastChange[c]);
+            meanGap[c] = gapCount[c] ? gapSum[c] / gapCount[c] : 0.0f;
+        }
+    }
+
+    float value(Metric m, size_t c) const {
+        switch (m) {
+            case Metric::AccessTime: return accessTime[c];
+            case Metric::MaxGap:     return maxGap[c];
+            case Metric::MeanGap:    return meanGap[c];
+            case Metric::Accesses:   return (float)accesses[c];
+        }
+        return 0;
+    }
+    static const char* metricName(Metric m) {
+        switch (m) {
+            case Metric::AccessTime: return "access time";
+            case Metric::MaxGap:     return "max gap";
+            case Metric::MeanGap:    return "mean revisit";
+            case Metric::Accesses:   return "accesses";
+        }
+        return "";
+    }
+
+    // RGBA overlay (rows x cols, row 0 north), blue = low .. red = high,
+    // scaled to the largest value; returns that value
+    float colorize(Metric m, std::vector<uint8_t>& rgba, uint8_t alpha = 140) const {
+        float hi = 0;
+        for (size_t c = 0; c < cells(); c++) hi = std::max(hi, value(m, c));
+        rgba.resize(cells() * 4);
+        for (size_t c = 0; c < cells(); c++) {
+            float v = hi > 0 ? value(m, c) / hi : 0.0f;
+            // blue -> cyan -> green -> yellow -> red
+            float r = std::clamp(4 * v - 2, 0.0f, 1.0f);
+            float g = v < 0.75f ? std::clamp(4 * v, 0.0f, 1.0f) : std::clamp(4 - 4 * v, 0.0f, 1.0f);
+            float b = std::clamp(2 - 4 * v, 0.0f, 1.0f);
+            rgba[c * 4] = (uint8_t)(255 * r);
+            rgba[c * 4 + 1] = (uint8_t)(255 * g);
+            rgba[c * 4 + 2] = (uint8_t)(255 * b);
+            rgba[c * 4 + 3] = alpha;
+        }
+        return hi;
+    }
+
+private:
+    struct Footprint {
+        double lat, lon, sinLat, cosLat;
+        double lambda = -1, cosLambda;      // cap half-angle [rad], <= 0: no footprint
+    };
+
+    // +1/-1 at the ends of every covered interval in rows [r0, r1)
+    void markTile(size_t n, int r0, int r1, int* d) const {
+        const double CELL = cellDeg * M_PI / 180.0;
+        double latTop = (90.0 - r0 * cellDeg) * M_PI / 180.0, latBottom = (90.0 - r1 * cellDeg) * M_PI / 180.0;
+        for (size_t i = 0; i < n; i++) {
+            const Footprint& f = sats[i];
+            if (f.lambda <= 0 || f.lat - f.lambda > latTop || f.lat + f.lambda < latBottom) continue;
+            // Rows whose centre latitude is within lambda of the sub-satellite point
+            int ra = std::max(r0, (int)std::floor((M_PI / 2 - (f.lat + f.lambda)) / CELL - 0.5));
+            int rb = std::min(r1 - 1, (int)std::ceil((M_PI / 2 - (f.lat - f.lambda)) / CELL - 0.5));
+            for (int r = ra; r <= rb; r++) {
+                int* row = d + (r - r0) * (cols + 1);
+                double den = rowCos[r] * f.cosLat;
+                double cosD = den > 1e-12 ? (f.cosLambda - rowSin[r] * f.sinLat) / den : (rowSin[r] * f.sinLat >= f.cosLambda ? -2 : 2);
+                if (cosD >= 1) continue;                            // row outside the cap
+                if (cosD <= -1) { row[0]++; row[cols]--; continue; } // whole row (cap over the pole)
+                double half = std::acos(cosD);
+                // Columns whose centre lon is in [lon - half, lon + half]
+                double a = (f.lon - half + M_PI) / CELL - 0.5, b = (f.lon + half + M_PI) / CELL - 0.5;
+                int ca = (int)std::ceil(a), cb = (int)std::floor(b);
+                if (cb < ca) continue;
+                if (cb - ca + 1 >= cols) { row[0]++; row[cols]--; continue; }
+                addInterval(row, ca, cb);
+            }
+        }
+    }
+
+    // [ca, cb] modulo cols, as one or two runs
+    void addInterval(int* row, int ca, int cb) const {
+        ca = ((ca % cols) + cols) % cols;
+        cb = ((cb % cols) + cols) % cols;
+        if (ca <= cb) { row[ca]++; row[cb + 1]--; }
+        else { row[ca]++; row[cols]--; row[0]++; row[cb + 1]--; }
+    }
+
+    // Prefix-sum one row, advance its cells' statistics, clear the row
+    void sweepRow(int r, int* d, float t) {
+        size_t base = (size_t)r * cols;
+        int run = 0;
+        for (int c = 0; c < cols; c++) {
+            run += d[c];
+            d[c] = 0;
+            size_t k = base + c;
+            bool now = run > 0;
+            if (now == (bool)covered[k]) continue;
+            if (now) {
+                addGap(k, t - lastChange[k]);
+                accesses[k]++;
+            } else {
+                accessTime[k] += t - lastChange[k];
+            }
+            lastChange[k] = t;
+            covered[k] = now;
+        }
+        d[cols] = 0;
+    }
+
+    void addGap(size_t k, float gap) {
+        if (gap <= 0) return;
+        gapSum[k] += gap;
+        gapCount[k]++;
+        maxGap[k] = std::max(maxGap[k], gap);
+    }
+
+    std::vector<Footprint> sats;
+    std::vector<double> rowSin, rowCos;
+    std::vector<int> diff;                  // [tile][row in tile][cols + 1]
+    std::vector<float> gapSum, lastChange;  // lastChange: s since t0
+    std::vector<uint32_t> gapCount;
+    std::vector<uint8_t> covered;
+};
@@ -0,0 +1,343 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "force_models.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// DebrisCloud: fragmentation events as a particle system (10^5..10^6
+// fragments).
+//
+// Fragments are not Satellite objects: every field is one contiguous array
+// (x, y, z, vx, vy, vz, mass, and the last acceleration ax, ay, az), and a
+// step is a handful of flat passes over those arrays:
+//
+//   kick + drift      v += a h/2, r += v h
+//   accelerations     Earth (+ J2) (+ Sun/Moon) per particle, branch-free,
+//                     so the loop vectorizes; Sun and Moon positions are
+//                     evaluated once per step, not per fragment
+//   mutual gravity    optional, Barnes-Hut (below), added on top
+//   kick              v += a h/2
+//
+// i.e. kick-drift-kick leapfrog: symplectic, one force evaluation per step,
+// the acceleration carried to the next step. Passes run in parallel chunks
+// on a WorkStealingPool when one is given. GCC needs -fno-math-errno (as
+// well as -fno-trapping-math) before it vectorizes loops with sqrt.
+//
+// BarnesHut: octree over the fragments, rebuilt each step. Nodes live in
+// one vector with the 8 children of a node stored together; particles are
+// partitioned in place by octant (counting sort of an index array) and
+// copied into tree order, so a leaf is a contiguous run of positions.
+// A node of size s at distance d from the particle is taken as a point mass
+// at its centre of mass when s/d < theta and the particle is outside it;
+// Plummer softening keeps close pairs (and the self term) finite.
+//
+// breakup() spawns fragments around a parent state: isotropic directions,
+// log-normal delta-v, power-law masses (cumulative N(>m) ~ m^-0.75, as in
+// the NASA breakup model) normalised to the parent mass. Fragments that
+// fall below decayAltitude are dropped by swapping in the last one.
+// ============================================================================
+
+struct DebrisOptions {
+    bool j2 = true;
+    bool sunMoon = false;
+    bool mutual = false;            // fragment-fragment gravity (Barnes-Hut)
+    double theta = 0.5;             // opening angle
+    double softening = 1.0;         // m
+    double decayAltitude = 100e3;   // m above R_EARTH
+    double jd0 = 2460310.5;         // JD at t = 0 (Sun/Moon)
+};
+
+class BarnesHut {
+public:
+    static const int LEAF_SIZE = 8;
+    static const int MAX_DEPTH = 40;
+
+    struct Node {
+        double cx, cy, cz, half;        // cube
+        double mx, my, mz, mass;        // centre of mass
+        uint32_t child;                 // first of 8 children, 0 = leaf
+        uint32_t begin, end;            // particle range in tree order
+    };
+
+    void build(const double* x, const double* y, const double* z, const double* m, size_t n) {
+        nodes.clear();
+        order.resize(n);
+        scratch.resize(n);
+        for (size_t i = 0; i < n; i++) order[i] = (uint32_t)i;
+        maxDepth = 0;
+        if (n == 0) return;
+
+        double lo[3] = {x[0], y[0], z[0]}, hi[3] = {x[0], y[0], z[0]};
+        for (size_t i = 1; i < n; i++) {
+            lo[0] = std::min(lo[0], x[i]); hi[0] = std::max(hi[0], x[i]);
+            lo[1] = std::min(lo[1], y[i]); hi[1] = std::max(hi[1], y[i]);
+            lo[2] = std::min(lo[2], z[i]); hi[2] = std::max(hi[2], z[i]);
+        }
+        double half = 0.5 * std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]}) * (1 + 1e-9) + 1e-6;
+        nodes.reserve(2 * n / LEAF_SIZE + 8);
+        nodes.push_back({0.5 * (lo[0] + hi[0]), 0.5 * (lo[1] + hi[1]), 0.5 * (lo[2] + hi[2]), half,
+                         0, 0, 0, 0, 0, 0, (uint32_t)n});
+        split(0, x, y, z, m, 0);
+
+        px.resize(n); py.resize(n); pz.resize(n); pm.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            uint32_t i = order[k];
+            px[k] = x[i]; py[k] = y[i]; pz[k] = z[i]; pm[k] = G * m[i];
+        }
+    }
+
+    // Adds the tree's pull on a particle at (x, y, z)
+    void accumulate(double x, double y, double z, double theta, double softening,
+                    double& ax, double& ay, double& az) const {
+        if (nodes.empty()) return;
+        double theta2 = theta * theta, eps2 = softening * softening;
+        uint32_t stack[7 * MAX_DEPTH + 8];
+        int sp = 0;
+        stack[sp++] = 0;
+        while (sp > 0) {
+            const Node& nd = nodes[stack[--sp]];
+            if (nd.mass == 0) continue;
+            double dx = nd.mx - x, dy = nd.my - y, dz = nd.mz - z;
+            double d2 = dx * dx + dy * dy + dz * dz;
+            bool inside = std::fabs(x - nd.cx) <= nd.half && std::fabs(y - nd.cy) <= nd.half &&
+                          std::fabs(z - nd.cz) <= nd.half;
+            if (!inside && 4 * nd.half * nd.half < theta2 * d2) {
+                double inv = 1.0 / std::sqrt(d2 + eps2), f = G * nd.mass * inv * inv * inv;
+                ax += f * dx; ay += f * dy; az += f * dz;
+            } else if (nd.child == 0) {
+                for (uint32_t k = nd.begin; k < nd.end; k++) {
+                    double ex = px[k] - x, ey = py[k] - y, ez = pz[k] - z;
+                    double inv = 1.0 / std::sqrt(ex * ex + ey * ey + ez * ez + eps2), f = pm[k] * inv * inv * inv;
+                    ax += f * ex; ay += f * ey; az += f * ez;
+                }
+            } else {
+                for (uint32_t c = 0; c < 8; c++) stack[sp++] = nd.child + c;
+            }
+        }
+    }
+
+    size_t nodeCount() const { return nodes.size(); }
+    int depth() const { return maxDepth; }
+    size_t bytes() const {
+        return nodes.capacity() * sizeof(Node) + (order.capacity() + scratch.capacity()) * sizeof(uint32_t) +
+               (px.capacity() + py.capacity() + pz.capacity() + pm.capacity()) * sizeof(double);
+    }
+
+private:
+    void split(uint32_t at, const double* x, const double* y, const double* z, const double* m, int level) {
+        maxDepth = std::max(maxDepth, level);
+        Node nd = nodes[at];
+        if (nd.end - nd.begin <= (uint32_t)LEAF_SIZE || level >= MAX_DEPTH) {
+            double sx = 0, sy = 0, sz = 0, sm = 0;
+            for (uint32_t k = nd.begin; k < nd.end; k++) {
+                uint32_t i = order[k];
+                sx += m[i] * x[i]; sy += m[i] * y[i]; sz += m[i] * z[i]; sm += m[i];
+            }
+            Node& leaf = nodes[at];
+            leaf.mass = sm;
+            if (sm > 0) { leaf.mx = sx / sm; leaf.my = sy / sm; leaf.mz = sz / sm; }
+            return;
+        }
+
+        // Counting sort of the range by octant
+        uint32_t count[8] = {0}, start[8];
+        auto octant = [&](uint32_t i) {
+            return (x[i] > nd.cx ? 1u : 0u) | (y[i] > nd.cy ? 2u : 0u) | (z[i] > nd.cz ? 4u : 0u);
+        };
+        for (uint32_t k = nd.begin; k < nd.end; k++) count[octant(order[k])]++;
+        start[0] = nd.begin;
+        for (int c = 1; c < 8; c++) start[c] = start[c - 1] + count[c - 1];
+        uint32_t fill[8];
+        std::copy(start, start + 8, fill);
+        for (uint32_t k = nd.begin; k < nd.end; k++) scratch[fill[octant(order[k])]++] = order[k];
+        std::copy(scratch.begin() + nd.begin, scratch.begin() + nd.end, order.begin() + nd.begin);
+
+        uint32_t first = (uint32_t)nodes.size();
+        nodes[at].child = first;
+        double q = 0.5 * nd.half;
+        for (uint32_t c = 0; c < 8; c++) {
+            nodes.push_back({nd.cx + (c & 1 ? q : -q), nd.cy + (c & 2 ? q : -q), nd.cz + (c & 4 ? q : -q), q,
+                             0, 0, 0, 0, 0, start[c], start[c] + count[c]});
+        }
+        double sx = 0, sy = 0, sz = 0, sm = 0;
+        for (uint32_t c = 0; c < 8; c++) {
+            if (count[c] == 0) continue;
+            split(first + c, x, y, z, m, level + 1);
+            const Node& ch = nodes[first + c];
+            sx += ch.mass * ch.mx; sy += ch.mass * ch.my; sz += ch.mass * ch.mz; sm += ch.mass;
+        }
+        Node& self = nodes[at];
+        self.mass = sm;
+        if (sm > 0) { self.mx = sx / sm; self.my = sy / sm; self.mz = sz / sm; }
+    }
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> order, scratch;
+    std::vector<double> px, py, pz, pm;     // tree order, pm = G m
+    int maxDepth = 0;
+};
+
+class DebrisCloud {
+public:
+    static const size_t GRAIN = 4096;
+
+    std::vector<double> x, y, z, vx, vy, vz, mass;
+
+    size_t size() const { return x.size(); }
+    const BarnesHut& tree() const { return octree; }
+
+    // `count` fragments from a parent at (pos, vel) of `parentMass` kg;
+    // median delta-v `deltaV` m/s. Returns the index of the first one.
+    size_t breakup(const Vector3& pos, const Vector3& vel, size_t count, double parentMass, double deltaV,
+                   uint64_t seed) {
+        size_t first = size(), n = first + count;
+        for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &mass, &ax, &ay, &az}) v->resize(n);
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<double> U(0.0, 1.0);
+        std::normal_distribution<double> N(0.0, 1.0);
+        double total = 0;
+        for (size_t i = first; i < n; i++) {
+            double cz = 2 * U(rng) - 1, phi = 2 * M_PI * U(rng), sz = std::sqrt(1 - cz * cz);
+            double dv = deltaV * std::exp(0.5 * N(rng));
+            x[i] = pos.x; y[i] = pos.y; z[i] = pos.z;
+            vx[i] = vel.x + dv * sz * std::cos(phi);
+            vy[i] = vel.y + dv * sz * std::sin(phi);
+            vz[i] = vel.z + dv * cz;
+            mass[i] = std::pow(1.0 - U(rng), -1.0 / 0.75);
+            total += mass[i];
+        }
+        for (size_t i = first; i < n; i++) mass[i] *= parentMass / total;
+        accelValid = false;
+        return first;
+    }
+
+    // One leapfrog step from t to t + h
+    void step(double t, double h, const DebrisOptions& opt, WorkStealingPool* pool = nullptr) {
+        if (!accelValid || !sameModel(opt, lastOptions)) accelerations(t, opt, pool);
+        forEach(pool, [&](size_t b, size_t e) { kickDrift(b, e, h); });
+        accelerations(t + h, opt, pool);
+        forEach(pool, [&](size_t b, size_t e) { kick(b, e, 0.5 * h); });
+    }
+
+    // Drop fragments below decayAltitude; returns how many went
+    size_t removeDecayed(const DebrisOptions& opt) {
+        double floor2 = (R_EARTH + opt.decayAltitude) * (R_EARTH + opt.decayAltitude);
+        size_t removed = 0;
+        for (size_t i = 0; i < size();) {
+            if (x[i] * x[i] + y[i] * y[i] + z[i] * z[i] >= floor2) { i++; continue; }
+            for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &mass, &ax, &ay, &az}) {
+                (*v)[i] = v->back();
+                v->pop_back();
+            }
+            removed++;
+        }
+        return removed;
+    }
+
+    // Two-body specific energy summed over the cloud (drift check)
+    double orbitalEnergy() const {
+        double e = 0;
+        for (size_t i = 0; i < size(); i++) {
+            double r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            e += 0.5 * (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]) - MU_EARTH / r;
+        }
+        return e;
+    }
+
+    // Resident bytes per fragment: the 10 SoA arrays, plus the octree when
+    // mutual gravity has been used
+    double bytesPerParticle() const {
+        if (size() == 0) return 0;
+        size_t arrays = 0;
+        for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &mass, &ax, &ay, &az}) arrays += v->capacity() * sizeof(double);
+        return double(arrays + octree.bytes()) / size();
+    }
+
+private:
+    template <class Fn>
+    void forEach(WorkStealingPool* pool, Fn fn) {
+        if (pool) pool->parallelFor(size(), GRAIN, fn);
+        else fn(0, size());
+    }
+
+    static bool sameModel(const DebrisOptions& a, const DebrisOptions& b) {
+        return a.j2 == b.j2 && a.sunMoon == b.sunMoon && a.mutual == b.mutual;
+    }
+
+    void accelerations(double t, const DebrisOptions& opt, WorkStealingPool* pool) {
+        Vector3 sun = {0, 0, 0}, moon = {0, 0, 0};
+        if (opt.sunMoon) {
+            double jd = opt.jd0 + t / 86400.0;
+            sun = sunPosition(jd);
+            moon = moonPosition(jd);
+        }
+        forEach(pool, [&](size_t b, size_t e) { external(b, e, opt, sun, moon); });
+        if (opt.mutual) {
+            octree.build(x.data(), y.data(), z.data(), mass.data(), size());
+            forEach(pool, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; i++) octree.accumulate(x[i], y[i], z[i], opt.theta, opt.softening, ax[i], ay[i], az[i]);
+            });
+        }
+        lastOptions = opt;
+        accelValid = true;
+    }
+
+    // Earth (+ J2) (+ Sun/Moon) for [b, e), written to ax/ay/az
+    void external(size_t b, size_t e, const DebrisOptions& opt, const Vector3& sun, const Vector3& moon) {
+        const double* __restrict px = x.data(); const double* __restrict py = y.data(); const double* __restrict pz = z.data();
+        double* __restrict gx = ax.data(); double* __restrict gy = ay.data(); double* __restrict gz = az.data();
+        // a_J2 = -3/2 J2 mu R^2 / r^5 * [x (1 - 5 s^2), y (1 - 5 s^2), z (3 - 5 s^2)],  s = z/r
+        const double j2 = opt.j2 ? 1.5 * ZONAL_J[2] * MU_EARTH * EGM_RADIUS * EGM_RADIUS : 0.0;
+        for (size_t i = b; i < e; i++) {
+            double r2 = px[i] * px[i] + py[i] * py[i] + pz[i] * pz[i];
+            double inv2 = 1.0 / r2, inv = std::sqrt(inv2);
+            double k = -MU_EARTH * inv2 * inv;
+            double s2 = pz[i] * pz[i] * inv2, kj = -j2 * inv2 * inv2 * inv;
+            gx[i] = px[i] * (k + kj * (1 - 5 * s2));
+            gy[i] = py[i] * (k + kj * (1 - 5 * s2));
+            gz[i] = pz[i] * (k + kj * (3 - 5 * s2));
+        }
+        if (opt.sunMoon) {
+            for (const auto& body : {std::make_pair(sun, MU_SUN), std::make_pair(moon, MU_MOON)}) {
+                // Perturbing pull relative to the (also accelerated) Earth
+                const Vector3& q = body.first;
+                double mu = body.second, b2 = q.dot(q), k0 = mu / (b2 * std::sqrt(b2));
+                for (size_t i = b; i < e; i++) {
+                    double dx = q.x - px[i], dy = q.y - py[i], dz = q.z - pz[i];
+                    double d2 = dx * dx + dy * dy + dz * dz, k = mu / (d2 * std::sqrt(d2));
+                    gx[i] += k * dx - k0 * q.x;
+                    gy[i] += k * dy - k0 * q.y;
+                    gz[i] += k * dz - k0 * q.z;
+                }
+            }
+        }
+    }
+
+    void kickDrift(size_t b, size_t e, double h) {
+        double* __restrict px = x.data(); double* __restrict py = y.data(); double* __restrict pz = z.data();
+        double* __restrict qx = vx.data(); double* __restrict qy = vy.data(); double* __restrict qz = vz.data();
+        const double* __restrict gx = ax.data(); const double* __restrict gy = ay.data(); const double* __restrict gz = az.data();
+        double half = 0.5 * h;
+        for (size_t i = b; i < e; i++) {
+            qx[i] += half * gx[i]; qy[i] += half * gy[i]; qz[i] += half * gz[i];
+            px[i] += h * qx[i]; py[i] += h * qy[i]; pz[i] += h * qz[i];
+        }
+    }
+
+    void kick(size_t b, size_t e, double half) {
+        double* __restrict qx = vx.data(); double* __restrict qy = vy.data(); double* __restrict qz = vz.data();
+        const double* __restrict gx = ax.data(); const double* __restrict gy = ay.data(); const double* __restrict gz = az.data();
+        for (size_t i = b; i < e; i++) { qx[i] += half * gx[i]; qy[i] += half * gy[i]; qz[i] += half * gz[i]; }
+    }
+
+    std::vector<double> ax, ay, az;
+    BarnesHut octree;
+    DebrisOptions lastOptions;
+    bool accelValid = false;
+};
@@ -0,0 +1,231 @@
+#pragma once
+#include "view_transform.hpp"
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// EarthLod: the earth's dot mesh as an icosphere with levels of detail,
+// culled per tile before any per-point work.
+//
+// The old 5 deg lat/lon grid put as many points on the last ring around a
+// pole as on the equator, and every point was transformed every frame,
+// back hemisphere included. Here:
+//
+//   levels   icosphere subdivisions MIN_LEVEL..MAX_LEVEL (642 .. 163842
+//            points), evenly spaced; each level's vertices are the previous
+//            level's plus the new edge midpoints, so they nest
+//   tiles    the 20 * 4^TILE_LEVEL faces of subdivision TILE_LEVEL; every
+//            vertex belongs to one tile, and each level stores its points
+//            sorted by tile (tile t = a contiguous range at every level).
+//            A tile is bounded by a cone: axis + half-angle over its points
+//
+// Per frame update() tests each tile's cone against the horizon seen from
+// the camera (a point with normal n is in front iff n . c_hat > R / |c|)
+// and its bounding sphere against the screen rectangle. The point count of
+// the surviving tiles is known per level without touching a point, so it
+// picks the finest level that fits `pointBudget`: zoomed out the whole
+// visible hemisphere at a coarse level, zoomed in the few tiles left on
+// screen at a fine one, about the same number of points either way. Only
+// then are that level's points in the visible tiles copied out (with the
+// exact per-point horizon test) into one compact PointCloud for
+// ViewTransform::project().
+//
+// The model matrix of the view must be a rotation (the earth spin); the
+// mesh is generated at `radius` in model units.
+// ============================================================================
+
+class EarthLod {
+public:
+    static const int MIN_LEVEL = 3, MAX_LEVEL = 7, TILE_LEVEL = 3;
+    static const size_t DEFAULT_BUDGET = 5000;
+
+    explicit EarthLod(double radius, size_t pointBudget = DEFAULT_BUDGET) : radius(radius), budget(pointBudget) {
+        build();
+    }
+
+    // Cull tiles, pick the level, gather its visible points; screen is
+    // width x height pixels
+    const PointCloud& update(const ViewTransform& view, double width, double height) {
+        double cx, cy, cz;
+        view.cameraInModel(cx, cy, cz);
+        double dist = std::sqrt(cx * cx + cy * cy + cz * cz);
+        visible.clear();
+        for (auto* v : {&out.x, &out.y, &out.z, &out.nx, &out.ny, &out.nz}) v->clear();
+        if (dist <= radius) return out;
+        double ux = cx / dist, uy = cy / dist, uz = cz / dist;
+        horizon = radius / dist;                         // cos of the horizon angle
+        double horizonSin = std::sqrt(1 - horizon * horizon);
+
+        size_t count[MAX_LEVEL + 1] = {0};
+        for (uint32_t t = 0; t < tiles.size(); t++) {
+            const Tile& tile = tiles[t];
+            // Horizon: hidden if even the cone's closest direction is past
+            // it, angle(axis, c) > horizon + half-angle
+            double c = tile.ax * ux + tile.ay * uy + tile.az * uz;
+            if (c < horizon * tile.cosHalf - horizonSin * tile.sinHalf) continue;
+            // Screen: bounding sphere of the cap (centre R cos a on the axis, radius R sin a)
+            double ca = tile.cosHalf, rs = radius * tile.sinHalf;
+            float sx, sy;
+            double w;
+            view.projectPoint(radius * ca * tile.ax, radius * ca * tile.ay, radius * ca * tile.az, sx, sy, &w);
+            double depth = view.camDist - w - rs;
+            if (depth > 0) {
+                double r = rs * view.focal / depth;
+                if (sx + r < 0 || sx - r > width || sy + r < 0 || sy - r > height) continue;
+            }
+            visible.push_back(t);
+            for (int l = MIN_LEVEL; l <= MAX_LEVEL; l++) count[l] += tileStart[l][t + 1] - tileStart[l][t];
+        }
+        chosen = MIN_LEVEL;
+        for (int l = MIN_LEVEL + 1; l <= MAX_LEVEL; l++) if (count[l] <= budget) chosen = l;
+
+        // Gather; tiles are in subdivision order, so neighbours merge into runs
+        const PointCloud& mesh = levels[chosen];
+        const std::vector<uint32_t>& start = tileStart[chosen];
+        float fx = (float)ux, fy = (float)uy, fz = (float)uz, fh = (float)horizon;
+        for (size_t k = 0; k < visible.size();) {
+            uint32_t first = visible[k], last = first;
+            while (k + 1 < visible.size() && visible[k + 1] == last + 1) last = visible[++k];
+            k++;
+            for (uint32_t i = start[first]; i < start[last + 1]; i++) {
+                if (mesh.nx[i] * fx + mesh.ny[i] * fy + mesh.nz[i] * fz <= fh) continue;
+                out.x.push_back(mesh.x[i]); out.y.push_back(mesh.y[i]); out.z.push_back(mesh.z[i]);
+                out.nx.push_back(mesh.nx[i]); out.ny.push_back(mesh.ny[i]); out.nz.push_back(mesh.nz[i]);
+            }
+        }
+        return out;
+    }
+
+    int level() const { return chosen; }
+    size_t tileCount() const { return tiles.size(); }
+    size_t visibleTiles() const { return visible.size(); }
+    const PointCloud& levelPoints(int l) const { return levels[l]; }
+    const PointCloud& points() const { return out; }
+
+    void setBudget(size_t points) { budget = points; }
+
+private:
+    struct Tile {
+        double ax, ay, az;          // unit axis
+        double halfAngle;           // rad, covers every point of the tile
+        double cosHalf, sinHalf;
+    };
+
+    void build() {
+        // Icosahedron, then midpoint subdivision; faces stay in
+        // subdivision order (children of face f are 4f..4f+3)
+        const double p = (1 + std::sqrt(5.0)) / 2;
+        std::vector<double> vx = {-1, 1, -1, 1, 0, 0, 0, 0, p, p, -p, -p};
+        std::vector<double> vy = {p, p, -p, -p, -1, 1, -1, 1, 0, 0, 0, 0};
+        std::vector<double> vz = {0, 0, 0, 0, p, p, -p, -p, -1, 1, -1, 1};
+        for (size_t i = 0; i < vx.size(); i++) {
+            double r = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+            vx[i] /= r; vy[i] /= r; vz[i] /= r;
+        }
+        std::vector<uint32_t> faces = {0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2,
+                                       10, 7, 6, 7, 1, 8, 3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5,
+                                       2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1};
+        std::vector<uint32_t> tileFaces;
+        std::vector<double> faceAxes[TILE_LEVEL + 1];     // xyz per face, subdivisions 0..TILE_LEVEL
+        size_t levelVertices[MAX_LEVEL + 1] = {0};
+        for (int s = 0; s <= MAX_LEVEL; s++) {
+            levelVertices[s] = vx.size();
+            if (s <= TILE_LEVEL) {
+                for (size_t f = 0; f < faces.size(); f += 3) {
+                    double x = 0, y = 0, z = 0;
+                    for (int k = 0; k < 3; k++) { x += vx[faces[f + k]]; y += vy[faces[f + k]]; z += vz[faces[f + k]]; }
+                    double r = std::sqrt(x * x + y * y + z * z);
+                    for (double c : {x / r, y / r, z / r}) faceAxes[s].push_back(c);
+                }
+            }
+            if (s == TILE_LEVEL) tileFaces = faces;
+            if (s == MAX_LEVEL) break;
+            std::unordered_map<uint64_t, uint32_t> midpoints;
+            auto midpoint = [&](uint32_t a, uint32_t b) {
+                uint64_t key = a < b ? (uint64_t)a << 32 | b : (uint64_t)b << 32 | a;
+                auto it = midpoints.find(key);
+                if (it != midpoints.end()) return it->second;
+                double x = vx[a] + vx[b], y = vy[a] + vy[b], z = vz[a] + vz[b], r = std::sqrt(x * x + y * y + z * z);
+                vx.push_back(x / r); vy.push_back(y / r); vz.push_back(z / r);
+                uint32_t id = (uint32_t)vx.size() - 1;
+                midpoints.emplace(key, id);
+                return id;
+            };
+            std::vector<uint32_t> next;
+            next.reserve(faces.size() * 4);
+            for (size_t f = 0; f < faces.size(); f += 3) {
+                uint32_t a = faces[f], b = faces[f + 1], c = faces[f + 2];
+                uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+                for (uint32_t q : {a, ab, ca, ab, b, bc, ca, bc, c, ab, bc, ca}) next.push_back(q);
+            }
+            faces.swap(next);
+        }
+
+        // Tiles: axis through each TILE_LEVEL face's centroid
+        size_t nt = tileFaces.size() / 3;
+        tiles.resize(nt);
+        for (size_t t = 0; t < nt; t++) {
+            const double* a = &faceAxes[TILE_LEVEL][3 * t];
+            tiles[t] = {a[0], a[1], a[2], 0.0, 1.0, 0.0};
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = tileFaces[3 * t + k];
+                tiles[t].halfAngle = std::max(tiles[t].halfAngle, angleTo(tiles[t], vx[v], vy[v], vz[v]));
+            }
+        }
+
+        // Every vertex to a tile: nearest face axis among the 20 base faces,
+        // then down the subdivision tree (4 children each); widen cones to fit
+        std::vector<uint32_t> owner(vx.size());
+        for (size_t v = 0; v < vx.size(); v++) {
+            uint32_t face = 0;
+            for (int s = 0; s <= TILE_LEVEL; s++) {
+                uint32_t first = s == 0 ? 0 : 4 * face, last = s == 0 ? 20 : first + 4;
+                double bestDot = -2;
+                for (uint32_t f = first; f < last; f++) {
+                    const double* a = &faceAxes[s][3 * f];
+                    double d = a[0] * vx[v] + a[1] * vy[v] + a[2] * vz[v];
+                    if (d > bestDot) { bestDot = d; face = f; }
+                }
+            }
+            owner[v] = face;
+            tiles[face].halfAngle = std::max(tiles[face].halfAngle, angleTo(tiles[face], vx[v], vy[v], vz[v]));
+        }
+
+        for (Tile& t : tiles) {
+            t.halfAngle = std::min(t.halfAngle + 1e-6, M_PI / 2);
+            t.cosHalf = std::cos(t.halfAngle);
+            t.sinHalf = std::sin(t.halfAngle);
+        }
+
+        // Per level: counting sort of its vertices by tile
+        for (int l = MIN_LEVEL; l <= MAX_LEVEL; l++) {
+            size_t n = levelVertices[l];
+            std::vector<uint32_t>& start = tileStart[l];
+            start.assign(nt + 1, 0);
+            for (size_t v = 0; v < n; v++) start[owner[v] + 1]++;
+            for (size_t t = 0; t < nt; t++) start[t + 1] += start[t];
+            std::vector<uint32_t> order(n), fill(start.begin(), start.end() - 1);
+            for (size_t v = 0; v < n; v++) order[fill[owner[v]]++] = (uint32_t)v;
+            PointCloud& pc = levels[l];
+            for (uint32_t v : order) pc.add(radius * vx[v], radius * vy[v], radius * vz[v], vx[v], vy[v], vz[v]);
+        }
+    }
+
+    static double angleTo(const Tile& t, double x, double y, double z) {
+        return std::acos(std::max(-1.0, std::min(1.0, t.ax * x + t.ay * y + t.az * z)));
+    }
+
+    double radius;
+    size_t budget;
+    std::vector<Tile> tiles;
+    PointCloud levels[MAX_LEVEL + 1];
+    std::vector<uint32_t> tileStart[MAX_LEVEL + 1];
+    std::vector<uint32_t> visible;
+    PointCloud out;
+    double horizon = 0;
+    int chosen = MIN_LEVEL;
+};
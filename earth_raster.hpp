@@ -0,0 +1,276 @@
+#pragma once
+#include "view_transform.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// EarthRaster: the textured, day/night-lit earth drawn on the CPU into an
+// offscreen RGBA framebuffer, one upload per frame.
+//
+// The earth is a sphere, so there is no mesh to rasterise: each screen row
+// crosses its disc in one span, and every pixel of the span is a ray from
+// the eye hitting the sphere at a closed-form distance. With the
+// ViewTransform projection (eye at view (0, 0, D), s = F / (D - z)) the
+// ray through pixel (px, py) is d = (a, b, -1), a = (px - cx) / F,
+// b = (py - cy) / F, and
+//
+//   span       |a| <= sqrt(K - b^2),   K = R^2 / (D^2 - R^2)
+//   hit        t = (D - sqrt(D^2 - |d|^2 (D^2 - R^2))) / |d|^2
+//   normal     n = combined^T (t a, t b, D - t) / R     (model frame)
+//   texel      lon = atan2(n.z, n.x), lat = atan2(n.y, |n.xz|) on the
+//              equirectangular map (row 0 north, column 0 lon -180), the
+//              same axes as getCityPos()
+//   light      l = n . sun; day = smoothstep(-0.1, 0.1, l) gives a soft
+//              terminator, the day side is lit 0.2 + 0.8 max(l, 0), the
+//              night side keeps a dim, blue-shifted copy of the texture
+//
+// The span loop is branch-free (polynomial atan2, blends, one gather per
+// pixel), so -O3 -march=native -fno-math-errno vectorises it (with errno
+// set by sqrt it stays scalar, ~5x slower). The screen is cut into
+// TILE x TILE tiles run on a WorkStealingPool; a tile clears its own
+// pixels, and tiles outside the disc's bounding box do nothing else.
+// Pixels off the sphere are transparent, so the frame goes over whatever
+// was drawn before it (the sun).
+//
+// Texel bytes are R, G, B, A in memory, as sf::Image / sf::Texture use
+// them. Headless builds read and write binary PPM (P6).
+// ============================================================================
+
+// |error| < 1e-5 rad, no branches (ternaries, not fmin/fmax: those do not vectorise)
+inline float fastAtan2(float y, float x) {
+    float ax = std::fabs(x), ay = std::fabs(y);
+    float mn = ax < ay ? ax : ay, mx = ax < ay ? ay : ax;
+    float a = mn / (mx > 1e-30f ? mx : 1e-30f), s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    r = ay > ax ? 1.57079637f - r : r;
+    r = x < 0 ? 3.14159274f - r : r;
+    return y < 0 ? -r : r;
+}
+
+// Equirectangular RGBA map
+struct EarthTexture {
+    int width = 0, height = 0;
+    std::vector<uint32_t> texels;
+
+    bool empty() const { return texels.empty(); }
+
+    void setRGBA(const uint8_t* rgba, int w, int h) {
+        width = w; height = h;
+        texels.resize((size_t)w * h);
+        std::memcpy(texels.data(), rgba, texels.size() * 4);
+    }
+
+    // Binary PPM (e.g. `convert earth.jpg earth.ppm`)
+    bool loadPPM(const char* path) {
+        FILE* f = std::fopen(path, "rb");
+        if (!f) return false;
+        int w = 0, h = 0, maxval = 0;
+        bool ok = std::fscanf(f, "P6 %d %d %d", &w, &h, &maxval) == 3 && w > 0 && h > 0 && maxval == 255 &&
+                  std::fgetc(f) != EOF;
+        std::vector<uint8_t> rgb(ok ? (size_t)w * h * 3 : 0);
+        ok = ok && std::fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+        std::fclose(f);
+        if (!ok) return false;
+        width = w; height = h;
+        texels.resize((size_t)w * h);
+        for (size_t i = 0; i < texels.size(); i++) texels[i] = pack(rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]);
+        return true;
+    }
+
+    // Stand-in when no map is available: ocean, banded "land", polar caps
+    // and a 15 deg graticule
+    void procedural(int w, int h) {
+        width = w; height = h;
+        texels.resize((size_t)w * h);
+        for (int r = 0; r < h; r++) {
+            double lat = 90.0 - (r + 0.5) * 180.0 / h;
+            for (int c = 0; c < w; c++) {
+                double lon = -180.0 + (c + 0.5) * 360.0 / w;
+                double land = std::sin(lon * 0.05) * std::cos(lat * 0.07) + 0.5 * std::sin(lon * 0.13 + lat * 0.11);
+                uint32_t t = land > 0.6 ? pack(70, 120, 50) : pack(20, 50, 120);
+                if (std::fabs(lat) > 75) t = pack(235, 240, 245);
+                double line = 180.0 / h;       // about one texel wide
+                if (std::fabs(std::remainder(lat, 15.0)) < line || std::fabs(std::remainder(lon, 15.0)) < line) t = pack(200, 200, 200);
+                texels[(size_t)r * w + c] = t;
+            }
+        }
+    }
+
+    static uint32_t pack(uint32_t r, uint32_t g, uint32_t b) { return r | g << 8 | b << 16 | 0xFFu << 24; }
+};
+
+// Camera -> point segments against the opaque sphere |p| = radius (centre
+// at the origin): true when the sphere is in front of the point. Points on
+// the sphere itself (stations) count as visible on the near side.
+struct SphereOccluder {
+    float cx, cy, cz, outside;          // eye, |c|^2 - R^2
+
+    SphereOccluder(double eyeX, double eyeY, double eyeZ, double radius)
+        : cx((float)eyeX), cy((float)eyeY), cz((float)eyeZ),
+          outside((float)(eyeX * eyeX + eyeY * eyeY + eyeZ * eyeZ - radius * radius)) {}
+
+    bool hides(float px, float py, float pz) const {
+        float dx = px - cx, dy = py - cy, dz = pz - cz;
+        float dd = dx * dx + dy * dy + dz * dz, cd = cx * dx + cy * dy + cz * dz;
+        float disc = cd * cd - dd * outside;
+        // First crossing at t = (-cd - sqrt(disc)) / dd, hidden if inside (0, 1)
+        return outside > 0 && cd < 0 && disc > 0 && -cd - std::sqrt(disc) < dd * (1 - 1e-4f);
+    }
+};
+
+class EarthRaster {
+public:
+    static const int TILE = 64;
+
+    EarthRaster(int width, int height) { resize(width, height); }
+
+    void resize(int width, int height) {
+        w = width; h = height;
+        fb.assign((size_t)w * h, 0);
+        tilesX = (w + TILE - 1) / TILE;
+        tilesY = (h + TILE - 1) / TILE;
+        shaded.assign((size_t)tilesX * tilesY, 0);
+    }
+
+    EarthTexture& texture() { return tex; }
+    const EarthTexture& texture() const { return tex; }
+
+    // Sphere of `radius` model units about the model origin, seen through
+    // `view` (rotation-only model); (lx, ly, lz) is the unit direction to
+    // the sun in the model frame (ViewTransform::lightInModel())
+    void render(const ViewTransform& view, double radius, float lx, float ly, float lz, WorkStealingPool* pool = nullptr) {
+        if (tex.empty()) tex.procedural(960, 480);
+        Frame fr;
+        const Mat3& m = view.matrix();
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) fr.mt[j * 3 + i] = (float)m.m[i][j];
+        double D = view.camDist, F = view.focal;
+        fr.visible = D > radius && F > 0;
+        double K = fr.visible ? radius * radius / (D * D - radius * radius) : 0;
+        fr.K = K; fr.F = F; fr.cx = view.cx; fr.cy = view.cy;
+        fr.invF = (float)(1.0 / F);
+        fr.D = (float)D; fr.D2 = (float)(D * D); fr.Q = (float)(D * D - radius * radius);
+        fr.invR = (float)(1.0 / radius);
+        fr.lx = lx; fr.ly = ly; fr.lz = lz;
+        double half = std::sqrt(K) * F;     // disc radius on screen
+        fr.x0 = view.cx - half; fr.x1 = view.cx + half;
+        fr.y0 = view.cy - half; fr.y1 = view.cy + half;
+
+        auto tiles = [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++) renderTile(fr, (int)(t % tilesX), (int)(t / tilesX), shaded[t]);
+        };
+        size_t n = (size_t)tilesX * tilesY;
+        if (pool) pool->parallelFor(n, 1, tiles);
+        else tiles(0, n);
+    }
+
+    int width() const { return w; }
+    int height() const { return h; }
+    const uint32_t* pixels() const { return fb.data(); }
+    const uint8_t* rgba() const { return reinterpret_cast<const uint8_t*>(fb.data()); }
+    size_t tileCount() const { return shaded.size(); }
+
+    // Of the last render()
+    size_t pixelsShaded() const {
+        size_t s = 0;
+        for (uint32_t c : shaded) s += c;
+        return s;
+    }
+    size_t tilesShaded() const { return shaded.size() - std::count(shaded.begin(), shaded.end(), 0u); }
+
+    // Binary PPM, background black
+    bool writePPM(const char* path) const {
+        FILE* f = std::fopen(path, "wb");
+        if (!f) return false;
+        std::fprintf(f, "P6\n%d %d\n255\n", w, h);
+        std::vector<uint8_t> row((size_t)w * 3);
+        bool ok = true;
+        for (int y = 0; y < h && ok; y++) {
+            const uint8_t* p = rgba() + (size_t)y * w * 4;
+            for (int x = 0; x < w; x++) for (int c = 0; c < 3; c++) row[3 * x + c] = p[4 * x + c];
+            ok = std::fwrite(row.data(), 1, row.size(), f) == row.size();
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+
+private:
+    struct Frame {
+        float mt[9];                    // combined^T: view -> model
+        double K, F, cx, cy;
+        double x0, x1, y0, y1;          // disc bounding box
+        float invF, D, D2, Q, invR;
+        float lx, ly, lz;
+        bool visible;
+    };
+
+    void renderTile(const Frame& fr, int tx, int ty, uint32_t& count) {
+        int x0 = tx * TILE, x1 = std::min(w, x0 + TILE), y0 = ty * TILE, y1 = std::min(h, y0 + TILE);
+        count = 0;
+        bool touches = fr.visible && x1 > fr.x0 && x0 < fr.x1 && y1 > fr.y0 && y0 < fr.y1;
+        for (int y = y0; y < y1; y++) {
+            uint32_t* row = fb.data() + (size_t)y * w;
+            std::fill(row + x0, row + x1, 0u);
+            if (!touches) continue;
+            double b = (y + 0.5 - fr.cy) / fr.F, room = fr.K - b * b;
+            if (room <= 0) continue;
+            // Pixel centres with |x + 0.5 - cx| <= half
+            double half = std::sqrt(room) * fr.F;
+            int xs = std::max(x0, (int)std::ceil(fr.cx - half - 0.5));
+            int xe = std::min(x1, (int)std::floor(fr.cx + half - 0.5) + 1);
+            if (xe <= xs) continue;
+            shadeSpan(fr, (float)b, (float)((xs + 0.5 - fr.cx) / fr.F), xe - xs, row + xs);
+            count += xe - xs;
+        }
+    }
+
+    void shadeSpan(const Frame& fr, float b, float a0, int n, uint32_t* __restrict out) const {
+        const float m00 = fr.mt[0], m01 = fr.mt[1], m02 = fr.mt[2], m10 = fr.mt[3], m11 = fr.mt[4], m12 = fr.mt[5];
+        const float m20 = fr.mt[6], m21 = fr.mt[7], m22 = fr.mt[8];
+        const float invF = fr.invF, D = fr.D, D2 = fr.D2, Q = fr.Q, invR = fr.invR, lx = fr.lx, ly = fr.ly, lz = fr.lz;
+        const float bb = b * b + 1;
+        const uint32_t* __restrict texels = tex.texels.data();
+        const int tw = tex.width;
+        const float U = tex.width / 6.28318531f, V = tex.height / 3.14159265f;
+        const float UMAX = tex.width - 1.0f, VMAX = tex.height - 1.0f;
+        for (int i = 0; i < n; i++) {
+            float a = a0 + i * invF;
+            float dd = a * a + bb;
+            float t = (D - std::sqrt(clamp(D2 - dd * Q, 0.0f, D2))) / dd;
+            float vx = t * a * invR, vy = t * b * invR, vz = (D - t) * invR;
+            float nx = m00 * vx + m01 * vy + m02 * vz;
+            float ny = m10 * vx + m11 * vy + m12 * vz;
+            float nz = m20 * vx + m21 * vy + m22 * vz;
+
+            float lon = fastAtan2(nz, nx), lat = fastAtan2(ny, std::sqrt(nx * nx + nz * nz));
+            float u = clamp((lon + 3.14159265f) * U, 0.0f, UMAX);
+            float v = clamp((1.57079633f - lat) * V, 0.0f, VMAX);
+            uint32_t texel = texels[(int)v * tw + (int)u];
+
+            float l = nx * lx + ny * ly + nz * lz;
+            float s = clamp((l + 0.1f) * 5.0f, 0.0f, 1.0f);
+            float day = s * s * (3 - 2 * s);
+            float lit = day * (0.2f + 0.8f * clamp(l, 0.0f, 1.0f));
+            float r = (float)(texel & 0xFF) * (0.05f + 0.95f * lit);
+            float g = (float)(texel >> 8 & 0xFF) * (0.06f + 0.94f * lit);
+            float bl = clamp((float)(texel >> 16 & 0xFF) * (0.10f + 0.90f * lit) + 12.0f * (1 - day), 0.0f, 255.0f);
+            // via int: float -> unsigned does not vectorise
+            out[i] = (uint32_t)((int)r | (int)g << 8 | (int)bl << 16) | 0xFF000000u;
+        }
+    }
+
+    static float clamp(float x, float lo, float hi) {
+        x = x < lo ? lo : x;
+        return x > hi ? hi : x;
+    }
+
+    int w = 0, h = 0, tilesX = 0, tilesY = 0;
+    std::vector<uint32_t> fb;
+    std::vector<uint32_t> shaded;       // pixels per tile
+    EarthTexture tex;
+};
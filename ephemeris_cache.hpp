@@ -0,0 +1,291 @@
+#pragma once
+#include "orbit_common.hpp"
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// ============================================================================
+// EphemerisCache: piecewise Chebyshev fits of every object's trajectory.
+//
+// Time is cut into fixed windows of `window` seconds from `epoch`. For each
+// object the cache holds the fits of the last SLOTS windows it touched:
+// degree-D Chebyshev series in x, y, z fitted at D + 1 Chebyshev nodes of
+// the source propagator (Kepler, SGP4, ...). A lookup inside a cached
+// window is one Clenshaw recurrence per axis (~3 * D FMAs, no trig, no
+// Kepler iteration); the velocity comes from the differentiated series.
+//
+// Windows are built lazily on a miss, or ahead of time by a background
+// thread (prefetch(t) asks for the window containing t for all objects;
+// it never blocks). Readers take no locks: each slot carries its window
+// id, written last on build and checked before and after the evaluation
+// (a seqlock), so a slot rebuilt underneath a reader is detected and the
+// lookup retried. Builds of one object are serialised by a per-object
+// spin flag, so the source function is never called concurrently for the
+// same object (SGP4's deep-space resonance state is not re-entrant).
+//
+// Error: the sum of the two highest coefficients bounds the truncation
+// error well for smooth orbits; maxErrorEstimate() reports the largest seen.
+// A source without a position somewhere in a window (SGP4 decay) returns
+// NaN there; every coefficient of that window is then NaN, so lookups in it
+// return NaN rather than a fit through garbage.
+// ============================================================================
+
+class EphemerisCache {
+public:
+    using PositionFn = std::function<Vector3(size_t object, double t)>;
+
+    static const int SLOTS = 2;                 // current window + the one being prefetched
+    static const int MAX_DEGREE = 16;
+
+    EphemerisCache() = default;
+    EphemerisCache(const EphemerisCache&) = delete;
+    EphemerisCache& operator=(const EphemerisCache&) = delete;
+    ~EphemerisCache() { stopBackground(); }
+
+    // Drop everything and fit `objects` objects from `fn`
+    void reset(size_t objects, PositionFn fn, double window = 900.0, int degree = 10, double epochTime = 0.0) {
+        stopBackground();
+        n = objects;
+        source = std::move(fn);
+        windowLen = window;
+        invWindow = 1.0 / window;
+        deg = degree < 2 ? 2 : degree > MAX_DEGREE ? MAX_DEGREE : degree;
+        epoch = epochTime;
+        stride = 3 * (deg + 1);
+        coeffs.assign(n * SLOTS * stride, 0.0);
+        slotWindow = std::vector<std::atomic<int64_t>>(n * SLOTS);
+        for (auto& w : slotWindow) w.store(EMPTY, std::memory_order_relaxed);
+        building = std::vector<std::atomic<bool>>(n);
+        for (auto& b : building) b.store(false, std::memory_order_relaxed);
+        hitCount.store(0); missCount.store(0); buildCount.store(0);
+        maxError.store(0.0);
+    }
+
+    size_t objects() const { return n; }
+    double window() const { return windowLen; }
+    int degree() const { return deg; }
+    int64_t windowOf(double t) const { return (int64_t)std::floor((t - epoch) * invWindow); }
+
+    uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return missCount.load(std::memory_order_relaxed); }
+    uint64_t windowsBuilt() const { return buildCount.load(std::memory_order_relaxed); }
+    double maxErrorEstimate() const { return maxError.load(std::memory_order_relaxed); }
+    size_t bytes() const {
+        return coeffs.size() * sizeof(double) + slotWindow.size() * sizeof(int64_t) + building.size();
+    }
+    void resetCounters() { hitCount.store(0); missCount.store(0); }
+    double epochTime() const { return epoch; }
+
+    size_t coefficientCount() const { return coeffs.size(); }
+    size_t slotCount() const { return slotWindow.size(); }
+
+    // Copy of every fitted slot for a checkpoint: coefficientCount()
+    // coefficients ([object][slot][axis][k]) and slotCount() window ids.
+    // Safe while lookups and the background thread run: a slot rebuilt
+    // during its copy is saved as empty, by the same window id check the
+    // readers use.
+    void snapshot(double* c, int64_t* windows) const {
+        for (size_t s = 0; s < slotWindow.size(); s++) {
+            int64_t w = slotWindow[s].load(std::memory_order_acquire);
+            std::copy(&coeffs[s * stride], &coeffs[s * stride] + stride, &c[s * stride]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            bool stable = w != BUILDING && slotWindow[s].load(std::memory_order_relaxed) == w;
+            windows[s] = stable ? w : EMPTY;
+        }
+    }
+
+    // reset(), then take over the windows saved by snapshot()
+    void restore(size_t objects, PositionFn fn, double window, int degree, double epochTime,
+                 const double* c, const int64_t* windows) {
+        reset(objects, std::move(fn), window, degree, epochTime);
+        std::copy(c, c + coeffs.size(), coeffs.begin());
+        for (size_t s = 0; s < slotWindow.size(); s++) slotWindow[s].store(windows[s], std::memory_order_relaxed);
+    }
+
+    // Position (and optionally velocity) of object i at t. Safe to call from
+    // several threads, including for the same object.
+    Vector3 position(size_t i, double t, Vector3* vel = nullptr) {
+        bool missed = false;
+        Vector3 p = evaluate(i, t, vel, missed);
+        (missed ? missCount : hitCount).fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+
+    // Objects [begin, end) at one time into column arrays (velocities too
+    // when vx/vy/vz are given); the shared counters are touched once per
+    // call, not per object
+    void positions(size_t begin, size_t end, double t, double* x, double* y, double* z,
+                   double* vx = nullptr, double* vy = nullptr, double* vz = nullptr) {
+        uint64_t missed = 0;
+        for (size_t i = begin; i < end; i++) {
+            bool m = false;
+            Vector3 v{};
+            Vector3 p = evaluate(i, t, vx ? &v : nullptr, m);
+            x[i] = p.x; y[i] = p.y; z[i] = p.z;
+            if (vx) { vx[i] = v.x; vy[i] = v.y; vz[i] = v.z; }
+            missed += m;
+        }
+        missCount.fetch_add(missed, std::memory_order_relaxed);
+        hitCount.fetch_add(end - begin - missed, std::memory_order_relaxed);
+    }
+
+    // Ask the background thread to fit the window containing t for every
+    // object. Returns immediately; a newer request replaces an older one.
+    void prefetch(double t) {
+        int64_t w = windowOf(t);
+        if (requested.load(std::memory_order_relaxed) == w) return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!worker.joinable()) { quit.store(false); worker = std::thread([this] { backgroundLoop(); }); }
+            requested.store(w, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+
+    void stopBackground() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit.store(true);
+        }
+        wake.notify_one();
+        if (worker.joinable()) worker.join();
+        requested.store(EMPTY);
+    }
+
+private:
+    static const int64_t EMPTY = INT64_MIN, BUILDING = INT64_MIN + 1;
+
+    static int slotOf(int64_t w) { return (int)(w & (SLOTS - 1)); }
+
+    Vector3 evaluate(size_t i, double t, Vector3* vel, bool& missed) {
+        int64_t w = windowOf(t);
+        double x = 2.0 * ((t - epoch) * invWindow - w) - 1.0;      // [-1, 1] in the window
+        std::atomic<int64_t>& id = slotWindow[i * SLOTS + slotOf(w)];
+        const double* c = &coeffs[(i * SLOTS + slotOf(w)) * stride];
+        for (;;) {
+            if (id.load(std::memory_order_acquire) == w) {
+                Vector3 p = clenshaw3(c, x);
+                Vector3 v{};        // the derivative series only runs for a velocity request
+                if (vel) v = {derivative(c, x), derivative(c + deg + 1, x), derivative(c + 2 * (deg + 1), x)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (id.load(std::memory_order_relaxed) == w) {
+                    if (vel) *vel = v * (2.0 / windowLen);
+                    return p;
+                }
+                continue;       // rebuilt while we read it
+            }
+            missed = true;
+            build(i, w);
+        }
+    }
+
+    // sum c_k T_k(x) for the three axes at once (independent chains overlap)
+    Vector3 clenshaw3(const double* c, double x) const {
+        const double* cy = c + deg + 1;
+        const double* cz = cy + deg + 1;
+        double x2 = 2 * x;
+        double ax = 0, bx = 0, ay = 0, by = 0, az = 0, bz = 0;
+        for (int k = deg; k >= 1; k--) {
+            double nx = x2 * ax - bx + c[k], ny = x2 * ay - by + cy[k], nz = x2 * az - bz + cz[k];
+            bx = ax; ax = nx; by = ay; ay = ny; bz = az; az = nz;
+        }
+        return {x * ax - bx + c[0], x * ay - by + cy[0], x * az - bz + cz[0]};
+    }
+
+    // d/dx of the series: coefficients of the derivative by the standard
+    // recurrence, then Clenshaw
+    double derivative(const double* c, double x) const {
+        double d[MAX_DEGREE + 2] = {};
+        for (int k = deg; k >= 1; k--) d[k - 1] = d[k + 1] + 2 * k * c[k];
+        d[0] *= 0.5;
+        double b1 = 0, b2 = 0;
+        for (int k = deg - 1; k >= 1; k--) {
+            double b0 = 2 * x * b1 - b2 + d[k];
+            b2 = b1; b1 = b0;
+        }
+        return x * b1 - b2 + d[0];
+    }
+
+    // Fit object i over window w (unless someone else already did)
+    void build(size_t i, int64_t w) {
+        std::atomic<bool>& lock = building[i];
+        while (lock.exchange(true, std::memory_order_acquire)) std::this_thread::yield();
+
+        std::atomic<int64_t>& id = slotWindow[i * SLOTS + slotOf(w)];
+        if (id.load(std::memory_order_relaxed) != w) {
+            id.store(BUILDING, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            const int N = deg + 1;
+            double mid = epoch + (w + 0.5) * windowLen, half = 0.5 * windowLen;
+            double fx[MAX_DEGREE + 1], fy[MAX_DEGREE + 1], fz[MAX_DEGREE + 1];
+            for (int j = 0; j < N; j++) {
+                Vector3 p = source(i, mid + half * std::cos(M_PI * (j + 0.5) / N));
+                fx[j] = p.x; fy[j] = p.y; fz[j] = p.z;
+            }
+            double* c = &coeffs[(i * SLOTS + slotOf(w)) * stride];
+            for (int k = 0; k < N; k++) {
+                double sx = 0, sy = 0, sz = 0;
+                for (int j = 0; j < N; j++) {
+                    double T = std::cos(M_PI * k * (j + 0.5) / N);
+                    sx += fx[j] * T; sy += fy[j] * T; sz += fz[j] * T;
+                }
+                double scale = (k == 0 ? 1.0 : 2.0) / N;
+                c[k] = sx * scale; c[N + k] = sy * scale; c[2 * N + k] = sz * scale;
+            }
+            double err = 0;
+            for (int axis = 0; axis < 3; axis++) {
+                err = std::fmax(err, std::fabs(c[axis * N + deg]) + std::fabs(c[axis * N + deg - 1]));
+            }
+            double seen = maxError.load(std::memory_order_relaxed);
+            while (err > seen && !maxError.compare_exchange_weak(seen, err, std::memory_order_relaxed)) {}
+
+            id.store(w, std::memory_order_release);
+            buildCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        lock.store(false, std::memory_order_release);
+    }
+
+    void backgroundLoop() {
+        int64_t done = EMPTY;
+        for (;;) {
+            int64_t w;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                wake.wait(lock, [&] { return quit || requested.load(std::memory_order_relaxed) != done; });
+                if (quit) return;
+                w = requested.load(std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < n && !quit; i++) {
+                if (slotWindow[i * SLOTS + slotOf(w)].load(std::memory_order_relaxed) != w) build(i, w);
+                if (requested.load(std::memory_order_relaxed) != w) break;     // superseded
+            }
+            done = w;
+        }
+    }
+
+    size_t n = 0;
+    PositionFn source;
+    double windowLen = 900.0, invWindow = 1.0 / 900.0, epoch = 0.0;
+    int deg = 10;
+    size_t stride = 33;
+    std::vector<double> coeffs;                         // [object][slot][axis][k]
+    std::vector<std::atomic<int64_t>> slotWindow;       // window held by each slot
+    std::vector<std::atomic<bool>> building;            // per-object build flag
+
+    std::atomic<uint64_t> hitCount{0}, missCount{0}, buildCount{0};
+    std::atomic<double> maxError{0.0};
+
+    std::thread worker;
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::atomic<bool> quit{false};
+    std::atomic<int64_t> requested{EMPTY};
+};
@@ -0,0 +1,174 @@
+#pragma once
+#include "orbit_common.hpp"
+#include <cmath>
+#include <limits>
+
+// ============================================================================
+// Force models as compile-time policies.
+//
+// Each term is a small struct with accel(r, v, t) -> m/s^2 (ECI, Z north,
+// t in seconds). ForceModel<Terms...> inherits from all of them and sums
+// their accelerations in a fold expression, so every combination is its own
+// fully inlined kernel with no virtual calls or runtime switches:
+//
+//   ForceModel<TwoBody>                        same as TwoBodyForce
+//   ForceModel<TwoBody, J2>                    + Earth oblateness
+//   ForceModel<TwoBody, Zonal<6>, Drag>        + J2..J6, exponential atmosphere
+//   ForceModel<TwoBody, J2, ThirdBody>         + Sun and Moon
+//
+// A ForceModel is a Force for the integrators in integrators.hpp (call
+// operator (r, v, t)). Per-object parameters live in the term:
+//   model.Drag::ballistic = cd * area / mass;
+//
+//   TwoBody      -mu r / |r|^3
+//   Zonal<N>     zonal harmonics J2..JN (N <= 6, EGM96 values), Legendre
+//                recurrences unrolled at compile time
+//   Drag         -1/2 rho B |v_rel| v_rel, v_rel against the co-rotating
+//                atmosphere, rho from the piecewise exponential model
+//                (Vallado table 8-4, 0..1000 km)
+//   ThirdBody    Sun and Moon point masses from low-precision analytic
+//                ephemerides (~0.01 deg Sun, ~0.3 deg Moon), refreshed every
+//                THIRD_BODY_REFRESH seconds; jd0 is the JD of t = 0
+// ============================================================================
+
+const double EGM_RADIUS = 6378136.3;                // m, zonal reference radius
+const double ZONAL_J[7] = {0, 0, 1.08262668355e-3, -2.53265648533e-6, -1.61962159137e-6,
+                           -2.27296082869e-7, 5.40681239107e-7};
+const double MU_SUN = 1.32712440018e20;             // m^3/s^2
+const double MU_MOON = 4.9028e12;
+const double AU = 1.495978707e11;
+
+struct TwoBody {
+    Vector3 accel(const Vector3& r, const Vector3&, double) const {
+        double r2 = r.dot(r);
+        return r * (-MU_EARTH / (r2 * std::sqrt(r2)));
+    }
+};
+
+// Zonal terms n = 2..N of V = mu/r * (1 - sum Jn (R/r)^n Pn(sin lat)):
+//   a_n = mu Jn R^n / r^(n+2) * [((n+1) Pn + s Pn') r_hat - Pn' z_hat],  s = z/r
+template <int N>
+struct Zonal {
+    static_assert(N >= 2 && N <= 6, "zonal harmonics J2..J6");
+
+    Vector3 accel(const Vector3& r, const Vector3&, double) const {
+        double r2 = r.dot(r), rm = std::sqrt(r2), inv = 1.0 / rm;
+        double s = r.z * inv, q = EGM_RADIUS * inv;
+        // P and P' up to N by the three-term recurrences
+        double P[N + 1], dP[N + 1];
+        P[0] = 1; P[1] = s;
+        dP[0] = 0; dP[1] = 1;
+        for (int k = 1; k < N; k++) {
+            P[k + 1] = ((2 * k + 1) * s * P[k] - k * P[k - 1]) / (k + 1);
+            dP[k + 1] = dP[k - 1] + (2 * k + 1) * P[k];
+        }
+        double radial = 0, axial = 0, qn = q;
+        for (int n = 2; n <= N; n++) {
+            qn *= q;
+            radial += ZONAL_J[n] * qn * ((n + 1) * P[n] + s * dP[n]);
+            axial += ZONAL_J[n] * qn * dP[n];
+        }
+        double k = MU_EARTH / r2;
+        return {k * radial * r.x * inv, k * radial * r.y * inv, k * (radial * r.z * inv - axial)};
+    }
+};
+using J2 = Zonal<2>;
+
+struct Drag {
+    double ballistic = 0.01;        // Cd * A / m [m^2/kg]
+
+    // Exponential atmosphere: base altitude [km], density [kg/m^3], scale height [km]
+    static double density(double altitudeKm) {
+        static const double TABLE[][3] = {
+            {0, 1.225, 7.249},         {25, 3.899e-2, 6.349},     {30, 1.774e-2, 6.682},
+            {40, 3.972e-3, 7.554},     {50, 1.057e-3, 8.382},     {60, 3.206e-4, 7.714},
+            {70, 8.770e-5, 6.549},     {80, 1.905e-5, 5.799},     {90, 3.396e-6, 5.382},
+            {100, 5.297e-7, 5.877},    {110, 9.661e-8, 7.263},    {120, 2.438e-8, 9.473},
+            {130, 8.484e-9, 12.636},   {140, 3.845e-9, 16.149},   {150, 2.070e-9, 22.523},
+            {180, 5.464e-10, 29.740},  {200, 2.789e-10, 37.105},  {250, 7.248e-11, 45.546},
+            {300, 2.418e-11, 53.628},  {350, 9.518e-12, 53.298},  {400, 3.725e-12, 58.515},
+            {450, 1.585e-12, 60.828},  {500, 6.967e-13, 63.822},  {600, 1.454e-13, 71.835},
+            {700, 3.614e-14, 88.667},  {800, 1.170e-14, 124.64},  {900, 5.245e-15, 181.05},
+            {1000, 3.019e-15, 268.00}};
+        const int ROWS = sizeof(TABLE) / sizeof(TABLE[0]);
+        if (altitudeKm < 0) altitudeKm = 0;
+        int k = ROWS - 1;
+        while (k > 0 && altitudeKm < TABLE[k][0]) k--;
+        return TABLE[k][1] * std::exp(-(altitudeKm - TABLE[k][0]) / TABLE[k][2]);
+    }
+
+    Vector3 accel(const Vector3& r, const Vector3& v, double) const {
+        double rho = density((r.magnitude() - EGM_RADIUS) / 1000.0);
+        // Air co-rotates with the Earth: v_rel = v - w x r, w = (0, 0, W)
+        Vector3 rel = {v.x + EARTH_ROTATION_SPEED * r.y, v.y - EARTH_ROTATION_SPEED * r.x, v.z};
+        return rel * (-0.5 * rho * ballistic * rel.magnitude());
+    }
+};
+
+// Geocentric Sun and Moon, equatorial (mean equator and equinox of date) [m]
+inline Vector3 sunPosition(double jd) {
+    const double D = M_PI / 180.0;
+    double T = (jd - 2451545.0) / 36525.0;
+    double M = (357.5291092 + 35999.05034 * T) * D;
+    double lambda = (280.460 + 36000.771 * T) * D + (1.914666471 * std::sin(M) + 0.019994643 * std::sin(2 * M)) * D;
+    double dist = (1.000140612 - 0.016708617 * std::cos(M) - 0.000139589 * std::cos(2 * M)) * AU;
+    double eps = (23.439291 - 0.0130042 * T) * D;
+    return {dist * std::cos(lambda), dist * std::cos(eps) * std::sin(lambda), dist * std::sin(eps) * std::sin(lambda)};
+}
+
+inline Vector3 moonPosition(double jd) {
+    const double D = M_PI / 180.0;
+    double T = (jd - 2451545.0) / 36525.0;
+    double lambda = 218.32 + 481267.8813 * T + 6.29 * std::sin((134.9 + 477198.85 * T) * D)
+                  - 1.27 * std::sin((259.2 - 413335.38 * T) * D) + 0.66 * std::sin((235.7 + 890534.23 * T) * D)
+                  + 0.21 * std::sin((269.9 + 954397.70 * T) * D) - 0.19 * std::sin((357.5 + 35999.05 * T) * D)
+                  - 0.11 * std::sin((186.6 + 966404.05 * T) * D);
+    double beta = 5.13 * std::sin((93.3 + 483202.03 * T) * D) + 0.28 * std::sin((228.2 + 960400.87 * T) * D)
+                - 0.28 * std::sin((318.3 + 6003.18 * T) * D) - 0.17 * std::sin((217.6 - 407332.20 * T) * D);
+    double parallax = 0.9508 + 0.0518 * std::cos((134.9 + 477198.85 * T) * D) + 0.0095 * std::cos((259.2 - 413335.38 * T) * D)
+                    + 0.0078 * std::cos((235.7 + 890534.23 * T) * D) + 0.0028 * std::cos((269.9 + 954397.70 * T) * D);
+    double dist = EGM_RADIUS / std::sin(parallax * D);
+    double eps = (23.439291 - 0.0130042 * T) * D;
+    lambda *= D; beta *= D;
+    double cl = std::cos(lambda), sl = std::sin(lambda), cb = std::cos(beta), sb = std::sin(beta);
+    return {dist * cb * cl,
+            dist * (std::cos(eps) * cb * sl - std::sin(eps) * sb),
+            dist * (std::sin(eps) * cb * sl + std::cos(eps) * sb)};
+}
+
+struct ThirdBody {
+    static constexpr double THIRD_BODY_REFRESH = 60.0;     // s
+    double jd0 = 2460310.5;                                 // JD at t = 0
+
+    Vector3 accel(const Vector3& r, const Vector3&, double t) const {
+        if (!(std::fabs(t - cachedT) < THIRD_BODY_REFRESH)) {
+            cachedT = t;
+            double jd = jd0 + t / 86400.0;
+            sun = sunPosition(jd);
+            moon = moonPosition(jd);
+        }
+        return pull(r, sun, MU_SUN) + pull(r, moon, MU_MOON);
+    }
+
+private:
+    // Perturbing acceleration relative to the (also accelerated) Earth
+    static Vector3 pull(const Vector3& r, const Vector3& body, double mu) {
+        Vector3 d = body - r;
+        double d2 = d.dot(d), b2 = body.dot(body);
+        return d * (mu / (d2 * std::sqrt(d2))) - body * (mu / (b2 * std::sqrt(b2)));
+    }
+
+    mutable double cachedT = std::numeric_limits<double>::quiet_NaN();
+    mutable Vector3 sun = {0, 0, 0}, moon = {0, 0, 0};
+};
+
+template <class... Terms>
+struct ForceModel : Terms... {
+    static constexpr int TERMS = sizeof...(Terms);
+
+    Vector3 operator()(const Vector3& r, const Vector3& v, double t) const {
+        Vector3 a = {0, 0, 0};
+        ((a = a + Terms::accel(r, v, t)), ...);
+        return a;
+    }
+};
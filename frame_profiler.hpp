@@ -0,0 +1,293 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// ============================================================================
+// FrameProfiler: scoped stage timers, per-frame counters, Chrome trace.
+//
+//   FrameProfiler prof;
+//   const int EARTH = prof.stage("earth"), DRAWS = prof.counter("draw calls");
+//   while (running) {
+//       { PROFILE_SCOPE(prof, EARTH); ...; prof.add(DRAWS, 1); }
+//       prof.endFrame();
+//   }
+//
+// Sequence times consecutive stages of a flat loop body (next() closes one
+// stage and opens the next) where scoping each stage in a block would not fit.
+//
+// Every stage accumulates its time within the frame; endFrame() folds the
+// frame into a rolling window of HISTORY frames, which stageMs() and
+// counterPerFrame() average over (for the HUD). Scopes may run on any
+// thread (the physics step is one); per-stage totals are atomics.
+//
+// With startTrace(path, frames) every scope and every frame's counters are
+// also recorded, and after `frames` frames (or on stopTrace()) they are
+// written as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Cost: disabled, a scope is one predictable branch and never reads the
+// clock; build with -DORBIT_NO_PROFILER to compile the scopes out. Enabled,
+// two steady_clock reads per scope (~40 ns). Trace events take a mutex.
+//
+// Heap allocations: define FRAME_PROFILER_COUNT_ALLOCATIONS before including
+// this header in exactly one translation unit to replace operator new with a
+// counting one; allocations per frame then show up as a built-in counter
+// (profilerAllocations / profilerAllocatedBytes are the running totals).
+// ============================================================================
+
+inline std::atomic<uint64_t> profilerAllocations{0}, profilerAllocatedBytes{0};
+
+#ifdef FRAME_PROFILER_COUNT_ALLOCATIONS
+// None of these are inlined: g++ would otherwise see malloc()/free() paired
+// with operator new/delete at the call sites and warn (-Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(size_t size) {
+    profilerAllocations.fetch_add(1, std::memory_order_relaxed);
+    profilerAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+#endif
+
+class FrameProfiler {
+public:
+    static const int MAX_STAGES = 32, MAX_COUNTERS = 16;
+    static const int HISTORY = 60;                  // frames in the rolling average
+    static const size_t MAX_TRACE_EVENTS = 4 << 20; // ~130 MB, then recording stops
+
+    FrameProfiler() : origin(Clock::now()) { allocCounter = counter("allocations"); }
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+    ~FrameProfiler() { stopTrace(); }
+
+    // Register (or look up) a stage / counter; call before the frame loop
+    int stage(const char* name) { return find(stageNames, name, MAX_STAGES); }
+    int counter(const char* name) { return find(counterNames, name, MAX_COUNTERS); }
+
+    void setEnabled(bool on) { active.store(on, std::memory_order_relaxed); }
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+
+    // Record every scope for `frames` frames, then write `path`
+    void startTrace(const std::string& path, int frames) {
+        std::lock_guard<std::mutex> lock(traceMtx);
+        tracePath = path;
+        traceFramesLeft = frames;
+        events.clear();
+        events.reserve(1 << 16);
+        counterSamples.clear();
+        tracing.store(true);
+        active.store(true);
+    }
+    bool isTracing() const { return tracing.load(std::memory_order_relaxed); }
+
+    // Write what has been recorded so far (no-op when not tracing)
+    bool stopTrace() {
+        if (!tracing.exchange(false)) return false;
+        std::lock_guard<std::mutex> lock(traceMtx);
+        return writeTrace();
+    }
+
+    class Scope {
+    public:
+        Scope(FrameProfiler* p, int id) : prof(p && p->enabled() ? p : nullptr), stageId(id) {
+            if (prof) start = prof->nowNs();
+        }
+        ~Scope() {
+            if (prof) prof->record(stageId, start, prof->nowNs() - start);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameProfiler* prof;
+        int stageId;
+        int64_t start = 0;
+    };
+
+    // Back-to-back stages without nesting blocks: next() closes the running
+    // stage and opens the next one; the destructor closes the last.
+    class Sequence {
+    public:
+        explicit Sequence(FrameProfiler& p) : prof(p.enabled() ? &p : nullptr) {}
+        ~Sequence() { end(); }
+        Sequence(const Sequence&) = delete;
+        Sequence& operator=(const Sequence&) = delete;
+
+        void next(int id) {
+            if (!prof) return;
+            int64_t now = prof->nowNs();
+            if (stageId >= 0) prof->record(stageId, start, now - start);
+            stageId = id;
+            start = now;
+        }
+        void end() {
+            if (!prof || stageId < 0) return;
+            prof->record(stageId, start, prof->nowNs() - start);
+            stageId = -1;
+        }
+
+    private:
+        FrameProfiler* prof;
+        int stageId = -1;
+        int64_t start = 0;
+    };
+
+    void add(int counterId, int64_t n) {
+        if (enabled()) counterFrame[counterId].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Close the frame: roll stage times and counters into the history
+    void endFrame() {
+        if (!enabled()) {
+            frameStart = -1;
+            return;
+        }
+        int64_t now = nowNs();
+        if (frameStart < 0) {       // first frame since enabled: only open it
+            for (auto& ns : stageFrame) ns.store(0, std::memory_order_relaxed);
+            for (auto& n : counterFrame) n.store(0, std::memory_order_relaxed);
+            lastAllocs = profilerAllocations.load(std::memory_order_relaxed);
+            frameStart = now;
+            return;
+        }
+        uint64_t allocs = profilerAllocations.load(std::memory_order_relaxed);
+        counterFrame[allocCounter].fetch_add((int64_t)(allocs - lastAllocs), std::memory_order_relaxed);
+        lastAllocs = allocs;
+
+        int slot = frames % HISTORY;
+        for (int s = 0; s < (int)stageNames.size(); s++) {
+            int64_t ns = stageFrame[s].exchange(0, std::memory_order_relaxed);
+            stageSum[s] += ns - stageHistory[s][slot];
+            stageHistory[s][slot] = ns;
+        }
+        int64_t values[MAX_COUNTERS];
+        for (int c = 0; c < (int)counterNames.size(); c++) {
+            values[c] = counterFrame[c].exchange(0, std::memory_order_relaxed);
+            counterSum[c] += values[c] - counterHistory[c][slot];
+            counterHistory[c][slot] = values[c];
+        }
+        frameSum += (now - frameStart) - frameHistory[slot];
+        frameHistory[slot] = now - frameStart;
+        frames++;
+
+        if (isTracing()) {
+            std::lock_guard<std::mutex> lock(traceMtx);
+            if (events.size() < MAX_TRACE_EVENTS) events.push_back({-1, frameStart, now - frameStart, threadId()});
+            CounterSample sample;
+            sample.t = now;
+            for (int c = 0; c < (int)counterNames.size(); c++) sample.values[c] = values[c];
+            counterSamples.push_back(sample);
+            if (--traceFramesLeft <= 0) {
+                tracing.store(false);
+                writeTrace();
+            }
+        }
+        frameStart = now;
+    }
+
+    // Rolling averages over the last HISTORY frames
+    size_t stageCount() const { return stageNames.size(); }
+    const std::string& stageName(int id) const { return stageNames[id]; }
+    double stageMs(int id) const { return stageSum[id] / (double)window() * 1e-6; }
+    double frameMs() const { return frameSum / (double)window() * 1e-6; }
+    size_t counterCount() const { return counterNames.size(); }
+    const std::string& counterName(int id) const { return counterNames[id]; }
+    double counterPerFrame(int id) const { return counterSum[id] / (double)window(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event {
+        int stage;              // -1 = whole frame
+        int64_t start, dur;     // ns since origin
+        int tid;
+    };
+    struct CounterSample {
+        int64_t t;
+        int64_t values[MAX_COUNTERS];
+    };
+
+    int64_t nowNs() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin).count(); }
+    int64_t window() const { return frames < HISTORY ? (frames ? frames : 1) : HISTORY; }
+
+    static int threadId() {
+        static std::atomic<int> next{0};
+        thread_local int id = next.fetch_add(1);
+        return id;
+    }
+
+    static int find(std::vector<std::string>& names, const char* name, int max) {
+        for (size_t i = 0; i < names.size(); i++) if (names[i] == name) return (int)i;
+        if ((int)names.size() == max) return max - 1;      // out of slots: share the last one
+        names.push_back(name);
+        return (int)names.size() - 1;
+    }
+
+    void record(int id, int64_t start, int64_t dur) {
+        stageFrame[id].fetch_add(dur, std::memory_order_relaxed);
+        if (isTracing()) {
+            std::lock_guard<std::mutex> lock(traceMtx);
+            if (events.size() < MAX_TRACE_EVENTS) events.push_back({id, start, dur, threadId()});
+        }
+    }
+
+    // Trace-event JSON: one complete ("X") event per scope, a counter ("C")
+    // track per frame. Timestamps are microseconds.
+    bool writeTrace() {
+        FILE* f = std::fopen(tracePath.c_str(), "w");
+        if (!f) return false;
+        std::fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        std::fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"orbitview\"}}");
+        for (const Event& e : events) {
+            const char* name = e.stage < 0 ? "frame" : stageNames[e.stage].c_str();
+            std::fprintf(f, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+                         name, e.stage < 0 ? "frame" : "stage", e.start * 1e-3, e.dur * 1e-3, e.tid);
+        }
+        for (const CounterSample& s : counterSamples) {
+            for (size_t c = 0; c < counterNames.size(); c++) {
+                std::fprintf(f, ",\n{\"name\": \"%s\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"args\": {\"per frame\": %lld}}",
+                             counterNames[c].c_str(), s.t * 1e-3, (long long)s.values[c]);
+            }
+        }
+        std::fprintf(f, "\n]}\n");
+        bool ok = std::fclose(f) == 0;
+        std::fprintf(stderr, "Trace: %zu events, %zu frames -> %s\n", events.size(), counterSamples.size(), tracePath.c_str());
+        events.clear();
+        counterSamples.clear();
+        return ok;
+    }
+
+    Clock::time_point origin;
+    std::atomic<bool> active{false}, tracing{false};
+    std::vector<std::string> stageNames, counterNames;
+    int allocCounter = 0;
+
+    std::atomic<int64_t> stageFrame[MAX_STAGES] = {};
+    std::atomic<int64_t> counterFrame[MAX_COUNTERS] = {};
+    int64_t stageHistory[MAX_STAGES][HISTORY] = {}, stageSum[MAX_STAGES] = {};
+    int64_t counterHistory[MAX_COUNTERS][HISTORY] = {}, counterSum[MAX_COUNTERS] = {};
+    int64_t frameHistory[HISTORY] = {}, frameSum = 0;
+    int64_t frames = 0, frameStart = -1;
+    uint64_t lastAllocs = 0;
+
+    std::mutex traceMtx;
+    std::string tracePath;
+    int traceFramesLeft = 0;
+    std::vector<Event> events;
+    std::vector<CounterSample> counterSamples;
+};
+
+#ifdef ORBIT_NO_PROFILER
+#define PROFILE_SCOPE(prof, stageId) ((void)0)
+#else
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(prof, stageId) FrameProfiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)(&(prof), (stageId))
+#endif
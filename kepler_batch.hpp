@@ -0,0 +1,196 @@
+#pragma once
+#include "orbit_common.hpp"
+#include <vector>
+#include <cstddef>
+
+// ============================================================================
+// KeplerBatch: two-body propagation for a whole catalog at once.
+//
+// Same model as getSatellitePosition() in main_3d_sat.cpp, but:
+//   * elements live in Structure-of-Arrays form (one std::vector per field),
+//   * everything that does not depend on time (semi-major axis, the six
+//     orientation trig terms, sqrt(1-e^2)) is folded into per-object
+//     constants once in add(),
+//   * the kernel runs a fixed number of Newton iterations with a branch-free
+//     sin/cos so the compiler turns the object loop into AVX2/NEON code.
+//     Build with -O3 -march=native (or -mcpu=native on ARM) to get the SIMD
+//     version; GCC also needs -fno-trapping-math (clang's default) before it
+//     will if-convert the Newton loop. Without these you still get the
+//     SoA + precompute speedup.
+// ============================================================================
+
+const int KEPLER_ITERATIONS = 5;     // matches the scalar solver
+
+// --- BRANCH-FREE SIN/COS (vectorizes, ~1 ulp on the reduced range) ---
+// Reduce by quadrant (Cody-Waite), evaluate fdlibm kernels on [-pi/4, pi/4],
+// then pick/negate with arithmetic blends instead of branches.
+inline void fastSinCos(double x, double& s, double& c) {
+    const double PIO2_HI = 1.57079632673412561417e+00;
+    const double PIO2_LO = 6.07710050650619224932e-11;
+
+    double q = std::floor(x * (2.0 / M_PI) + 0.5);
+    double r = (x - q * PIO2_HI) - q * PIO2_LO;
+    double r2 = r * r;
+
+    double sp = r + r * r2 * (-1.66666666666666324348e-01 + r2 * (8.33333333332248946124e-03
+              + r2 * (-1.98412698298579493134e-04 + r2 * (2.75573137070700676789e-06
+              + r2 * (-2.50507602534068634195e-08 + r2 * 1.58969099521155010221e-10)))));
+    double cp = 1.0 - 0.5 * r2 + r2 * r2 * (4.16666666666666019037e-02 + r2 * (-1.38888888888741095749e-03
+              + r2 * (2.48015872894767294178e-05 + r2 * (-2.75573143513906633035e-07
+              + r2 * (2.08757232129817482790e-09 + r2 * -1.13596475577881948265e-11)))));
+
+    double quad = q - 4.0 * std::floor(q * 0.25);          // 0..3
+    double odd  = quad - 2.0 * std::floor(quad * 0.5);     // 0 or 1
+    double sa = sp + odd * (cp - sp);
+    double ca = cp + odd * (sp - cp);
+    double sSign = 1.0 - 2.0 * std::floor(quad * 0.5);                 // quad 2,3 -> -1
+    double cSign = 1.0 - 2.0 * (std::floor((quad + 1.0) * 0.5) - 2.0 * std::floor((quad + 1.0) * 0.25));
+    s = sSign * sa;
+    c = cSign * ca;
+}
+
+struct KeplerBatch {
+    // Per-object constants (SoA)
+    std::vector<double> meanAnomaly;   // M0 at t = 0 [rad]
+    std::vector<double> meanMotion;    // n [rad/s]
+    std::vector<double> ecc;
+    std::vector<double> semiMajor;     // a [m]
+    std::vector<double> semiMinor;     // a*sqrt(1-e^2) [m]
+    std::vector<double> Px, Py, Pz;    // perifocal P unit vector (towards perigee)
+    std::vector<double> Qx, Qy, Qz;    // perifocal Q unit vector
+
+    size_t size() const { return meanMotion.size(); }
+
+    void reserve(size_t n) {
+        for (auto* v : {&meanAnomaly, &meanMotion, &ecc, &semiMajor, &semiMinor, &Px, &Py, &Pz, &Qx, &Qy, &Qz}) v->reserve(n);
+    }
+
+    void clear() {
+        for (auto* v : {&meanAnomaly, &meanMotion, &ecc, &semiMajor, &semiMinor, &Px, &Py, &Pz, &Qx, &Qy, &Qz}) v->clear();
+    }
+
+    // Angles in radians, meanMotion in rad/s (same units as OrbitalElements).
+    size_t add(double inclination, double raan, double e, double argPerigee, double M0, double n) {
+        double a = std::cbrt(MU_EARTH / (n * n));
+        double cO = std::cos(raan), sO = std::sin(raan);
+        double ci = std::cos(inclination), si = std::sin(inclination);
+        double cw = std::cos(argPerigee), sw = std::sin(argPerigee);
+
+        meanAnomaly.push_back(M0);
+        meanMotion.push_back(n);
+        ecc.push_back(e);
+        semiMajor.push_back(a);
+        semiMinor.push_back(a * std::sqrt(1 - e * e));
+        Px.push_back(cO*cw - sO*ci*sw);  Qx.push_back(-(cO*sw + sO*ci*cw));
+        Py.push_back(sO*cw + cO*ci*sw);  Qy.push_back(-(sO*sw - cO*ci*cw));
+        Pz.push_back(si*sw);             Qz.push_back(si*cw);
+        return size() - 1;
+    }
+
+    // Osculating elements from an ECI state (m, m/s) observed at time t, so
+    // integrated objects can hand over to the analytic path.
+    size_t addFromState(const Vector3& r, const Vector3& v, double t) {
+        double rm = r.magnitude(), v2 = v.dot(v);
+        Vector3 h = {r.y * v.z - r.z * v.y, r.z * v.x - r.x * v.z, r.x * v.y - r.y * v.x};
+        double hm = h.magnitude();
+        Vector3 ev = (r * (v2 - MU_EARTH / rm) - v * r.dot(v)) * (1.0 / MU_EARTH);
+        double e = ev.magnitude();
+        double a = 1.0 / (2.0 / rm - v2 / MU_EARTH);
+        double inc = std::acos(h.z / hm);
+
+        // Node line (x axis if equatorial), perigee direction (node if circular)
+        Vector3 node = {-h.y, h.x, 0.0};
+        double nm = node.magnitude();
+        if (nm < 1e-9 * hm) { node = {1, 0, 0}; nm = 1; }
+        node = node * (1.0 / nm);
+        double raan = std::atan2(node.y, node.x);
+        Vector3 w = h * (1.0 / hm);
+        Vector3 inPlane = {w.y * node.z - w.z * node.y, w.z * node.x - w.x * node.z, w.x * node.y - w.y * node.x};
+        auto angleFromNode = [&](const Vector3& d) { return std::atan2(d.dot(inPlane), d.dot(node)); };
+
+        double argp = (e > 1e-9) ? angleFromNode(ev) : 0.0;
+        double nu = angleFromNode(r) - argp;
+        double E = std::atan2(std::sqrt(1 - e * e) * std::sin(nu), e + std::cos(nu));
+        double n = std::sqrt(MU_EARTH / (a * a * a));
+        double M0 = std::fmod(E - e * std::sin(E) - n * t, 2 * M_PI);
+        return add(inc, raan, e, argp, M0, n);
+    }
+
+    // Fill x/y/z (ECI, meters) for objects [begin, end) at time t [s].
+    // Output arrays are indexed by object id, so disjoint ranges can be
+    // filled from different threads into one shared buffer.
+    void propagate(double t, size_t begin, size_t end, double* x, double* y, double* z) const {
+        kernel<false>(t, begin, end, x, y, z, nullptr, nullptr, nullptr);
+    }
+
+    // Same, plus velocities [m/s]: dE/dt = n / (1 - e cos E)
+    void propagate(double t, size_t begin, size_t end, double* x, double* y, double* z,
+                   double* vx, double* vy, double* vz) const {
+        kernel<true>(t, begin, end, x, y, z, vx, vy, vz);
+    }
+
+    void propagate(double t, double* x, double* y, double* z) const {
+        propagate(t, 0, size(), x, y, z);
+    }
+
+    // Single-object query for root finders / refinement (same math, one lane)
+    Vector3 position(size_t i, double t) const {
+        double M = meanAnomaly[i] + meanMotion[i] * t;
+        M -= 2 * M_PI * std::floor(M / (2 * M_PI));
+        double E = M, sE, cE;
+        for (int k = 0; k < KEPLER_ITERATIONS; k++) {
+            fastSinCos(E, sE, cE);
+            E = E - (E - ecc[i] * sE - M) / (1 - ecc[i] * cE);
+        }
+        fastSinCos(E, sE, cE);
+        double P = semiMajor[i] * (cE - ecc[i]);
+        double Q = semiMinor[i] * sE;
+        return {P * Px[i] + Q * Qx[i], P * Py[i] + Q * Qy[i], P * Pz[i] + Q * Qz[i]};
+    }
+
+    double inclination(size_t i) const { return std::acos(Px[i] * Qy[i] - Py[i] * Qx[i]); }   // (P x Q).z
+    double period(size_t i) const { return 2 * M_PI / meanMotion[i]; }
+    double apogeeRadius(size_t i) const { return semiMajor[i] * (1 + ecc[i]); }
+    double perigeeRadius(size_t i) const { return semiMajor[i] * (1 - ecc[i]); }
+
+private:
+    template <bool VELOCITY>
+    void kernel(double t, size_t begin, size_t end,
+                double* __restrict x, double* __restrict y, double* __restrict z,
+                double* __restrict vx, double* __restrict vy, double* __restrict vz) const {
+        const double* __restrict M0 = meanAnomaly.data();
+        const double* __restrict n  = meanMotion.data();
+        const double* __restrict e  = ecc.data();
+        const double* __restrict a  = semiMajor.data();
+        const double* __restrict b  = semiMinor.data();
+        const double* __restrict px = Px.data(); const double* __restrict py = Py.data(); const double* __restrict pz = Pz.data();
+        const double* __restrict qx = Qx.data(); const double* __restrict qy = Qy.data(); const double* __restrict qz = Qz.data();
+        const double TWO_PI = 2 * M_PI;
+
+        for (size_t i = begin; i < end; i++) {
+            double M = M0[i] + n[i] * t;
+            M -= TWO_PI * std::floor(M / TWO_PI);
+
+            // Fixed-iteration Newton solve (no early exit -> no divergent lanes)
+            double E = M, sE, cE;
+            for (int k = 0; k < KEPLER_ITERATIONS; k++) {
+                fastSinCos(E, sE, cE);
+                E = E - (E - e[i] * sE - M) / (1 - e[i] * cE);
+            }
+            fastSinCos(E, sE, cE);
+
+            double P = a[i] * (cE - e[i]);
+            double Q = b[i] * sE;
+            x[i] = P * px[i] + Q * qx[i];
+            y[i] = P * py[i] + Q * qy[i];
+            z[i] = P * pz[i] + Q * qz[i];
+            if (VELOCITY) {
+                double Edot = n[i] / (1 - e[i] * cE);
+                double vP = -a[i] * sE * Edot, vQ = b[i] * cE * Edot;
+                vx[i] = vP * px[i] + vQ * qx[i];
+                vy[i] = vP * py[i] + vQ * qy[i];
+                vz[i] = vP * pz[i] + vQ * qz[i];
+            }
+        }
+    }
+};
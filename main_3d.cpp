@@ -1,5 +1,8 @@
 #include <SFML/Graphics.hpp>
 #include <bits/stdc++.h>
+#include "render_batch.hpp"
+#include "view_transform.hpp"
+#include "earth_lod.hpp"
 using namespace std;
 
 //--CONSTANTS---
@@ -8,22 +11,6 @@ const int WIDTH =1200;
 const int HEIGHT =900;
 const double R_EARTH =200.0;//Scaled down rad for drawingn 
 
-struct Point3D{
-    double x,y,z;
-};
-
-//---MATH HELPER : 3D ROTATION ---
-Point3D rotateX(Point3D p ,double angle ){//about X
-    return {p.x, p.y * cos(angle) - p.z * sin(angle), p.y * sin(angle) + p.z * cos(angle)};
-}
-Point3D rotateY(Point3D p, double angle) {
-    return {p.x * cos(angle) + p.z * sin(angle), p.y, -p.x * sin(angle) + p.z * cos(angle)};
-}
-Point3D rotateZ(Point3D p, double angle) {
-    return {p.x * cos(angle) - p.y * sin(angle), p.x * sin(angle) + p.y * cos(angle), p.z};
-}
-
-
 //--MAIN--
 
 int main(){
@@ -32,24 +19,19 @@ int main(){
     window.setFramerateLimit(60);
 
     //---Generate the earth mesh---
-    vector<Point3D> earthPoints;
-
-    //Lat Long Loops 
-    for (int lat = -90; lat <= 90; lat += 5) {//we can i guess make it increase by 5 or 1
-        double r_lat = cos(lat * M_PI / 180.0) * R_EARTH;
-        double y = sin(lat * M_PI / 180.0) * R_EARTH;
-
-        for (int lon = 0; lon < 360; lon += 5) {
-            double x = r_lat * cos(lon * M_PI / 180.0);
-            double z = r_lat * sin(lon * M_PI / 180.0);
-            earthPoints.push_back({x, y, z});
-        }
-    }
+    //Icosphere LODs in tiles: only tiles in front of the horizon and on screen
+    //are used, at the finest level that fits the point budget (Z/X zoom)
+    EarthLod earth(R_EARTH);
+    ProjectedPoints screen;
 
     //Camera Rotation angles
 
     double angleX=0.0;;
     double angleY =0.0;
+    double zoom = 1.0;
+
+    //All earth dots go out in one draw call
+    RenderBatch earthDots(sf::PrimitiveType::Triangles);
 
 
     while (window.isOpen()){
@@ -62,38 +44,24 @@ int main(){
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Right)) angleY += 0.03;
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Up))    angleX -= 0.03;
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Down))  angleX += 0.03;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Z))     zoom *= 1.02;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::X))     zoom *= 0.98;
 
         window.clear(sf::Color::Black);
 
         //--RENDER THE EARTH WOHHOOO!!---
 
-        //For every point : Rotate ->Project ->Draw //might be CPU intensive 
-
-        for (auto &p :earthPoints){
-            //Apply the Rotation (Camera View)
-
-            Point3D r = rotateY(p, angleY);
-            r = rotateX(r, angleX);
-
-            //Perspective Projetction 
-
-            double dist = 400.0;//Distance from camera to object
-            double scale =500.0/(dist - r.z);//The "Z- divide "(things get smaller )
-            
-            double screenX = r.x * scale + WIDTH / 2.0;
-            double screenY = r.y * scale + HEIGHT / 2.0;
-
-            //3.Draw Point 
-            //Make points darker if they are "behind " the sphere (FALSE LIGHTINIG HEHE)
-
-            sf::Color color = sf::Color::Cyan;
-            if (r.z > 0) color = sf::Color(0, 100, 100); // Back side dimmer
-            sf::RectangleShape dot({2, 2});
-            dot.setPosition({(float)screenX, (float)screenY});
-            dot.setFillColor(color);
-            window.draw(dot);
+        //Visible part of the mesh: Rotate ->Project in one pass, then batch (drawn once below)
+        //Perspective: scale = 500*zoom/(dist - z), camera 400 from the centre
+        ViewTransform view = ViewTransform::orbitCamera(angleX, angleY, 500.0 * zoom, 400.0, WIDTH / 2.0, HEIGHT / 2.0);
+        const PointCloud& earthPoints = earth.update(view, WIDTH, HEIGHT);   // back side is culled now
+        view.project(earthPoints, screen);
 
+        earthDots.clear();
+        for (size_t i = 0; i < earthPoints.size(); i++) {
+            earthDots.square({screen.sx[i], screen.sy[i]}, 2, sf::Color::Cyan);
         }
+        earthDots.draw(window);
 
 
         window.display();
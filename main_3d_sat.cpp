@@ -5,37 +5,44 @@
 #include <iomanip>
 #include <sstream> // For building UI strings
 #include <optional> // Required for SFML 3.0
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "work_stealing.hpp"
+#include "tle_catalog.hpp"
+#include "sgp4.hpp"
+#include "visibility_matrix.hpp"
+#include "render_batch.hpp"
+#include "trail_arena.hpp"
+#include "sim_thread.hpp"
+#include "view_transform.hpp"
+#include "earth_lod.hpp"
+#include "earth_raster.hpp"
+#include "ephemeris_cache.hpp"
+#include "checkpoint.hpp"
+#include "state_publisher.hpp"
+#define FRAME_PROFILER_COUNT_ALLOCATIONS
+#include "frame_profiler.hpp"
+#include <atomic>
+#include <algorithm>
+#include <thread>
 
 // --- 1. CONSTANTS ---
-const double G = 6.67430e-11;
-const double M_EARTH = 5.972e24;
-const double R_EARTH_REAL = 6371000.0; 
+const double R_EARTH_REAL = R_EARTH; 
 const double R_EARTH_VISUAL = 200.0;   
 const double SCALE = R_EARTH_VISUAL / R_EARTH_REAL;
-const double EARTH_ROTATION_SPEED = 7.2921159e-5; // rad/s (Real physics)
 
-// --- 2. 3D MATH HELPERS ---
-struct Vector3 {
-    double x, y, z;
-};
-
-// Rotation Functions
-Vector3 rotateX(Vector3 p, double angle) {
-    return {p.x, p.y * cos(angle) - p.z * sin(angle), p.y * sin(angle) + p.z * cos(angle)};
-}
-Vector3 rotateY(Vector3 p, double angle) {
-    return {p.x * cos(angle) + p.z * sin(angle), p.y, -p.x * sin(angle) + p.z * cos(angle)};
-}
+// --- 2. 3D MATH ---
+// Camera, earth spin and ECI -> visual axes are one ViewTransform matrix per
+// frame (view_transform.hpp); nothing is rotated point by point.
 
 // --- 3. ORBITAL STRUCTS ---
 struct OrbitalElements {
     std::string name;
     sf::Color color;
     double inclination; double raan; double ecc; double argPerigee; double meanAnomaly; double meanMotion;
-    std::vector<Vector3> trail; // Visual Trail
 };
 
-Vector3 getSatellitePosition(OrbitalElements oe, double t) {
+Vector3 getSatellitePosition(const OrbitalElements& oe, double t) {
     double M = fmod(oe.meanAnomaly + oe.meanMotion * t, 2 * M_PI);
     double E = M;
     for (int i = 0; i < 5; i++) E = E - (E - oe.ecc * sin(E) - M) / (1 - oe.ecc * cos(E));
@@ -45,8 +52,8 @@ Vector3 getSatellitePosition(OrbitalElements oe, double t) {
     double Q = a * sqrt(1 - oe.ecc * oe.ecc) * sin(E);
 
     double cO = cos(oe.raan), sO = sin(oe.raan), ci = cos(oe.inclination), si = sin(oe.inclination), cw = cos(oe.argPerigee), sw = sin(oe.argPerigee);
-    double x = P * (cO*cw - sO*si*sw) - Q * (cO*sw + sO*si*cw);
-    double y = P * (sO*cw + cO*si*sw) - Q * (sO*sw - cO*si*cw);
+    double x = P * (cO*cw - sO*ci*sw) - Q * (cO*sw + sO*ci*cw);
+    double y = P * (sO*cw + cO*ci*sw) - Q * (sO*sw - cO*ci*cw);
     double z = P * (si*sw)           + Q * (si*cw);
     return {x, y, z};
 }
@@ -66,8 +73,46 @@ Vector3 getCityPos(double lat, double lon, double time) {
     return {x, y, z};
 }
 
+// --- 5. CATALOG HELPER ---
+// Real TLEs -> OrbitalElements, every mean anomaly moved to the newest
+// epoch in the file so t = 0 is the same instant for all objects.
+void loadCatalogSats(const TleCatalog& catalog, std::vector<OrbitalElements>& sats) {
+    const sf::Color palette[] = {sf::Color::Cyan, sf::Color::Magenta, sf::Color::Red, sf::Color::Green, sf::Color::Yellow};
+    double refJD = catalog.latestEpochJD();
+    sats.clear();
+    sats.reserve(catalog.records.size());
+    for (size_t i = 0; i < catalog.records.size(); i++) {
+        const TleRecord& r = catalog.records[i];
+        sats.push_back({r.name[0] ? r.name : std::to_string(r.satnum), palette[i % 5],
+                        r.inclination, r.raan, r.ecc, r.argPerigee, r.meanAnomalyAt(refJD), r.meanMotion()});
+    }
+}
+
+// Built-in satellites have no TLE; give SGP4 the same mean elements with
+// no drag, epoch = t 0.
+TleRecord elementsToTle(const OrbitalElements& oe, int satnum) {
+    TleRecord r = {};
+    r.satnum = satnum;
+    r.epochYear = 2024;
+    r.epochDay = 1.0;
+    r.inclination = oe.inclination; r.raan = oe.raan; r.ecc = oe.ecc;
+    r.argPerigee = oe.argPerigee; r.meanAnomaly = oe.meanAnomaly;
+    r.revsPerDay = oe.meanMotion * SEC_PER_DAY / (2 * M_PI);
+    return r;
+}
 
-int main() {
+// One physics step's output, handed to the renderer through a TripleBuffer
+struct SkySnapshot {
+    double time = 0.0;
+    bool sgp4 = false;
+    std::vector<double> x, y, z;            // ECI [m], one per satellite
+    std::vector<double> speed;              // [m/s], the satellites listed in the HUD
+    size_t decayed = 0;                     // SGP4 objects with no position (NaN) this step
+    VisibilityStep links;
+    std::vector<uint64_t> homeVisible;      // station 0's row as a bitset
+};
+
+int main(int argc, char** argv) {
     sf::RenderWindow window(sf::VideoMode({1200, 900}), "OrbitView 3D | Agartala Station");
     window.setFramerateLimit(60);
     
@@ -89,30 +134,278 @@ int main() {
     hudText.setLineSpacing(1.2f);
 
     // --- SATELLITES ---
+    // Usage: ./orbit3d [catalog.tle] [--stations stations.txt] [--trace trace.json] [--checkpoint file.ckpt]
+    //                 [--publish /name]
+    // (CelesTrak TLE/3LE, re-read when it changes; --publish puts every
+    // physics step into a shared-memory ring, see state_publisher.hpp)
+    const char* catalogPath = nullptr;
+    const char* stationPath = nullptr;
+    const char* tracePath = nullptr;
+    std::string checkpointPath = "orbit3d.ckpt";
+    const char* publishName = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--stations" && i + 1 < argc) stationPath = argv[++i];
+        else if (std::string(argv[i]) == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (std::string(argv[i]) == "--checkpoint" && i + 1 < argc) checkpointPath = argv[++i];
+        else if (std::string(argv[i]) == "--publish" && i + 1 < argc) publishName = argv[++i];
+        else catalogPath = argv[i];
+    }
     std::vector<OrbitalElements> sats;
-    sats.push_back({"ISS", sf::Color::Cyan, 51.64*(M_PI/180), 247.46*(M_PI/180), 0.0006, 1.0, 0.0, 15.49*(2*M_PI/86400)}); 
-    sats.push_back({"Hubble", sf::Color::Magenta, 28.47*(M_PI/180), 100.0*(M_PI/180), 0.0003, 0.0, 0.0, 14.8*(2*M_PI/86400)}); 
-    sats.push_back({"GPS", sf::Color::Red, 55.0*(M_PI/180), 45.0*(M_PI/180), 0.01, 0.0, 0.0, 2.0*(2*M_PI/86400)}); 
+    TleCatalog catalog;
+    bool useCatalog = catalogPath && catalog.load(catalogPath) && !catalog.records.empty();
+    if (useCatalog) {
+        loadCatalogSats(catalog, sats);
+        std::cout << "Loaded " << sats.size() << " TLEs from " << catalogPath << " (" << catalog.badRecords << " rejected)" << std::endl;
+    } else {
+        if (catalogPath) std::cerr << "WARNING: Could not load TLE catalog " << catalogPath << ", using built-in satellites." << std::endl;
+        sats.push_back({"ISS", sf::Color::Cyan, 51.64*(M_PI/180), 247.46*(M_PI/180), 0.0006, 1.0, 0.0, 15.49*(2*M_PI/86400)}); 
+        sats.push_back({"Hubble", sf::Color::Magenta, 28.47*(M_PI/180), 100.0*(M_PI/180), 0.0003, 0.0, 0.0, 14.8*(2*M_PI/86400)}); 
+        sats.push_back({"GPS", sf::Color::Red, 55.0*(M_PI/180), 45.0*(M_PI/180), 0.01, 0.0, 0.0, 2.0*(2*M_PI/86400)}); 
+    }
+
+    // Batch propagator: per-object constants computed once, positions for
+    // every satellite filled in one pass per physics step
+    // SGP4 (M key) runs alongside: its init is cached per element set, and
+    // it is read through a Chebyshev cache of 15-minute windows, so a step
+    // evaluates polynomials instead of SGP4 (the next window is fitted in
+    // the background before the clock reaches it).
+    KeplerBatch satBatch;
+    std::vector<Sgp4> satSgp4;
+    double refJD = 0;
+    EphemerisCache sgp4Eph;
+    std::vector<sf::Vector2f> satScreen;
+    std::vector<char> satOnScreen;
+    // An element set SGP4 can't propagate (decayed, bad eccentricity) has
+    // no position: NaN, which the cache, visibility and drawing all skip
+    auto sgp4Source = [&](size_t i, double t) {
+        Vector3 p;
+        if (satSgp4[i].positionAt(refJD, t, p) != Sgp4::OK) {
+            p.x = p.y = p.z = std::numeric_limits<double>::quiet_NaN();
+        }
+        return p;
+    };
+    auto rebuildBatch = [&]() {
+        sgp4Eph.stopBackground();
+        satBatch.clear();
+        for (const auto& sat : sats) satBatch.add(sat.inclination, sat.raan, sat.ecc, sat.argPerigee, sat.meanAnomaly, sat.meanMotion);
+        satSgp4.assign(sats.size(), Sgp4());
+        if (useCatalog) {
+            refJD = catalog.latestEpochJD();
+            for (size_t i = 0; i < sats.size(); i++) satSgp4[i].init(catalog.records[i]);
+        } else {
+            for (size_t i = 0; i < sats.size(); i++) satSgp4[i].init(elementsToTle(sats[i], (int)i + 1));
+            refJD = satSgp4.empty() ? 0 : satSgp4[0].jdEpoch;
+        }
+        sgp4Eph.reset(sats.size(), sgp4Source);
+        satScreen.assign(sats.size(), {});
+        satOnScreen.assign(sats.size(), 0);
+    };
+    rebuildBatch();
+    // Large catalogs fan out across cores (3 sats run inline). The pool is
+    // not re-entrant, so physics and drawing each get their own.
+    WorkStealingPool simPool;
+    WorkStealingPool drawPool(std::max(1u, std::thread::hardware_concurrency() / 2));
+
+    // --- GROUND STATIONS ---
+    // Agartala is always station 0 (home); a station file adds the network.
+    std::vector<GroundStation> stations = {{23.83, 91.28, 0.0, 10.0}};
+    std::vector<std::string> stationNames = {"Agartala"};
+    if (stationPath && !loadStationFile(stationPath, stations, stationNames)) {
+        std::cerr << "WARNING: Could not read station list " << stationPath << std::endl;
+    }
+    VisibilityMatrix visibility(stations);
 
     // --- EARTH MESH ---
-    std::vector<Vector3> earthPoints;
-    for (int lat = -90; lat <= 90; lat += 5) {
-        for (int lon = 0; lon < 360; lon += 5) {
-            double r = R_EARTH_VISUAL;
-            double latRad = lat * M_PI / 180.0, lonRad = lon * M_PI / 180.0;
-            earthPoints.push_back({r * cos(latRad) * cos(lonRad), r * sin(latRad), r * cos(latRad) * sin(lonRad)});
+    // Icosphere levels of detail split into tiles: tiles behind the horizon
+    // or off screen are dropped first, then the finest level whose points
+    // in the remaining tiles fit the budget is used (finer as Z zooms in).
+    // SoA positions with unit normals, so lighting needs no sqrt per frame
+    EarthLod earthLod(R_EARTH_VISUAL);
+    ProjectedPoints earthScreen;
+
+    // --- TEXTURED EARTH ---
+    // earth.jpg on the sphere, drawn on the CPU (screen tiles on the draw
+    // pool) with per-pixel day/night shading and uploaded as one texture;
+    // T switches back to the dot mesh. While it is on, the sphere hides
+    // stations, satellites and trails behind it.
+    EarthRaster earthRaster(1200, 900);
+    {
+        sf::Image earthImage;
+        if (earthImage.loadFromFile("earth.jpg")) {
+            earthRaster.texture().setRGBA(earthImage.getPixelsPtr(), (int)earthImage.getSize().x, (int)earthImage.getSize().y);
+        } else {
+            std::cerr << "WARNING: Could not find earth.jpg, using a plain grid texture" << std::endl;
         }
     }
+    sf::Texture earthTexture({1200, 900});
+    sf::Sprite earthSprite(earthTexture);
+    bool texturedEarth = true;
+
+    // --- DRAW BATCHES ---
+    // One vertex batch per layer, refilled in place every frame
+    RenderBatch earthDots(sf::PrimitiveType::Triangles);
+    RenderBatch stationDots(sf::PrimitiveType::Triangles);
+    RenderBatch trailDots(sf::PrimitiveType::Points);
+    RenderBatch satDots(sf::PrimitiveType::Triangles);
+    RenderBatch laser(sf::PrimitiveType::Lines);
+    const int SAT_DISC_SEGMENTS = 8;
+    const size_t BIG_CATALOG = 1000;     // beyond this, satellites are 3 px squares
+    const size_t HUD_MAX = 8;            // satellites listed in the HUD
+
+    // --- TRAILS ---
+    // ECI history per satellite: 150 samples, ~8 s apart (every 5th frame
+    // at 100x), shortened to stay inside 64 MB for big catalogs
+    const uint32_t TRAIL_SAMPLES = 150;
+    const double TRAIL_INTERVAL = 5 * 100.0 / 60.0;
+    const size_t TRAIL_BUDGET = 64 << 20;
+    TrailArena trails(sats.size(), TRAIL_SAMPLES, TRAIL_INTERVAL, TRAIL_BUDGET);
 
     // --- THE SUN (Fixed Visual Position) ---
     Vector3 sunPos = {-800.0, 0.0, 0.0}; 
 
     double camAngleX = 0.3, camAngleY = 0.0, zoom = 1.0;
-    double time = 0.0, timeSpeed = 100.0;
+    const double timeSpeed = 100.0;
+    std::atomic<bool> useSgp4{false};
+    int frameCount = 0;
+
+    // --- FRAME PROFILER ---
+    // P shows the per-stage breakdown; --trace records the first 600
+    // frames as Chrome trace JSON.
+    FrameProfiler prof;
+    const int ST_EVENTS = prof.stage("events"), ST_PHYSICS = prof.stage("physics"), ST_SUN = prof.stage("sun");
+    const int ST_EARTH = prof.stage("earth"), ST_STATIONS = prof.stage("stations"), ST_SATS = prof.stage("satellites");
+    const int ST_LASERS = prof.stage("lasers"), ST_HUD = prof.stage("hud"), ST_DISPLAY = prof.stage("display");
+    const int CT_DRAWS = prof.counter("draw calls"), CT_POINTS = prof.counter("points transformed");
+    const int CT_PIXELS = prof.counter("earth pixels");
+    if (tracePath) prof.startTrace(tracePath, 600);
+
+    // --- CHECKPOINT ---
+    // K saves the sim time, the propagator, the element batch, the trails
+    // and the fitted SGP4 windows (copied on this thread, written in the
+    // background); starting again with the same catalog resumes there.
+    CheckpointWriter checkpointWriter;
+    Checkpoint checkpoint;
+    double resumeTime = 0.0;
+    {
+        CheckpointReader saved;
+        size_t n = 0;
+        bool intact = saved.open(checkpointPath.c_str()) && saved.verify();
+        const double* st = intact ? saved.get<double>("orbit3d.state", n) : nullptr;
+        // Sections restore into temporaries (the cache last, as a whole);
+        // nothing live changes unless every one of them fits this catalog
+        KeplerBatch savedBatch;
+        TrailArena savedTrails;
+        if (st && n == 1 && restoreKeplerBatch(saved, savedBatch) && savedBatch.size() == sats.size() &&
+            savedBatch.meanMotion == satBatch.meanMotion && restoreTrails(saved, savedTrails) &&
+            savedTrails.objects() == sats.size() && restoreEphemeris(saved, sgp4Eph, sgp4Source) &&
+            sgp4Eph.objects() == sats.size()) {
+            trails = std::move(savedTrails);
+            resumeTime = saved.header.simTime;
+            useSgp4.store(st[0] != 0);
+            std::cout << "Resumed from " << checkpointPath << " at t = " << resumeTime << " s" << std::endl;
+        } else if (saved.isOpen()) {
+            sgp4Eph.reset(sats.size(), sgp4Source);
+            std::cerr << "WARNING: " << checkpointPath << (intact ? " does not match this catalog" : " is corrupt")
+                      << ", starting fresh" << std::endl;
+        }
+    }
+
+    // --- PHYSICS THREAD ---
+    // Fixed 60 steps/s of timeSpeed/60 sim-seconds: propagation and the
+    // visibility matrix run here, writing straight into the snapshot being
+    // built; the render loop only projects and draws the latest one.
+    const double PHYSICS_RATE = 60.0;
+    double simTime = resumeTime;            // physics thread only
+    TripleBuffer<SkySnapshot> snapshots;
+    // External readers get positions, velocities and visibility flags of
+    // every step; velocities are only computed while publishing
+    StatePublisher publisher;
+    if (publishName && !publisher.open(publishName, satBatch.size())) {
+        std::cerr << "WARNING: Could not create shared memory " << publishName << std::endl;
+        publishName = nullptr;
+    }
+    auto physicsStep = [&]() {
+        PROFILE_SCOPE(prof, ST_PHYSICS);
+        simTime += timeSpeed / PHYSICS_RATE;
+        bool sgp4 = useSgp4.load();
+        SkySnapshot& snap = snapshots.back();
+        size_t n = satBatch.size();
+        snap.x.resize(n); snap.y.resize(n); snap.z.resize(n);
+        // A reloaded, bigger catalog gets a new object under the same name
+        if (publishName && n > publisher.capacity()) publisher.open(publishName, n);
+        StatePublisher::Slot out;
+        if (publisher.isOpen()) out = publisher.begin(simTime, n);
+        simPool.parallelFor(n, 1024, [&](size_t begin, size_t end) {
+            if (!sgp4) {
+                if (out.vx) satBatch.propagate(simTime, begin, end, snap.x.data(), snap.y.data(), snap.z.data(), out.vx, out.vy, out.vz);
+                else satBatch.propagate(simTime, begin, end, snap.x.data(), snap.y.data(), snap.z.data());
+                return;
+            }
+            sgp4Eph.positions(begin, end, simTime, snap.x.data(), snap.y.data(), snap.z.data(), out.vx, out.vy, out.vz);
+        });
+        if (sgp4) sgp4Eph.prefetch(simTime + sgp4Eph.window());
+        snap.decayed = sgp4 ? (size_t)std::count_if(snap.x.begin(), snap.x.end(), [](double v) { return v != v; }) : 0;
+        // HUD speeds: the series derivative for SGP4, vis-viva for Kepler
+        snap.speed.resize(std::min(n, HUD_MAX));
+        for (size_t i = 0; i < snap.speed.size(); i++) {
+            if (sgp4) {
+                Vector3 v;
+                sgp4Eph.position(i, simTime, &v);
+                snap.speed[i] = v.magnitude();
+            } else {
+                double dist = std::sqrt(snap.x[i] * snap.x[i] + snap.y[i] * snap.y[i] + snap.z[i] * snap.z[i]);
+                snap.speed[i] = std::sqrt(MU_EARTH * (2.0 / dist - 1.0 / satBatch.semiMajor[i]));
+            }
+        }
+        // Every station -> every satellite it can see
+        visibility.compute(simTime, EARTH_ROTATION_SPEED * simTime, snap.x.data(), snap.y.data(), snap.z.data(), n, snap.links, &simPool);
+        snap.links.toBitset(0, n, snap.homeVisible);
+        snap.time = simTime;
+        snap.sgp4 = sgp4;
+        if (out.x) {
+            std::copy(snap.x.begin(), snap.x.end(), out.x);
+            std::copy(snap.y.begin(), snap.y.end(), out.y);
+            std::copy(snap.z.begin(), snap.z.end(), out.z);
+            std::fill(out.flags, out.flags + n, 0);
+            for (uint32_t s : snap.links.sats) out.flags[s] = STATE_VISIBLE_ANY;
+            if (snap.links.stationCount() > 0) {
+                for (const uint32_t* p = snap.links.begin(0); p != snap.links.end(0); ++p) out.flags[*p] |= STATE_VISIBLE_HOME;
+            }
+            publisher.commit();
+        }
+        snapshots.publish();
+    };
+    FixedStepThread physics;
+    physics.start(PHYSICS_RATE, physicsStep);
+    sf::Clock frameClock;
+    double frameMs = 1000.0 / 60.0;
 
     while (window.isOpen()) {
+        prof.endFrame();
+        FrameProfiler::Sequence stages(prof);      // each next() closes the previous stage
+        stages.next(ST_EVENTS);
         while (const std::optional event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) window.close();
+            if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                if (key->scancode == sf::Keyboard::Scancode::M) useSgp4.store(!useSgp4.load());
+                if (key->scancode == sf::Keyboard::Scancode::P) prof.setEnabled(!prof.enabled());
+                if (key->scancode == sf::Keyboard::Scancode::T) texturedEarth = !texturedEarth;
+                if (key->scancode == sf::Keyboard::Scancode::K) {
+                    // The batch only changes with the physics thread stopped, the
+                    // trails are this thread's, the cache copies itself safely
+                    const SkySnapshot& now = snapshots.front();
+                    checkpoint.clear();
+                    checkpoint.simTime = now.time;
+                    checkpoint.step = (uint64_t)std::llround(now.time / (timeSpeed / PHYSICS_RATE));
+                    checkpoint.add("orbit3d.state", {now.sgp4 ? 1.0 : 0.0});
+                    saveKeplerBatch(checkpoint, satBatch);
+                    saveTrails(checkpoint, trails);
+                    saveEphemeris(checkpoint, sgp4Eph);
+                    if (checkpointWriter.submit(checkpoint, checkpointPath)) {
+                        std::cout << "Checkpoint at t = " << now.time << " s -> " << checkpointPath << std::endl;
+                    }
+                }
+            }
         }
 
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Left))  camAngleY -= 0.03;
@@ -122,127 +415,219 @@ int main() {
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Z)) zoom *= 1.02; 
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::X)) zoom *= 0.98;
 
-        time += (1.0 / 60.0) * timeSpeed;
+        frameMs += 0.1 * (frameClock.restart().asSeconds() * 1000.0 - frameMs);
+
+        // Pick up catalog edits every ~2 s (only changed records are re-parsed)
+        if (useCatalog && ++frameCount % 120 == 0) {
+            size_t changed = catalog.reload();
+            if (changed != TleCatalog::NO_FILE && changed > 0) {
+                physics.stop();             // the batch is the physics thread's
+                loadCatalogSats(catalog, sats);
+                rebuildBatch();
+                trails.reset(sats.size(), TRAIL_SAMPLES, TRAIL_INTERVAL, TRAIL_BUDGET, simTime);
+                physics.start(PHYSICS_RATE, physicsStep);
+            }
+        }
+
+        // Latest physics state; never waits for the physics thread. Until
+        // the first step after a (re)load lands, satellites are skipped.
+        snapshots.acquire();
+        const SkySnapshot& snap = snapshots.front();
+        const double time = snap.time;
+        const size_t satCount = snap.x.size() == sats.size() ? sats.size() : 0;
         window.clear(sf::Color::Black);
 
+        // Frame matrices: camera, earth spin, ECI (Z north) -> visual (Y up)
+        ViewTransform view = ViewTransform::orbitCamera(camAngleX, camAngleY, zoom * 600.0, 1000.0, 600, 450, 500);
+        ViewTransform earthView = view.withModel(Mat3::rotateY(-EARTH_ROTATION_SPEED * time));
+        const Mat3 ECI_TO_VISUAL = {{{SCALE, 0, 0}, {0, 0, SCALE}, {0, SCALE, 0}}};
+        ViewTransform orbitView = view.withModel(ECI_TO_VISUAL);
+        // Eye against the solid earth, in visual units (stations) and ECI
+        // metres (satellites, trails)
+        double eyeX, eyeY, eyeZ;
+        view.cameraInModel(eyeX, eyeY, eyeZ);
+        SphereOccluder stationOcc(eyeX, eyeY, eyeZ, R_EARTH_VISUAL);
+        SphereOccluder eciOcc(eyeX / SCALE, eyeZ / SCALE, eyeY / SCALE, R_EARTH_REAL);
+
         // --- 1. RENDER SUN ---
-        Vector3 sRot = rotateY(sunPos, camAngleY); sRot = rotateX(sRot, camAngleX);
-        double sScale = zoom * 600.0 / (1000.0 - sRot.z);
+        stages.next(ST_SUN);
+        float sunX, sunY;
+        double sunZ;
+        view.projectPoint(sunPos.x, sunPos.y, sunPos.z, sunX, sunY, &sunZ);
+        double sScale = zoom * 600.0 / (1000.0 - sunZ);
         sf::CircleShape sunShape(30 * sScale / 1.0); 
         sunShape.setFillColor(sf::Color(255, 179, 26));
-        sunShape.setPosition({(float)(sRot.x * sScale + 600), (float)(sRot.y * sScale + 450)});
+        sunShape.setPosition({sunX, sunY});
         sunShape.setOrigin({15, 15});
         window.draw(sunShape);
+        prof.add(CT_DRAWS, 1);
 
         // --- 2. RENDER EARTH ---
-        for (auto& p : earthPoints) {
-            // Earth Spin Logic
-            double theta = EARTH_ROTATION_SPEED * time;
-            double x_spin = p.x * cos(theta) - p.z * sin(theta);
-            double z_spin = p.x * sin(theta) + p.z * cos(theta);
-            Vector3 pSpin = {x_spin, p.y, z_spin};
-
-            Vector3 r = rotateY(pSpin, camAngleY); r = rotateX(r, camAngleX);
-            
-            // Lighting
-            double mag = sqrt(pSpin.x*pSpin.x + pSpin.y*pSpin.y + pSpin.z*pSpin.z);
-            Vector3 norm = {pSpin.x/mag, pSpin.y/mag, pSpin.z/mag};
-            double light = norm.x * -1.0; // Sun is at -X
-            
-            sf::Color c = (light > 0) ? sf::Color(230, 230, 60) : sf::Color(26, 26, 255);
-
-            double perspective = zoom * 600.0 / (1000.0 - r.z);
-            if (r.z < 500) {
-                sf::RectangleShape dot({2, 2});
-                dot.setPosition({(float)(r.x * perspective + 600), (float)(r.y * perspective + 450)});
-                dot.setFillColor(c);
-                window.draw(dot);
+        stages.next(ST_EARTH);
+        float lx, ly, lz;
+        earthView.lightInModel(-1.0, 0.0, 0.0, lx, ly, lz);     // Sun is at -X
+        if (texturedEarth) {
+            earthRaster.render(earthView, R_EARTH_VISUAL, lx, ly, lz, &drawPool);
+            earthTexture.update(earthRaster.rgba());
+            window.draw(earthSprite);
+            prof.add(CT_DRAWS, 1);
+            prof.add(CT_PIXELS, earthRaster.pixelsShaded());
+        } else {
+            // Tile culling + level choice, then one pass over what is left:
+            // transform, perspective divide, near-plane cull
+            const PointCloud& earthMesh = earthLod.update(earthView, 1200, 900);
+            earthView.project(earthMesh, earthScreen);
+            earthDots.clear();
+            for (size_t i = 0; i < earthMesh.size(); i++) {
+                if (!earthScreen.keep[i]) continue;
+                float light = earthMesh.nx[i] * lx + earthMesh.ny[i] * ly + earthMesh.nz[i] * lz;
+                sf::Color c = (light > 0) ? sf::Color(230, 230, 60) : sf::Color(26, 26, 255);
+                earthDots.square({earthScreen.sx[i], earthScreen.sy[i]}, 2, c);
             }
+            earthDots.draw(window);
+            prof.add(CT_DRAWS, 1);
+            prof.add(CT_POINTS, earthMesh.size());
         }
 
-        // --- 3. AGARTALA ---
-        Vector3 city3D = getCityPos(23.83, 91.28, time);
-        Vector3 cRot = rotateY(city3D, camAngleY); cRot = rotateX(cRot, camAngleX);
-        double cPersp = zoom * 600.0 / (1000.0 - cRot.z);
-        float cx = cRot.x * cPersp + 600;
-        float cy = cRot.y * cPersp + 450;
-        
-        if (cRot.z < 500) {
-            sf::CircleShape cityDot(5);
-            cityDot.setFillColor(sf::Color(255, 165, 0)); // Orange
-            cityDot.setPosition({cx, cy});
-            cityDot.setOrigin({2.5, 2.5});
-            window.draw(cityDot);
+        // --- 3. GROUND STATIONS ---
+        stages.next(ST_STATIONS);
+        std::vector<sf::Vector2f> stationScreen(stations.size());
+        std::vector<char> stationOnScreen(stations.size());
+        stationDots.clear();
+        for (size_t k = 0; k < stations.size(); k++) {
+            Vector3 city3D = getCityPos(stations[k].lat, stations[k].lon, time);
+            stationOnScreen[k] = view.projectPoint(city3D.x, city3D.y, city3D.z, stationScreen[k].x, stationScreen[k].y) &&
+                                 !(texturedEarth && stationOcc.hides((float)city3D.x, (float)city3D.y, (float)city3D.z));
+
+            if (stationOnScreen[k]) {
+                float radius = (k == 0) ? 5 : 3;
+                sf::Color c = k == 0 ? sf::Color(255, 165, 0) : sf::Color(255, 220, 120); // Orange = home
+                stationDots.disc({stationScreen[k].x + radius / 2, stationScreen[k].y + radius / 2}, radius, c);
+            }
         }
+        stationDots.draw(window);
+        prof.add(CT_DRAWS, 1);
+        prof.add(CT_POINTS, stations.size());
 
         // --- 4. SATELLITES & LINES ---
-        for (auto& sat : sats) {
-            Vector3 posM = getSatellitePosition(sat, time);
-            Vector3 posV = { posM.x * SCALE, posM.z * SCALE, posM.y * SCALE };
-            
-            // Trails
-            static int fc = 0;
-            if (fc++ % 5 == 0) {
-                sat.trail.push_back(posV);
-                if (sat.trail.size() > 150) sat.trail.erase(sat.trail.begin());
-            }
-            for (auto& tp : sat.trail) {
-                 Vector3 tr = rotateY(tp, camAngleY); tr = rotateX(tr, camAngleX);
-                 double tpP = zoom * 600.0 / (1000.0 - tr.z);
-                 sf::RectangleShape td({1, 1});
-                 td.setPosition({(float)(tr.x*tpP + 600), (float)(tr.y*tpP + 450)});
-                 td.setFillColor(sat.color);
-                 window.draw(td);
-            }
+        stages.next(ST_SATS);
+        // Trail sampling, projection and vertex fill share one parallel
+        // pass; each satellite owns fixed vertex slots for its marker and
+        // its trail.
+        const bool bigCatalog = satCount > BIG_CATALOG;
+        const size_t markerVerts = bigCatalog ? RenderBatch::SQUARE_VERTICES : 3 * SAT_DISC_SEGMENTS;
+        const uint32_t trailCap = trails.capacity();
+        satDots.clear();
+        trailDots.clear();
+        sf::Vertex* satVerts = satDots.alloc(satCount * markerVerts);
+        sf::Vertex* trailVerts = trailDots.alloc(satCount * trailCap);
+        drawPool.parallelFor(satCount, 1024, [&](size_t begin, size_t end) {
+            trails.pushRange(begin, end, time, snap.x.data(), snap.y.data(), snap.z.data());
+            std::vector<float> tsx(trailCap), tsy(trailCap);
 
-            // Draw Sat
-            Vector3 r = rotateY(posV, camAngleY); r = rotateX(r, camAngleX);
-            double sP = zoom * 600.0 / (1000.0 - r.z);
-            float sx = r.x * sP + 600;
-            float sy = r.y * sP + 450;
-            
-            if (r.z < 500) {
-                sf::CircleShape sDot(5); sDot.setFillColor(sat.color);
-                sDot.setPosition({sx, sy}); sDot.setOrigin({2.5, 2.5});
-                window.draw(sDot);
-
-                // --- LASER LINES (Agartala to Sat) ---
-                Vector3 vecToSat = {posV.x - city3D.x, posV.y - city3D.y, posV.z - city3D.z};
-                double cMag = sqrt(city3D.x*city3D.x + city3D.y*city3D.y + city3D.z*city3D.z);
-                double dot = (city3D.x/cMag * vecToSat.x) + (city3D.y/cMag * vecToSat.y) + (city3D.z/cMag * vecToSat.z);
-
-                if (dot > 0 && cRot.z < 500) { 
-                    sf::VertexArray line(sf::PrimitiveType::Lines, 2);
-                    line[0] = sf::Vertex{sf::Vector2f(cx, cy), sf::Color::White};
-                    line[1] = sf::Vertex{sf::Vector2f(sx, sy), sf::Color::White};
-                    window.draw(line);
-                } else if (cRot.z < 500) {
-                     sf::VertexArray line(sf::PrimitiveType::Lines, 2);
-                     line[0] = sf::Vertex{sf::Vector2f(cx, cy), sf::Color(100, 0, 0, 50)}; 
-                     line[1] = sf::Vertex{sf::Vector2f(sx, sy), sf::Color(100, 0, 0, 50)};
-                     window.draw(line);
+            for (size_t i = begin; i < end; i++) {
+                satOnScreen[i] = snap.x[i] == snap.x[i] && orbitView.projectPoint(snap.x[i], snap.y[i], snap.z[i], satScreen[i].x, satScreen[i].y) &&
+                                 !(texturedEarth && eciOcc.hides((float)snap.x[i], (float)snap.y[i], (float)snap.z[i]));
+                float sx = satScreen[i].x, sy = satScreen[i].y;
+                sf::Vertex* v = satVerts + i * markerVerts;
+                if (!satOnScreen[i]) RenderBatch::writeHidden(v, markerVerts);
+                else if (bigCatalog) RenderBatch::writeSquare(v, {sx - 1.5f, sy - 1.5f}, 3, sats[i].color);
+                else RenderBatch::writeDisc(v, {sx + 2.5f, sy + 2.5f}, 5, sats[i].color, SAT_DISC_SEGMENTS);
+
+                // Trail (drawn whether or not the satellite itself is in front)
+                // (points, so ring order does not matter: project the slots as stored)
+                uint32_t count = trails.size(i);
+                const TrailSample* ring = trails.ring(i);
+                orbitView.projectStrided(&ring->x, sizeof(TrailSample) / sizeof(float), count, tsx.data(), tsy.data());
+                sf::Vertex* tv = trailVerts + i * trailCap;
+                for (uint32_t k = 0; k < count; k++) tv[k] = sf::Vertex{{tsx[k], tsy[k]}, sats[i].color};
+                if (texturedEarth) {
+                    for (uint32_t k = 0; k < count; k++) {
+                        if (eciOcc.hides(ring[k].x, ring[k].y, ring[k].z)) RenderBatch::writeHidden(tv + k, 1);
+                    }
                 }
+                RenderBatch::writeHidden(tv + count, trailCap - count);
+            }
+        });
+        trailDots.draw(window);
+        satDots.draw(window);
+        prof.add(CT_DRAWS, 2);
+        prof.add(CT_POINTS, satCount + trailDots.size());
+
+        // --- LASER LINES (every station -> every satellite it can see) ---
+        stages.next(ST_LASERS);
+        laser.clear();
+        for (size_t k = 0; satCount && k < stations.size(); k++) {
+            if (!stationOnScreen[k]) continue;
+            for (const uint32_t* it = snap.links.begin(k); it != snap.links.end(k); ++it) {
+                if (!satOnScreen[*it]) continue;
+                laser.line(stationScreen[k], satScreen[*it], sf::Color::White);
             }
         }
+        // Home station also shows faint links to what it can't see
+        if (satCount && stationOnScreen[0]) {
+            for (size_t i = 0; i < satCount; i++) {
+                if (!satOnScreen[i] || (snap.homeVisible[i >> 6] >> (i & 63) & 1)) continue;
+                laser.line(stationScreen[0], satScreen[i], sf::Color(100, 0, 0, 50));
+            }
+        }
+        laser.draw(window);
+        prof.add(CT_DRAWS, 1);
 
         // --- 5. RENDER UI (HUD) ---
+        stages.next(ST_HUD);
         std::stringstream ss;
         ss << "=== ORBITVIEW 3D SYSTEM ===\n";
         ss << "Location: Agartala (23.83 N, 91.28 E)\n";
+        ss << "Stations: " << stations.size() << " | Links: " << snap.links.pairs() << "\n";
         ss << "Simulation Speed: " << (int)timeSpeed << "x\n";
-        ss << "Zoom Level: " << std::fixed << std::setprecision(2) << zoom << "x\n\n";
+        ss << "Propagator: " << (snap.sgp4 ? "SGP4/SDP4" : "Kepler") << " (M to toggle)\n";
+        if (snap.sgp4) {
+            uint64_t hits = sgp4Eph.hits(), lookups = hits + sgp4Eph.misses();
+            ss << "Ephemeris cache: " << std::fixed << std::setprecision(1) << (lookups ? 100.0 * hits / lookups : 0.0)
+               << "% hits | " << sgp4Eph.bytes() / 1e6 << " MB | err < " << std::setprecision(2)
+               << sgp4Eph.maxErrorEstimate() << " m\n";
+            if (snap.decayed) ss << "Decayed (no SGP4 solution): " << snap.decayed << "\n";
+        }
+        ss << "Physics: " << (int)physics.measuredRate() << " steps/s (" << std::fixed << std::setprecision(2)
+           << physics.stepSeconds() * 1000.0 << " ms) | Frame: " << std::setprecision(1) << frameMs << " ms\n";
+        ss << "Zoom Level: " << std::fixed << std::setprecision(2) << zoom << "x | ";
+        if (texturedEarth) {
+            ss << "Earth: textured (" << earthRaster.tilesShaded() << "/" << earthRaster.tileCount() << " tiles, "
+               << earthRaster.pixelsShaded() << " px) (T for dots)\n\n";
+        } else {
+            ss << "Earth LOD " << earthLod.level() << " (" << earthLod.visibleTiles() << "/" << earthLod.tileCount()
+               << " tiles, " << earthLod.points().size() << " pts) (T for texture)\n\n";
+        }
         
         ss << "[ SATELLITE STATUS ]\n";
-        for (const auto& sat : sats) {
-            Vector3 p = getSatellitePosition(sat, time);
-            double dist = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        for (size_t i = 0; i < satCount && i < snap.speed.size(); i++) {
+            const auto& sat = sats[i];
+            Vector3 p = {snap.x[i], snap.y[i], snap.z[i]};
+            double dist = p.magnitude();
             double altKm = (dist - R_EARTH_REAL) / 1000.0;
-            double v = std::sqrt(G * M_EARTH * (2.0/dist - 1.0/std::pow(G*M_EARTH/(sat.meanMotion*sat.meanMotion), 1.0/3.0)));
+            double v = snap.speed[i];
             
             ss << "> " << sat.name << "\n";
+            if (dist != dist) { ss << "   Decayed\n\n"; continue; }
             ss << "   Alt: " << (int)altKm << " km\n";
             ss << "   Vel: " << (int)(v/1000.0) << " km/s\n\n";
         }
+        if (sats.size() > HUD_MAX) ss << "... and " << sats.size() - HUD_MAX << " more\n";
+        if (prof.enabled()) {
+            ss << "\n[ FRAME PROFILE ] (P to hide, " << FrameProfiler::HISTORY << "-frame mean)\n" << std::setprecision(2);
+            for (size_t s = 0; s < prof.stageCount(); s++) {
+                ss << "   " << std::left << std::setw(11) << prof.stageName((int)s) << std::right << std::setw(7)
+                   << prof.stageMs((int)s) << " ms\n";
+            }
+            ss << "   " << std::left << std::setw(11) << "frame" << std::right << std::setw(7) << prof.frameMs() << " ms\n";
+            for (size_t c = 0; c < prof.counterCount(); c++) {
+                ss << "   " << prof.counterName((int)c) << ": " << std::setprecision(0) << prof.counterPerFrame((int)c) << "\n";
+            }
+            if (prof.isTracing()) ss << "   (recording trace)\n";
+        } else {
+            ss << "\nP: frame profile\n";
+        }
         hudText.setString(ss.str());
 
         // Background Box for UI
@@ -253,7 +638,12 @@ int main() {
         
         window.draw(bg);
         window.draw(hudText);
+        prof.add(CT_DRAWS, 2);
 
+        stages.next(ST_DISPLAY);
         window.display();
     }
+    physics.stop();
+    prof.stopTrace();
+    if (!checkpointWriter.wait()) std::cerr << "WARNING: Could not write " << checkpointPath << std::endl;
 }
\ No newline at end of file
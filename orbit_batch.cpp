@@ -0,0 +1,351 @@
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "tle_catalog.hpp"
+#include "sgp4.hpp"
+#include "integrators.hpp"
+#include "force_models.hpp"
+#include "work_stealing.hpp"
+#include "trajectory_stream.hpp"
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <algorithm>
+#include <limits>
+
+// Headless batch propagation: config in, binary trajectory stream out.
+//
+// Build: clang++ orbit_batch.cpp -o orbit_batch -std=c++17 -O3 -march=native -fno-trapping-math -pthread
+//
+//   ./orbit_batch run.cfg [key=value ...]      (keys below; command line wins)
+//   ./orbit_batch --dump traj.bin [frame]      (print one decoded frame as text)
+//
+// Config keys (one "key = value" per line, '#' comments):
+//   catalog    = file.tle       TLE/3LE source; otherwise `objects` synthetic LEO orbits
+//   objects    = 10000          synthetic object count
+//   seed       = 1
+//   model      = kepler         kepler | sgp4 | integrate
+//   integrator = fr             euler | verlet | fr | y6 | rk4 | dp54   (model = integrate)
+//   step       = 0              integrator step [s] (0 = method default)
+//   forces     = twobody        twobody | j2 | zonal6 | full (J2..J6, drag from B*, Sun/Moon)
+//   start      = 0              s after the newest TLE epoch (or t = 0)
+//   end        = 86400
+//   cadence    = 60             s between output frames
+//   output     = traj.bin
+//   encoding   = f64            f64 | f32delta
+//   threads    = 0              0 = all cores
+
+struct BatchConfig {
+    std::string catalog;
+    size_t objects = 10000;
+    unsigned seed = 1;
+    std::string model = "kepler";
+    std::string integrator = "fr";
+    std::string forces = "twobody";
+    double step = 0;
+    double start = 0, end = 86400, cadence = 60;
+    std::string output = "traj.bin";
+    std::string encoding = "f64";
+    unsigned threads = 0;
+
+    bool set(const std::string& key, const std::string& value) {
+        if (key == "catalog") catalog = value;
+        else if (key == "objects") objects = std::strtoul(value.c_str(), nullptr, 10);
+        else if (key == "seed") seed = (unsigned)std::strtoul(value.c_str(), nullptr, 10);
+        else if (key == "model") model = value;
+        else if (key == "integrator") integrator = value;
+        else if (key == "forces") forces = value;
+        else if (key == "step") step = std::atof(value.c_str());
+        else if (key == "start") start = std::atof(value.c_str());
+        else if (key == "end") end = std::atof(value.c_str());
+        else if (key == "cadence") cadence = std::atof(value.c_str());
+        else if (key == "output") output = value;
+        else if (key == "encoding") encoding = value;
+        else if (key == "threads") threads = (unsigned)std::strtoul(value.c_str(), nullptr, 10);
+        else return false;
+        return true;
+    }
+
+    // "key = value" (spaces optional); false on an unknown key
+    bool parseLine(const char* line) {
+        std::string s(line);
+        size_t hash = s.find('#');
+        if (hash != std::string::npos) s.resize(hash);
+        size_t eq = s.find('=');
+        if (eq == std::string::npos) return true;
+        auto trim = [](std::string v) {
+            size_t a = v.find_first_not_of(" \t\r\n"), b = v.find_last_not_of(" \t\r\n");
+            return a == std::string::npos ? std::string() : v.substr(a, b - a + 1);
+        };
+        std::string key = trim(s.substr(0, eq)), value = trim(s.substr(eq + 1));
+        if (key.empty()) return true;
+        if (!set(key, value)) { std::fprintf(stderr, "Unknown config key '%s'\n", key.c_str()); return false; }
+        return true;
+    }
+
+    bool load(const char* path) {
+        FILE* f = std::fopen(path, "r");
+        if (!f) return false;
+        char line[512];
+        bool ok = true;
+        while (std::fgets(line, sizeof(line), f)) ok &= parseLine(line);
+        std::fclose(f);
+        return ok;
+    }
+};
+
+bool parseIntegrator(const std::string& name, IntegratorKind& kind) {
+    const char* NAMES[] = {"euler", "verlet", "fr", "y6", "rk4", "dp54"};
+    for (int k = 0; k < INTEGRATOR_KIND_COUNT; k++) {
+        if (name == NAMES[k]) { kind = (IntegratorKind)k; return true; }
+    }
+    return false;
+}
+
+// Per-object drag parameter, for the force models that have one
+template <class Force> void setBallistic(Force&, double) {}
+template <class... T> void setBallistic(ForceModel<T...>& f, double b) {
+    if constexpr ((std::is_same_v<T, Drag> || ...)) f.ballistic = b;
+}
+
+// Two frame buffers: the pool fills one while this thread writes the other
+class FrameWriterThread {
+public:
+    explicit FrameWriterThread(TrajectoryWriter& w) : writer(w), worker([this] { loop(); }) {}
+
+    ~FrameWriterThread() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    // Hand over a filled frame; blocks while the previous one is still being written
+    void submit(double t, std::vector<double>& x, std::vector<double>& y, std::vector<double>& z) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return !full; });
+        ft = t;
+        fx.swap(x); fy.swap(y); fz.swap(z);
+        full = true;
+        cv.notify_all();
+    }
+
+    void drain() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this] { return !full; });
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        for (;;) {
+            cv.wait(lock, [this] { return full || quit; });
+            if (!full) return;
+            lock.unlock();
+            writer.writeFrame(ft, fx.data(), fy.data(), fz.data());
+            lock.lock();
+            full = false;
+            cv.notify_all();
+        }
+    }
+
+    TrajectoryWriter& writer;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool full = false, quit = false;
+    double ft = 0;
+    std::vector<double> fx, fy, fz;
+    std::thread worker;
+};
+
+int dump(const char* path, long frame) {
+    TrajectoryReader reader;
+    if (!reader.open(path)) { std::fprintf(stderr, "Cannot read trajectory %s\n", path); return 1; }
+    std::printf("# %llu objects, %llu frames, %s, t0 %.1f s, cadence %.1f s\n", (unsigned long long)reader.objects(),
+                (unsigned long long)reader.frameCount(), reader.header.encoding ? "f32delta" : "f64",
+                reader.header.startTime, reader.header.cadence);
+    double t;
+    for (long k = 0; reader.next(t); k++) {
+        if (k != frame) continue;
+        std::printf("# t[s] satnum x[km] y[km] z[km]\n");
+        for (size_t i = 0; i < reader.objects(); i++) {
+            std::printf("%.1f %u %.3f %.3f %.3f\n", t, reader.ids[i], reader.x[i] / 1000.0, reader.y[i] / 1000.0, reader.z[i] / 1000.0);
+        }
+        return 0;
+    }
+    std::fprintf(stderr, "Frame %ld not in file\n", frame);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::strcmp(argv[1], "--dump") == 0) return dump(argv[2], argc > 3 ? std::atol(argv[3]) : 0);
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s run.cfg [key=value ...] | --dump traj.bin [frame]\n", argv[0]);
+        return 1;
+    }
+
+    BatchConfig cfg;
+    if (std::strchr(argv[1], '=') == nullptr && !cfg.load(argv[1])) { std::fprintf(stderr, "Bad config %s\n", argv[1]); return 1; }
+    for (int i = 1; i < argc; i++) {
+        if (std::strchr(argv[i], '=') && !cfg.parseLine(argv[i])) return 1;
+    }
+    if (cfg.cadence <= 0 || cfg.end < cfg.start) { std::fprintf(stderr, "Need cadence > 0 and end >= start\n"); return 1; }
+
+    // --- OBJECTS ---
+    // Synthetic runs get TLE-shaped records too, so every model has one source
+    TleCatalog catalog;
+    std::vector<TleRecord> records;
+    double refJD = 2460310.5;       // 2024-01-01 00:00 UTC, the synthetic epoch
+    if (!cfg.catalog.empty()) {
+        if (!catalog.load(cfg.catalog.c_str()) || catalog.records.empty()) { std::fprintf(stderr, "Cannot read %s\n", cfg.catalog.c_str()); return 1; }
+        records = catalog.records;
+        refJD = catalog.latestEpochJD();
+    } else {
+        std::mt19937_64 rng(cfg.seed);
+        std::uniform_real_distribution<double> U(0.0, 1.0);
+        for (size_t i = 0; i < cfg.objects; i++) {
+            TleRecord r = {};
+            r.satnum = (int)(i + 1);
+            r.epochYear = 2024;
+            r.epochDay = 1.0;
+            r.inclination = U(rng) * M_PI;
+            r.raan = U(rng) * 2 * M_PI;
+            r.ecc = U(rng) * 0.02;
+            r.argPerigee = U(rng) * 2 * M_PI;
+            r.meanAnomaly = U(rng) * 2 * M_PI;
+            r.revsPerDay = 12.0 + U(rng) * 4.0;
+            records.push_back(r);
+        }
+    }
+    size_t N = records.size();
+    KeplerBatch batch;
+    std::vector<uint32_t> ids(N);
+    batch.reserve(N);
+    for (size_t i = 0; i < N; i++) {
+        const TleRecord& r = records[i];
+        batch.add(r.inclination, r.raan, r.ecc, r.argPerigee, r.meanAnomalyAt(refJD), r.meanMotion());
+        ids[i] = (uint32_t)r.satnum;
+    }
+
+    std::vector<Sgp4> sgp;
+    if (cfg.model == "sgp4") {
+        sgp.resize(N);
+        for (size_t i = 0; i < N; i++) sgp[i].init(records[i]);
+    } else if (cfg.model != "kepler" && cfg.model != "integrate") {
+        std::fprintf(stderr, "Unknown model '%s'\n", cfg.model.c_str());
+        return 1;
+    }
+    if (cfg.encoding != "f64" && cfg.encoding != "f32delta") {
+        std::fprintf(stderr, "Unknown encoding '%s'\n", cfg.encoding.c_str());
+        return 1;
+    }
+
+    // Integrated objects start from the analytic state at `start`
+    std::vector<OrbitState> states;
+    std::vector<Integrator> integrators;
+    std::vector<double> ballistic;         // Cd A / m from B* (full force model)
+    if (cfg.model == "integrate") {
+        if (cfg.forces != "twobody" && cfg.forces != "j2" && cfg.forces != "zonal6" && cfg.forces != "full") {
+            std::fprintf(stderr, "Unknown force model '%s'\n", cfg.forces.c_str());
+            return 1;
+        }
+        IntegratorKind kind;
+        if (!parseIntegrator(cfg.integrator, kind)) {
+            std::fprintf(stderr, "Unknown integrator '%s'\n", cfg.integrator.c_str());
+            return 1;
+        }
+        Integrator proto(kind);
+        if (cfg.step > 0) proto.dt = cfg.step;
+        integrators.assign(N, proto);
+        states.resize(N);
+        std::vector<double> px(N), py(N), pz(N), vx(N), vy(N), vz(N);
+        batch.propagate(cfg.start, 0, N, px.data(), py.data(), pz.data(), vx.data(), vy.data(), vz.data());
+        for (size_t i = 0; i < N; i++) states[i] = {{px[i], py[i], pz[i]}, {vx[i], vy[i], vz[i]}};
+        // B* = rho0 * B / 2 with rho0 = 0.15696615 kg/m^2/ER; no B* -> a typical 0.01 m^2/kg
+        ballistic.resize(N);
+        for (size_t i = 0; i < N; i++) ballistic[i] = records[i].bstar > 0 ? 2.0 * records[i].bstar / 0.15696615 : 0.01;
+    }
+
+    // --- OUTPUT ---
+    TrajectoryEncoding enc = cfg.encoding == "f32delta" ? TrajectoryEncoding::F32_DELTA : TrajectoryEncoding::F64;
+    TrajectoryWriter writer;
+    if (!writer.open(cfg.output.c_str(), N, ids.data(), enc, cfg.start, cfg.cadence)) {
+        std::fprintf(stderr, "Cannot write %s\n", cfg.output.c_str());
+        return 1;
+    }
+
+    WorkStealingPool pool(cfg.threads ? cfg.threads : std::thread::hardware_concurrency());
+    std::vector<double> x(N), y(N), z(N);
+    // SGP4 objects without a solution (decayed, bad elements) are written as
+    // NaN from the first frame that fails; counted once per object
+    std::vector<char> lost(N, 0);
+    long frames = (long)std::floor((cfg.end - cfg.start) / cfg.cadence + 1e-9) + 1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        FrameWriterThread out(writer);
+        double prevT = cfg.start;
+        for (long f = 0; f < frames; f++) {
+            double t = cfg.start + f * cfg.cadence;
+            pool.parallelFor(N, 2048, [&](size_t begin, size_t end) {
+                if (cfg.model == "kepler") {
+                    batch.propagate(t, begin, end, x.data(), y.data(), z.data());
+                } else if (cfg.model == "sgp4") {
+                    for (size_t i = begin; i < end; i++) {
+                        Vector3 p;
+                        if (sgp[i].positionAt(refJD, t, p) != Sgp4::OK) {
+                            p.x = p.y = p.z = std::numeric_limits<double>::quiet_NaN();
+                            lost[i] = 1;
+                        }
+                        x[i] = p.x; y[i] = p.y; z[i] = p.z;
+                    }
+                } else {
+                    // One specialised kernel per force model, chosen once per chunk
+                    auto run = [&](auto force) {
+                        for (size_t i = begin; i < end; i++) {
+                            setBallistic(force, ballistic[i]);
+                            integrators[i].advance(states[i], prevT, t - prevT, force);
+                            x[i] = states[i].pos.x; y[i] = states[i].pos.y; z[i] = states[i].pos.z;
+                        }
+                    };
+                    if (cfg.forces == "j2") run(ForceModel<TwoBody, J2>());
+                    else if (cfg.forces == "zonal6") run(ForceModel<TwoBody, Zonal<6>>());
+                    else if (cfg.forces == "full") {
+                        ForceModel<TwoBody, Zonal<6>, Drag, ThirdBody> full;
+                        full.jd0 = refJD;
+                        run(full);
+                    }
+                    else run(TwoBodyForce());
+                }
+            });
+            prevT = t;
+            out.submit(t, x, y, z);
+            // submit() swapped in the writer's previous buffers; keep them sized
+            if (x.size() != N) { x.resize(N); y.resize(N); z.resize(N); }
+        }
+        out.drain();
+    }
+    bool ok = writer.close();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t evals = 0;
+    for (const auto& in : integrators) evals += in.forceEvaluations();
+    double mb = writer.bytesWritten() / 1e6;
+    std::fprintf(stderr, "%zu objects x %ld frames (%s, %s) -> %s: %.1f MB in %.2f s | %.0f MB/s | %.2e object-frames/s",
+                 N, frames, cfg.model.c_str(), cfg.encoding.c_str(), cfg.output.c_str(), mb, sec, mb / sec, N * (double)frames / sec);
+    if (evals) std::fprintf(stderr, " | %.2e force evals", (double)evals);
+    size_t lostCount = (size_t)std::count(lost.begin(), lost.end(), 1);
+    if (lostCount) std::fprintf(stderr, " | %zu decayed or invalid (NaN)", lostCount);
+    std::fprintf(stderr, "\n");
+    if (!ok) { std::fprintf(stderr, "Write error on %s\n", cfg.output.c_str()); return 1; }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cmath>
+
+// --- SHARED PHYSICS CONSTANTS ---
+const double G = 6.67430e-11;
+const double M_EARTH = 5.972e24;
+const double MU_EARTH = G * M_EARTH;               // m^3/s^2
+const double R_EARTH = 6371000.0;                  // in meters
+const double EARTH_ROTATION_SPEED = 7.2921159e-5;  // rad/s (Real physics)
+
+// --- VECTOR HELPER ---
+struct Vector3 {
+    double x = 0, y = 0, z = 0;
+
+    // Overload for cleaner math
+    Vector3 operator+(const Vector3& other) const { return {x+other.x, y+other.y, z+other.z}; }
+    Vector3 operator-(const Vector3& other) const { return {x-other.x, y-other.y, z-other.z}; }
+    Vector3 operator*(double s) const { return {x*s, y*s, z*s}; }
+    double dot(const Vector3& o) const { return x*o.x + y*o.y + z*o.z; }
+    double magnitude() const { return std::sqrt(x*x + y*y + z*z); }
+};
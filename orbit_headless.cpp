@@ -0,0 +1,424 @@
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include "tle_catalog.hpp"
+#include "sgp4.hpp"
+#include "pass_predictor.hpp"
+#include "conjunction.hpp"
+#include "debris_cloud.hpp"
+#include "state_publisher.hpp"
+#include "earth_raster.hpp"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <thread>
+
+// Headless propagation tool (no SFML).
+//
+// Build: clang++ orbit_headless.cpp -o orbit_headless -std=c++17 -O3 -march=native -fno-trapping-math -fno-math-errno -pthread
+//
+//   ./orbit_headless catalog.tle [--model kepler|sgp4] [--hours H] [--step S]
+//        print positions (km) every S seconds for H hours after the newest epoch
+//   ./orbit_headless catalog.tle --passes LAT,LON[,MASK] [--model kepler|sgp4] [--hours H]
+//        list AOS / culmination / LOS over a ground station instead
+//   ./orbit_headless catalog.tle --conjunctions KM [--hours H]
+//        every pair closer than KM within H hours (two-body elements)
+//   ./orbit_headless catalog.tle --breakup SATNUM,FRAGMENTS[,DV[,MUTUAL]] [--hours H] [--step S]
+//        break SATNUM up into FRAGMENTS pieces (median delta-v DV m/s, default
+//        10) and follow the cloud (J2, Sun/Moon, mutual gravity if MUTUAL is 1)
+//   ./orbit_headless --subscribe /name [SECONDS]
+//        follow a running viewer's --publish ring: one summary line every
+//        SECONDS (default 1) until its frames stop
+//   ./orbit_headless --render PREFIX [FRAMES] [TEXTURE.ppm]
+//        export FRAMES (default 240) 1200x900 frames of the textured,
+//        sunlit earth over one day as PREFIX0000.ppm ... (the viewer's
+//        camera; TEXTURE.ppm e.g. from `convert earth.jpg earth.ppm`)
+//   ./orbit_headless --verify
+//        check SGP4/SDP4 against the published verification vectors
+//   ./orbit_headless --bench [objects]
+//        propagations/s for Kepler batch vs SGP4 (init cost reported separately)
+
+enum class Model { Kepler, Sgp4 };
+
+// --- SGP4 VERIFICATION (Vallado et al. 2006, SGP4-VER.TLE / tcppver.out) ---
+struct VerifyCase {
+    const char* line1;
+    const char* line2;
+    double tsince;              // min
+    double r[3];                // km
+    double v[3];                // km/s
+    bool checkVelocity = true;
+};
+
+const VerifyCase VERIFY_CASES[] = {
+    // 00005: near-earth, e = 0.186
+    {"1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+     "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667",
+     0.0, {7022.46529266, -1400.08296755, 0.03995155}, {1.893841015, 6.405893759, 4.534807250}},
+    {"1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+     "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667",
+     360.0, {-7154.03120202, -3783.17682504, -3536.19412294}, {4.741887409, -4.151817765, -2.093935425}},
+    {"1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+     "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667",
+     720.0, {-7134.59340119, 6531.68641334, 3260.27186483}, {-4.113793027, -2.911922039, -2.557327851}},
+    {"1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+     "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667",
+     1080.0, {5568.53901181, 4492.06992591, 3863.87641983}, {-4.209106476, 5.159719888, 2.744852980}},
+    // 11801: deep space (SDP4), e = 0.73, non-standard format (checksum not valid in the test file)
+    {"1 11801U          80230.29629788  .01431103  00000-0  14311-1      13",
+     "2 11801  46.7916 230.4354 7318036  47.4722  10.4117  2.28537848    13",
+     0.0, {7473.37102491, 428.94748312, 5828.74846783}, {5.107155391, 6.444680305, -0.186133297}},
+    // ... propagated through SDP4 (positions only)
+    {"1 11801U          80230.29629788  .01431103  00000-0  14311-1      13",
+     "2 11801  46.7916 230.4354 7318036  47.4722  10.4117  2.28537848    13",
+     720.0, {14271.29083858, 24110.44309009, -4725.76320143}, {0, 0, 0}, false},
+    {"1 11801U          80230.29629788  .01431103  00000-0  14311-1      13",
+     "2 11801  46.7916 230.4354 7318036  47.4722  10.4117  2.28537848    13",
+     1440.0, {9787.87836256, 33753.32249667, -15030.79874625}, {0, 0, 0}, false},
+    // 14128: 24 h resonance (geosynchronous), tcppver.out rows
+    {"1 14128U 83058A   06176.02844893 -.00000158  00000-0  10000-3 0  9627",
+     "2 14128  11.4384  35.2134 0011562  26.4582 333.5652  0.98870114 46093",
+     0.0, {34747.57932696, 24502.37114079, -1.32832986}, {-1.731642662, 2.452772615, 0.608510081}},
+    {"1 14128U 83058A   06176.02844893 -.00000158  00000-0  10000-3 0  9627",
+     "2 14128  11.4384  35.2134 0011562  26.4582 333.5652  0.98870114 46093",
+     1440.0, {36366.59147396, 22023.54245720, -601.47121821}, {-1.549681546, 2.571788981, 0.607057418}},
+    {"1 14128U 83058A   06176.02844893 -.00000158  00000-0  10000-3 0  9627",
+     "2 14128  11.4384  35.2134 0011562  26.4582 333.5652  0.98870114 46093",
+     2880.0, {37802.25393045, 19433.57330019, -1198.66634226}, {-1.359930580, 2.677830903, 0.602507466}},
+    // 09880: 12 h resonance (Molniya, e = 0.71), tcppver.out rows
+    {"1 09880U 77021A   06176.56157475  .00000421  00000-0  10000-3 0  9814",
+     "2 09880  64.5968 349.3786 7069051 270.0229  16.3320  2.00813614112380",
+     0.0, {13020.06750784, -2449.07193500, 1.15896030}, {4.247363935, 1.597178501, 4.956708611}},
+    {"1 09880U 77021A   06176.56157475  .00000421  00000-0  10000-3 0  9814",
+     "2 09880  64.5968 349.3786 7069051 270.0229  16.3320  2.00813614112380",
+     1440.0, {14369.90303735, -1903.85601062, 1722.15319852}, {3.543393116, 1.701687176, 4.913881358}},
+    {"1 09880U 77021A   06176.56157475  .00000421  00000-0  10000-3 0  9814",
+     "2 09880  64.5968 349.3786 7069051 270.0229  16.3320  2.00813614112380",
+     2880.0, {15500.53445068, -1332.90981042, 3419.72315308}, {2.960917974, 1.758331634, 4.813698638}},
+};
+
+// Fields only; the verification file has records with deliberately odd checksums
+TleRecord tleFromLinesUnchecked(const char* l1, const char* l2) {
+    TleRecord rec = {};
+    const double DEG = M_PI / 180.0;
+    rec.satnum = (int)tleNumber(l1, 3, 7);
+    int yy = (int)tleNumber(l1, 19, 20);
+    rec.epochYear = yy < 57 ? 2000 + yy : 1900 + yy;
+    rec.epochDay = tleNumber(l1, 21, 32);
+    rec.bstar = tleExponent(l1, 54, 61);
+    rec.inclination = tleNumber(l2, 9, 16) * DEG;
+    rec.raan = tleNumber(l2, 18, 25) * DEG;
+    rec.ecc = tleNumber(l2, 27, 33) * 1e-7;
+    rec.argPerigee = tleNumber(l2, 35, 42) * DEG;
+    rec.meanAnomaly = tleNumber(l2, 44, 51) * DEG;
+    rec.revsPerDay = tleNumber(l2, 53, 63);
+    return rec;
+}
+
+int runVerify() {
+    int failures = 0;
+    std::printf("--- SGP4 Verification ---\n");
+    for (const auto& c : VERIFY_CASES) {
+        Sgp4 sat;
+        sat.init(tleFromLinesUnchecked(c.line1, c.line2));
+        double r[3], v[3];
+        int err = sat.propagate(c.tsince, r, v);
+        double dr = 0, dv = 0;
+        for (int k = 0; k < 3; k++) {
+            dr = std::fmax(dr, std::fabs(r[k] - c.r[k]));
+            if (c.checkVelocity) dv = std::fmax(dv, std::fabs(v[k] - c.v[k]));
+        }
+        bool ok = err == 0 && dr < 1e-6 && dv < 1e-8;      // published values carry 8/9 decimals
+        if (!ok) failures++;
+        char dvText[16] = "-";
+        if (c.checkVelocity) std::snprintf(dvText, sizeof(dvText), "%.2e", dv);
+        std::printf("%05d %s t=%7.1f min | |dr| %.2e km | |dv| %s km/s | %s\n", (int)tleNumber(c.line1, 3, 7),
+                    sat.deepSpace ? "SDP4" : "SGP4", c.tsince, dr, dvText, ok ? "PASS" : "FAIL");
+    }
+    std::printf("%s\n", failures ? "VERIFICATION FAILED" : "All vectors match.");
+    return failures ? 1 : 0;
+}
+
+int runBench(size_t N) {
+    std::mt19937_64 rng(99);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<TleRecord> recs(N);
+    for (size_t i = 0; i < N; i++) {
+        TleRecord& r = recs[i];
+        r = {};
+        r.satnum = (int)i;
+        r.epochYear = 2024;
+        r.epochDay = 1.0 + U(rng) * 10.0;
+        r.bstar = 1e-5 + U(rng) * 1e-4;
+        r.inclination = U(rng) * M_PI;
+        r.raan = U(rng) * 2 * M_PI;
+        r.ecc = U(rng) * 0.05;
+        r.argPerigee = U(rng) * 2 * M_PI;
+        r.meanAnomaly = U(rng) * 2 * M_PI;
+        r.revsPerDay = (i % 10 == 0) ? 1.0 + U(rng) * 1.5 : 11.0 + U(rng) * 5.0;   // 10% deep space
+    }
+    double refJD = 2460320.5;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<Sgp4> sats(N);
+    for (size_t i = 0; i < N; i++) sats[i].init(recs[i]);
+    double initSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const int STEPS = 10;
+    double sink = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int s = 0; s < STEPS; s++) {
+        for (size_t i = 0; i < N; i++) {
+            Vector3 p;
+            if (sats[i].positionAt(refJD, s * 60.0, p) == Sgp4::OK) sink += p.x;
+        }
+    }
+    double sgpSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    KeplerBatch batch;
+    for (const auto& r : recs) batch.add(r.inclination, r.raan, r.ecc, r.argPerigee, r.meanAnomalyAt(refJD), r.meanMotion());
+    std::vector<double> x(N), y(N), z(N);
+    t0 = std::chrono::steady_clock::now();
+    for (int s = 0; s < STEPS; s++) { batch.propagate(s * 60.0, x.data(), y.data(), z.data()); sink += x[0]; }
+    double kepSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::printf("--- Propagation Benchmark (%zu objects, %d steps) ---\n", N, STEPS);
+    std::printf("SGP4 init   : %12.0f inits/s (one-time per element set)\n", N / initSec);
+    std::printf("SGP4 step   : %12.0f propagations/s\n", N * STEPS / sgpSec);
+    std::printf("Kepler batch: %12.0f propagations/s\n", N * STEPS / kepSec);
+    std::printf("(checksum %g)\n", sink);
+    return 0;
+}
+
+// Fragment one catalog object at refJD and print the cloud every `step`
+// seconds: live / decayed fragments, RMS spread about the centroid,
+// altitude range
+int runBreakup(const TleCatalog& catalog, double refJD, int satnum, size_t fragments, double deltaV, bool mutual,
+               double hours, double step) {
+    const TleRecord* parent = nullptr;
+    for (const auto& r : catalog.records) if (r.satnum == satnum) parent = &r;
+    if (!parent || fragments == 0) { std::fprintf(stderr, "No object %d in the catalog\n", satnum); return 1; }
+    Sgp4 sat;
+    sat.init(*parent);
+    double r[3], v[3];
+    if (sat.propagate((refJD - sat.jdEpoch) * MIN_PER_DAY, r, v) != 0) { std::fprintf(stderr, "SGP4 failed for %d\n", satnum); return 1; }
+
+    DebrisOptions opt;
+    opt.sunMoon = true;
+    opt.mutual = mutual;
+    opt.jd0 = refJD;
+    DebrisCloud cloud;
+    cloud.breakup({r[0] * 1000, r[1] * 1000, r[2] * 1000}, {v[0] * 1000, v[1] * 1000, v[2] * 1000},
+                  fragments, 1000.0, deltaV, (uint64_t)satnum);
+    WorkStealingPool pool;
+    const double H = 10.0;
+    size_t decayed = 0, particleSteps = 0;
+    double stepSec = 0;
+    std::printf("# breakup of %d into %zu fragments (median dv %.1f m/s%s), t0 = JD %.6f\n", satnum, fragments, deltaV,
+                mutual ? ", mutual gravity" : "", refJD);
+    std::printf("# t[s] alive decayed rms_spread[km] min_alt[km] max_alt[km]\n");
+    for (double t = 0;; t += H) {
+        if (std::fmod(t + 1e-9, step) < H * 0.5 || t >= hours * 3600.0) {
+            size_t n = cloud.size();
+            double cx = 0, cy = 0, cz = 0, spread = 0, lo = 1e300, hi = 0;
+            for (size_t i = 0; i < n; i++) { cx += cloud.x[i] / n; cy += cloud.y[i] / n; cz += cloud.z[i] / n; }
+            for (size_t i = 0; i < n; i++) {
+                double dx = cloud.x[i] - cx, dy = cloud.y[i] - cy, dz = cloud.z[i] - cz;
+                spread += (dx * dx + dy * dy + dz * dz) / n;
+                double alt = std::sqrt(cloud.x[i] * cloud.x[i] + cloud.y[i] * cloud.y[i] + cloud.z[i] * cloud.z[i]) - R_EARTH;
+                lo = std::fmin(lo, alt); hi = std::fmax(hi, alt);
+            }
+            std::printf("%.1f %zu %zu %.3f %.1f %.1f\n", t, n, decayed, std::sqrt(spread) / 1000.0,
+                        n ? lo / 1000.0 : 0.0, n ? hi / 1000.0 : 0.0);
+        }
+        if (t >= hours * 3600.0 || cloud.size() == 0) break;
+        auto t0 = std::chrono::steady_clock::now();
+        cloud.step(t, H, opt, &pool);
+        stepSec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        particleSteps += cloud.size();
+        decayed += cloud.removeDecayed(opt);
+    }
+    std::printf("# %.3e particle*steps/s, %.1f bytes/particle\n", particleSteps / std::fmax(stepSec, 1e-9),
+                cloud.bytesPerParticle());
+    return 0;
+}
+
+// Reader side of StatePublisher: frame rate, sim time, objects in view and
+// the first object's state, until no new frame arrives for 5 s
+int runSubscribe(const char* name, double interval) {
+    StateSubscriber sub;
+    for (int tries = 0; !sub.open(name); tries++) {
+        if (tries == 50) { std::fprintf(stderr, "No shared memory %s (is the viewer running with --publish?)\n", name); return 1; }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    std::printf("# %s: %zu objects, %u slots\n", name, sub.capacity(), sub.slots());
+    std::printf("# frame frames/s sim_t[s] objects home_visible any_visible x0[km] y0[km] z0[km] |v0|[km/s]\n");
+    StateFrame frame;
+    uint64_t lastFrame = sub.latest();
+    auto lastChange = std::chrono::steady_clock::now();
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+        uint64_t f = sub.latest();
+        auto now = std::chrono::steady_clock::now();
+        if (f == lastFrame) {
+            if (now - lastChange > std::chrono::seconds(5)) break;
+            continue;
+        }
+        double rate = (f - lastFrame) / std::chrono::duration<double>(now - lastChange).count();
+        lastFrame = f;
+        lastChange = now;
+        if (!sub.readLatest(frame) || frame.size() == 0) continue;
+        size_t home = 0, any = 0;
+        for (uint8_t fl : frame.flags) { home += (fl & STATE_VISIBLE_HOME) != 0; any += (fl & STATE_VISIBLE_ANY) != 0; }
+        double v0 = std::sqrt(frame.vx[0] * frame.vx[0] + frame.vy[0] * frame.vy[0] + frame.vz[0] * frame.vz[0]);
+        std::printf("%llu %.1f %.1f %zu %zu %zu %.3f %.3f %.3f %.4f\n", (unsigned long long)frame.frame, rate, frame.simTime,
+                    frame.size(), home, any, frame.x[0] / 1000.0, frame.y[0] / 1000.0, frame.z[0] / 1000.0, v0 / 1000.0);
+        std::fflush(stdout);
+    }
+    std::printf("# no new frames for 5 s, stopping\n");
+    return 0;
+}
+
+// The viewer's default camera and sun, the earth turning once over `frames`
+int runRender(const char* prefix, int frames, const char* texturePath) {
+    EarthRaster raster(1200, 900);
+    if (texturePath && !raster.texture().loadPPM(texturePath)) {
+        std::fprintf(stderr, "Cannot read %s (binary PPM expected)\n", texturePath);
+        return 1;
+    }
+    WorkStealingPool pool;
+    ViewTransform view = ViewTransform::orbitCamera(0.3, 0.0, 600.0, 1000.0, 600, 450, 500);
+    double renderSec = 0, writeSec = 0;
+    for (int f = 0; f < frames; f++) {
+        double t = 86164.0 * f / frames;
+        ViewTransform earthView = view.withModel(Mat3::rotateY(-EARTH_ROTATION_SPEED * t));
+        float lx, ly, lz;
+        earthView.lightInModel(-1.0, 0.0, 0.0, lx, ly, lz);
+        auto t0 = std::chrono::steady_clock::now();
+        raster.render(earthView, 200.0, lx, ly, lz, &pool);
+        auto t1 = std::chrono::steady_clock::now();
+        std::string path = prefix + std::to_string(10000 + f).substr(1) + ".ppm";
+        if (!raster.writePPM(path.c_str())) { std::fprintf(stderr, "Cannot write %s\n", path.c_str()); return 1; }
+        renderSec += std::chrono::duration<double>(t1 - t0).count();
+        writeSec += std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+    }
+    std::printf("%d frames -> %s0000.ppm ... | render %.2f ms/frame, write %.2f ms/frame (%u threads)\n", frames, prefix,
+                renderSec * 1e3 / frames, writeSec * 1e3 / frames, pool.threadCount());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::strcmp(argv[1], "--render") == 0) {
+        return runRender(argv[2], argc > 3 ? std::max(1, std::atoi(argv[3])) : 240, argc > 4 ? argv[4] : nullptr);
+    }
+    if (argc > 2 && std::strcmp(argv[1], "--subscribe") == 0) return runSubscribe(argv[2], argc > 3 ? std::atof(argv[3]) : 1.0);
+    if (argc > 1 && std::strcmp(argv[1], "--verify") == 0) return runVerify();
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) return runBench(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 30000);
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s catalog.tle [--model kepler|sgp4] [--hours H] [--step S] [--passes LAT,LON[,MASK]] [--conjunctions KM] [--breakup SATNUM,N[,DV[,MUTUAL]]] | --subscribe /name [S] | --render PREFIX [FRAMES] [TEXTURE.ppm] | --verify | --bench [N]\n", argv[0]);
+        return 1;
+    }
+
+    Model model = Model::Sgp4;
+    double hours = 1.5, step = 600.0;
+    bool passes = false;
+    double conjunctionKm = 0;
+    int breakupSat = -1, breakupMutual = 0;
+    size_t fragments = 0;
+    double breakupDv = 10.0;
+    GroundStation station = {0.0, 0.0, 0.0, 10.0};
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--model") == 0) model = std::strcmp(argv[i + 1], "kepler") == 0 ? Model::Kepler : Model::Sgp4;
+        else if (std::strcmp(argv[i], "--hours") == 0) hours = std::atof(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--step") == 0) step = std::atof(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--conjunctions") == 0) conjunctionKm = std::atof(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--breakup") == 0) {
+            if (std::sscanf(argv[i + 1], "%d,%zu,%lf,%d", &breakupSat, &fragments, &breakupDv, &breakupMutual) < 2) breakupSat = -1;
+        }
+        else if (std::strcmp(argv[i], "--passes") == 0) {
+            passes = std::sscanf(argv[i + 1], "%lf,%lf,%lf", &station.lat, &station.lon, &station.minElevation) >= 2;
+        }
+    }
+
+    TleCatalog catalog;
+    if (!catalog.load(argv[1])) { std::fprintf(stderr, "Cannot read %s\n", argv[1]); return 1; }
+    double refJD = catalog.latestEpochJD();
+    size_t N = catalog.records.size();
+
+    if (conjunctionKm > 0) {
+        KeplerBatch batch;
+        catalog.toKeplerBatch(batch, refJD);
+        WorkStealingPool pool;
+        ConjunctionScreener screener(batch, conjunctionKm * 1000.0);
+        std::vector<Conjunction> found;
+        screener.screen(0.0, hours * 3600.0, found, &pool);
+        const ConjunctionStats& st = screener.stats();
+        std::printf("# %zu conjunctions under %.2f km in %.1f h, t0 = JD %.6f (%zu of %zu objects screened, %.2f s)\n",
+                    found.size(), conjunctionKm, hours, refJD, st.activeObjects, st.objects, st.filterSec + st.hashSec + st.refineSec);
+        std::printf("# satnumA satnumB tca[s] miss[km] vrel[km/s]\n");
+        for (const auto& c : found) {
+            std::printf("%d %d %.3f %.3f %.3f\n", catalog.records[c.a].satnum, catalog.records[c.b].satnum,
+                        c.tca, c.missDistance / 1000.0, c.relativeSpeed / 1000.0);
+        }
+        return 0;
+    }
+
+    if (breakupSat >= 0) return runBreakup(catalog, refJD, breakupSat, fragments, breakupDv, breakupMutual != 0, hours, step);
+
+    KeplerBatch batch;
+    std::vector<Sgp4> sgp(N);
+    if (model == Model::Kepler) catalog.toKeplerBatch(batch, refJD);
+    else for (size_t i = 0; i < N; i++) sgp[i].init(catalog.records[i]);
+
+    if (passes) {
+        // TEME is an inertial frame, so the station rotates with GMST from refJD
+        PassPredictor predictor(station, gstime(refJD));
+        std::vector<Pass> found;
+        for (size_t i = 0; i < N; i++) {
+            const TleRecord& rec = catalog.records[i];
+            if (!predictor.canEverSee(rec.inclination, rec.apogeeRadius())) continue;
+            double period = 2 * M_PI / rec.meanMotion();
+            if (model == Model::Kepler) {
+                predictor.findPasses([&](double t) { return batch.position(i, t); }, period, 0.0, hours * 3600.0, (int)i, found);
+            } else {
+                // No SGP4 solution (decayed, bad elements): NaN, below the horizon
+                predictor.findPasses([&](double t) {
+                    Vector3 p;
+                    if (sgp[i].positionAt(refJD, t, p) != Sgp4::OK) p.x = p.y = p.z = std::numeric_limits<double>::quiet_NaN();
+                    return p;
+                }, period, 0.0, hours * 3600.0, (int)i, found);
+            }
+        }
+        std::printf("# %zu passes over (%.4f, %.4f) above %.1f deg, t0 = JD %.6f\n",
+                    found.size(), station.lat, station.lon, station.minElevation, refJD);
+        std::printf("# satnum aos[s] tca[s] los[s] maxEl[deg]\n");
+        for (const auto& p : found) {
+            std::printf("%d %.1f %.1f %.1f %.1f\n", catalog.records[p.object].satnum, p.aos, p.tca, p.los, p.maxElevation);
+        }
+        return 0;
+    }
+
+    std::vector<double> x(N), y(N), z(N);
+    std::vector<char> ok(N, 1);            // SGP4 objects without a solution are left out of the listing
+    std::printf("# %zu objects, model %s, t0 = JD %.6f\n", N, model == Model::Kepler ? "kepler" : "sgp4", refJD);
+    std::printf("# t[s] satnum x[km] y[km] z[km]\n");
+    for (double t = 0; t <= hours * 3600.0 + 1e-9; t += step) {
+        if (model == Model::Kepler) {
+            batch.propagate(t, x.data(), y.data(), z.data());
+        } else {
+            for (size_t i = 0; i < N; i++) {
+                Vector3 p;
+                ok[i] = sgp[i].positionAt(refJD, t, p) == Sgp4::OK;
+                x[i] = p.x; y[i] = p.y; z[i] = p.z;
+            }
+        }
+        for (size_t i = 0; i < N; i++) {
+            if (!ok[i]) continue;
+            std::printf("%.1f %d %.3f %.3f %.3f\n", t, catalog.records[i].satnum, x[i] / 1000.0, y[i] / 1000.0, z[i] / 1000.0);
+        }
+    }
+    return 0;
+}
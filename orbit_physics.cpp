@@ -1,79 +1,70 @@
 #include <bits/stdc++.h>
-
-//--physics constants---
+#include "orbit_common.hpp"
+#include "integrators.hpp"
 
 using namespace std;
 
-const double G=6.67430e-11;
-const double M_EARTH = 5.972e24;
-const double R_EARTH= 6371000.0;//in meters 
-
-//Vector Helper
-
-struct Vector3{
-    double x,y,z;
-
-    //Overload for cleaner math
-    Vector3 operator+(const Vector3 & other ){return {x+other.x,y+other.y,z+other.z};} 
-    Vector3 operator* (double scalar)const{return {x*scalar ,y*scalar,z*scalar};}
-
-    double magnitude() const {
-        return sqrt(x*x + y*y + z*z);
-    }
-};
-
-
 //--The Sattelite Class--
 
 class Sattelite {
     public :
         Vector3 pos;//position 
         Vector3 vel;//velocity 
+        double time = 0.0;
+        Integrator integrator;//which scheme advances the state (see integrators.hpp)
 
-        Sattelite(Vector3 startPos, Vector3 startVel):pos (startPos),vel(startVel){}//constructor 
+        Sattelite(Vector3 startPos, Vector3 startVel, IntegratorKind kind):pos (startPos),vel(startVel),integrator(kind){}//constructor 
 
 
         //---Physics engine step 
         void update (double dt ){
-            double r=pos.magnitude();//Distance from the centre of the earth
-
         // Newton's Law of Gravitation: F = G * M * m / r^2
         // Acceleration a = F / m  =>  a = G * M / r^2
-        // Vector form: a = -(G * M / r^3) * pos
-
-        double accelMagnitude =(G* M_EARTH)/(r*r*r);
-        Vector3 accel= pos * (-accelMagnitude);
-
-        //Semi-Implicit Euler Integration (stable for the orbits )
+        // Vector form: a = -(G * M / r^3) * pos   (TwoBodyForce)
 
-        vel = vel + (accel * dt);
-        pos = pos + (vel * dt);
+        OrbitState s = {pos, vel};
+        integrator.advance(s, time, dt, TwoBodyForce());
+        pos = s.pos;
+        vel = s.vel;
+        time += dt;
 
         }
 };
 
-int main (){
+// Integrator from the command line: euler | verlet | fr | y6 | rk4 | dp54
+IntegratorKind parseIntegrator(const char* name) {
+    const char* NAMES[] = {"euler", "verlet", "fr", "y6", "rk4", "dp54"};
+    for (int k = 0; k < INTEGRATOR_KIND_COUNT; k++) {
+        if (strcmp(name, NAMES[k]) == 0) return (IntegratorKind)k;
+    }
+    return IntegratorKind::SemiImplicitEuler;
+}
+
+int main (int argc, char** argv){
     //altitude is 400km 
     double altitude =400000.0;
     double r_initial =R_EARTH +altitude ;
 
     double v_orbit = std::sqrt((G * M_EARTH) / r_initial);//GM/r2*r
 
-    cout <<"---Simualtion Config ---"<<endl;
-    cout <<"Target Altitude :"<<altitude /1000.0<<"km"<<endl;
-    cout <<"required Velocity "<<v_orbit<<"m/s "<<endl;
+    cout <<"---Simualtion Config ---"<<'\n';
+    cout <<"Target Altitude :"<<altitude /1000.0<<"km"<<'\n';
+    cout <<"required Velocity "<<v_orbit<<"m/s "<<'\n';
 
     //Spaawn Sattelite ,Pos =Right side of earth(x-axis ),Moving up (Y-axis ) ot the orbit 
 
     //---RUN SIMULAITON IN VIRTUAL TIME---
 
-    Sattelite sat({r_initial,0,0},{0,v_orbit,0});
+    IntegratorKind kind = argc > 1 ? parseIntegrator(argv[1]) : IntegratorKind::SemiImplicitEuler;
+    cout <<"Integrator :"<<integratorName(kind)<<'\n';
+
+    Sattelite sat({r_initial,0,0},{0,v_orbit,0},kind);
 
     double dt =1.0;//Time step(10 sec per loop)
     double totalTime =0.0;
 
     // Run for one full orbit (approx 90 minutes = 5400 seconds)
-    std::cout << "\n--- Starting Orbit ---" << std::endl;
+    std::cout << "\n--- Starting Orbit ---" << '\n';
     for (int i = 0; i <= 600; i++) {
         sat.update(dt);
         totalTime += dt;
@@ -84,10 +75,16 @@ int main (){
             std::cout << "Time: " << totalTime / 60.0 << " min | "
                       << "Alt: " << currentAltitude / 1000.0 << " km | "
                       << "Pos: (" << (int)sat.pos.x << ", " << (int)sat.pos.y << ")" 
-                      << std::endl;
+                      << '\n';
         }
     }
 
+    // Circular orbit: the exact answer is known, so report the drift
+    double n = v_orbit / r_initial;
+    Vector3 exact = {r_initial * std::cos(n * totalTime), r_initial * std::sin(n * totalTime), 0};
+    std::cout << "Position error vs Kepler: " << (sat.pos - exact).magnitude() << " m | "
+              << "Force evaluations: " << sat.integrator.forceEvaluations() << '\n';
+
     return 0;
 
 
@@ -0,0 +1,188 @@
+#pragma once
+#include "orbit_common.hpp"
+#include <vector>
+#include <cmath>
+
+// ============================================================================
+// PassPredictor: AOS / culmination / LOS times for one ground station.
+//
+// Works on any propagator through a callable pos(t) -> ECI position [m]
+// (Z = north pole, same frame as getSatellitePosition / Satellite::pos).
+// Earth orientation is theta(t) = earthAngle0 + EARTH_ROTATION_SPEED * t,
+// matching getStationPos() in Tracker.cpp (earthAngle0 = GMST at t = 0 for
+// SGP4/TEME input).
+//
+// Instead of dense stepping, elevation is sampled every ~period/12 to
+// bracket each local maximum, the maximum is refined by golden-section
+// search, and only passes whose culmination clears the mask get their rise
+// and set times root-found (regula falsi, Illinois variant). A geometric
+// pre-filter drops orbits that can never reach the station's latitude.
+// A propagator with no position at t (NaN, e.g. decayed under SGP4) counts
+// as below the horizon there.
+// ============================================================================
+
+const double WGS84_A = 6378137.0;
+const double WGS84_F = 1.0 / 298.257223563;
+
+struct GroundStation {
+    double lat, lon;            // deg (geodetic)
+    double alt;                 // m above the ellipsoid
+    double minElevation;        // deg, elevation mask
+};
+
+struct Pass {
+    int object;                 // caller's object index
+    double aos, tca, los;       // s (rise, culmination, set)
+    double maxElevation;        // deg
+};
+
+class PassPredictor {
+public:
+    explicit PassPredictor(const GroundStation& st, double earthAngle0 = 0.0) : station(st), theta0(earthAngle0) {
+        double phi = st.lat * M_PI / 180.0, lam = st.lon * M_PI / 180.0;
+        double e2 = WGS84_F * (2 - WGS84_F);
+        double N = WGS84_A / std::sqrt(1 - e2 * std::sin(phi) * std::sin(phi));
+        ecef = {(N + st.alt) * std::cos(phi) * std::cos(lam),
+                (N + st.alt) * std::cos(phi) * std::sin(lam),
+                (N * (1 - e2) + st.alt) * std::sin(phi)};
+        up = {std::cos(phi) * std::cos(lam), std::cos(phi) * std::sin(lam), std::sin(phi)};
+        sinMask = std::sin(st.minElevation * M_PI / 180.0);
+    }
+
+    // Elevation [rad] of an ECI position at time t
+    double elevation(const Vector3& eci, double t) const {
+        double th = theta0 + EARTH_ROTATION_SPEED * t;
+        double c = std::cos(th), s = std::sin(th);
+        Vector3 r = {c * eci.x + s * eci.y, -s * eci.x + c * eci.y, eci.z};   // ECI -> ECEF
+        Vector3 rho = r - ecef;
+        return std::asin(rho.dot(up) / rho.magnitude());
+    }
+
+    bool visible(const Vector3& eci, double t) const { return std::sin(elevation(eci, t)) >= sinMask; }
+
+    // Station position [m] and local vertical in ECEF
+    const Vector3& stationEcef() const { return ecef; }
+    const Vector3& stationUp() const { return up; }
+
+    // Can an orbit with this inclination [rad] and apogee radius [m] ever
+    // rise above the mask here? (footprint half-angle vs latitude gap)
+    bool canEverSee(double inclination, double apogeeRadius) const {
+        double maxLat = inclination <= M_PI / 2 ? inclination : M_PI - inclination;
+        double el = station.minElevation * M_PI / 180.0;
+        double lambda = std::acos(std::fmin(1.0, R_EARTH / apogeeRadius * std::cos(el))) - el;   // earth central angle
+        return std::fabs(station.lat * M_PI / 180.0) <= maxLat + lambda + 0.01;
+    }
+
+    // Append every pass in [t0, t1] to `out`. period: orbital period [s].
+    template <class PosFn>
+    void findPasses(PosFn pos, double period, double t0, double t1, int object, std::vector<Pass>& out) const {
+        auto el = [&](double t) { double e = elevation(pos(t), t); return e == e ? e : -M_PI / 2; };
+        double mask = station.minElevation * M_PI / 180.0;
+        double h = std::fmin(period / 12.0, 600.0);
+
+        double tPrev = t0, ePrev = el(t0);
+        double tCur = std::fmin(t0 + h, t1), eCur = el(tCur);
+
+        // Pass already in progress at t0; the peak may still lie inside
+        // (t0, tCur) before the elevation falls
+        if (ePrev >= mask && eCur < ePrev) {
+            double tMax = goldenMax(el, t0, tCur);
+            addPass(el, object, t0, el(tMax) > ePrev ? tMax : t0, tCur, mask, t0, t1, out);
+        }
+
+        while (tCur < t1) {
+            double tNext = std::fmin(tCur + h, t1), eNext = el(tNext);
+            if (eCur >= ePrev && eCur >= eNext) {
+                // Local max bracketed in [tPrev, tNext]
+                double tMax = goldenMax(el, tPrev, tNext);
+                if (el(tMax) >= mask) addPass(el, object, tPrev, tMax, tNext, mask, t0, t1, out);
+            }
+            tPrev = tCur; ePrev = eCur;
+            tCur = tNext; eCur = eNext;
+        }
+
+        // Still climbing at t1 (including an object that rises for the
+        // whole window): the pass is cut there, culminating at t1
+        if (eCur >= mask && eCur > ePrev) addPass(el, object, tPrev, t1, t1, mask, t0, t1, out);
+    }
+
+private:
+    template <class ElFn>
+    void addPass(ElFn& el, int object, double tLo, double tMax, double tHi, double mask,
+                 double t0, double t1, std::vector<Pass>& out) const {
+        // Skip a culmination we already reported (adjacent brackets)
+        if (!out.empty() && out.back().object == object && std::fabs(out.back().tca - tMax) < 1.0) return;
+
+        auto f = [&](double t) { return el(t) - mask; };
+        Pass p;
+        p.object = object;
+        p.tca = tMax;
+        p.maxElevation = el(tMax) * 180.0 / M_PI;
+        p.aos = walkToCrossing(f, tMax, -1.0, tMax - tLo, t0);
+        p.los = walkToCrossing(f, tMax, +1.0, tHi - tMax, t1);
+        // Two maxima inside one stretch above the mask (e.g. a GEO object
+        // up for the whole window) are one pass, culminating at the higher
+        if (!out.empty() && out.back().object == object && p.aos <= out.back().los) {
+            Pass& prev = out.back();
+            if (p.maxElevation > prev.maxElevation) { prev.tca = p.tca; prev.maxElevation = p.maxElevation; }
+            prev.aos = std::fmin(prev.aos, p.aos);
+            prev.los = std::fmax(prev.los, p.los);
+            return;
+        }
+        out.push_back(p);
+    }
+
+    // Step outward from the culmination until f < 0, then root-find the
+    // crossing. Clamps to `limit` if the pass is cut by the window edge.
+    template <class F>
+    static double walkToCrossing(F& f, double tMax, double dir, double step, double limit) {
+        double h = std::fmax(step, 30.0);
+        double a = tMax, b = tMax;
+        for (;;) {
+            b = a + dir * h;
+            if ((dir < 0 && b <= limit) || (dir > 0 && b >= limit)) {
+                if (f(limit) >= 0) return limit;
+                b = limit;
+                break;
+            }
+            if (f(b) < 0) break;
+            a = b;
+        }
+        return regulaFalsi(f, a, b);
+    }
+
+    // Illinois regula falsi: f(a) >= 0 > f(b); stops when the estimate
+    // moves less than 0.05 s
+    template <class F>
+    static double regulaFalsi(F& f, double a, double b) {
+        double fa = f(a), fb = f(b);
+        double c = a, cPrev;
+        int side = 0;
+        for (int it = 0; it < 60; it++) {
+            cPrev = c;
+            c = (a * fb - b * fa) / (fb - fa);
+            double fc = f(c);
+            if (fc == 0.0 || std::fabs(c - cPrev) < 0.05) break;
+            if (fc * fb > 0) { b = c; fb = fc; if (side == -1) fa *= 0.5; side = -1; }
+            else { a = c; fa = fc; if (side == 1) fb *= 0.5; side = 1; }
+        }
+        return c;
+    }
+
+    template <class ElFn>
+    static double goldenMax(ElFn& el, double a, double b) {
+        const double R = 0.6180339887498949;
+        double c = b - R * (b - a), d = a + R * (b - a);
+        double fc = el(c), fd = el(d);
+        while (b - a > 0.5) {
+            if (fc > fd) { b = d; d = c; fd = fc; c = b - R * (b - a); fc = el(c); }
+            else { a = c; c = d; fc = fd; d = a + R * (b - a); fd = el(d); }
+        }
+        return 0.5 * (a + b);
+    }
+
+    GroundStation station;
+    double theta0;
+    Vector3 ecef, up;
+    double sinMask;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+// ============================================================================
+// RenderBatch: one draw call for a whole layer of points, lines or markers.
+//
+// The viewers used to build an sf::RectangleShape / sf::CircleShape per dot
+// and draw it on its own: thousands of draw calls (and state changes) per
+// frame. A RenderBatch keeps a CPU vertex list that is refilled each frame
+// (clear() keeps the capacity, so there is no allocation in steady state)
+// and uploads it in place into a persistent streaming sf::VertexBuffer,
+// growing the GPU buffer geometrically. Without VBO support it falls back
+// to drawing the client-side array, still as one call.
+//
+// Markers are triangles (SFML 3 has no quads): a square is 6 vertices, a
+// disc 3 * segments. alloc() hands out a fixed-size slot so workers can fill
+// markers in parallel at known offsets; off-screen slots are written as
+// degenerate (zero-area) triangles instead of being compacted.
+// ============================================================================
+
+class RenderBatch {
+public:
+    static const size_t SQUARE_VERTICES = 6;
+
+    explicit RenderBatch(sf::PrimitiveType t)
+        : type(t), buffer(t, sf::VertexBuffer::Usage::Stream), useBuffer(sf::VertexBuffer::isAvailable()) {}
+
+    void clear() { vertices.clear(); }
+    size_t size() const { return vertices.size(); }
+
+    // Reserve `count` vertices at the end; returns the first for in-place fill
+    sf::Vertex* alloc(size_t count) {
+        size_t at = vertices.size();
+        vertices.resize(at + count);
+        return vertices.data() + at;
+    }
+
+    void point(sf::Vector2f p, sf::Color c) { vertices.push_back(sf::Vertex{p, c}); }
+
+    void line(sf::Vector2f a, sf::Vector2f b, sf::Color c) {
+        vertices.push_back(sf::Vertex{a, c});
+        vertices.push_back(sf::Vertex{b, c});
+    }
+
+    // Axis-aligned square with top-left corner `p` (what RectangleShape did)
+    void square(sf::Vector2f p, float size, sf::Color c) { writeSquare(alloc(SQUARE_VERTICES), p, size, c); }
+
+    void disc(sf::Vector2f center, float radius, sf::Color c, int segments = 8) {
+        writeDisc(alloc(3 * (size_t)segments), center, radius, c, segments);
+    }
+
+    static void writeSquare(sf::Vertex* v, sf::Vector2f p, float size, sf::Color c) {
+        sf::Vector2f a = p, b = {p.x + size, p.y}, d = {p.x, p.y + size}, e = {p.x + size, p.y + size};
+        v[0] = sf::Vertex{a, c}; v[1] = sf::Vertex{b, c}; v[2] = sf::Vertex{d, c};
+        v[3] = sf::Vertex{b, c}; v[4] = sf::Vertex{e, c}; v[5] = sf::Vertex{d, c};
+    }
+
+    static void writeDisc(sf::Vertex* v, sf::Vector2f center, float radius, sf::Color c, int segments) {
+        const float step = 2.0f * (float)M_PI / segments;
+        sf::Vector2f prev = {center.x + radius, center.y};
+        for (int k = 1; k <= segments; k++) {
+            sf::Vector2f next = {center.x + radius * std::cos(k * step), center.y + radius * std::sin(k * step)};
+            *v++ = sf::Vertex{center, c};
+            *v++ = sf::Vertex{prev, c};
+            *v++ = sf::Vertex{next, c};
+            prev = next;
+        }
+    }
+
+    // Nothing visible: every vertex on one point
+    static void writeHidden(sf::Vertex* v, size_t count) {
+        for (size_t k = 0; k < count; k++) v[k] = sf::Vertex{{0.f, 0.f}, sf::Color::Transparent};
+    }
+
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default) {
+        size_t n = vertices.size();
+        if (n == 0) return;
+        if (useBuffer) {
+            if (n > capacity) {
+                size_t grow = capacity * 2 > n ? capacity * 2 : n;
+                useBuffer = buffer.create(grow);
+                capacity = useBuffer ? grow : 0;
+            }
+            if (useBuffer && buffer.update(vertices.data(), n, 0)) {
+                target.draw(buffer, 0, n, states);
+                return;
+            }
+            useBuffer = false;      // driver refused; stay on the client-side path
+        }
+        target.draw(vertices.data(), n, type, states);
+    }
+
+private:
+    sf::PrimitiveType type;
+    std::vector<sf::Vertex> vertices;
+    sf::VertexBuffer buffer;
+    size_t capacity = 0;
+    bool useBuffer;
+};
@@ -0,0 +1,830 @@
+#pragma once
+#include "tle_catalog.hpp"
+#include <cmath>
+#include <limits>
+
+// ============================================================================
+// Sgp4: SGP4/SDP4 propagator for TLE element sets (WGS-72, "improved" mode),
+// following Vallado et al., "Revisiting Spacetrack Report #3" (AIAA 2006).
+//
+// init() does all the expensive work once per element set -- un-Kozai'd mean
+// motion, drag/secular coefficients and, for periods >= 225 min, the
+// lunar-solar (dscom) and resonance (dsinit) terms -- and caches it in the
+// struct. propagate() is then only the per-epoch evaluation: secular update,
+// deep-space integration step, periodics, Kepler solve, orientation.
+//
+// Output is TEME position [km] and velocity [km/s]. Time is minutes since the
+// element epoch. Deep-space resonance state advances across calls, so one
+// Sgp4 object must not be propagated from two threads at once (different
+// objects are fine).
+// ============================================================================
+
+// WGS-72 constants used by every published SGP4 implementation
+const double SGP4_MU = 398600.8;                  // km^3/s^2
+const double SGP4_RE = 6378.135;                  // km
+const double SGP4_XKE = 60.0 / std::sqrt(SGP4_RE * SGP4_RE * SGP4_RE / SGP4_MU);
+const double SGP4_J2 = 0.001082616;
+const double SGP4_J3 = -0.00000253881;
+const double SGP4_J4 = -0.00000165597;
+const double SGP4_J3OJ2 = SGP4_J3 / SGP4_J2;
+
+// Greenwich mean sidereal time [rad] (IAU-82) for a UT1 Julian date
+inline double gstime(double jdut1) {
+    double tut1 = (jdut1 - 2451545.0) / 36525.0;
+    double temp = -6.2e-6 * tut1 * tut1 * tut1 + 0.093104 * tut1 * tut1
+                + (876600.0 * 3600 + 8640184.812866) * tut1 + 67310.54841;   // seconds
+    temp = std::fmod(temp * (M_PI / 180.0) / 240.0, 2 * M_PI);
+    if (temp < 0.0) temp += 2 * M_PI;
+    return temp;
+}
+
+struct Sgp4 {
+    enum Error { OK = 0, BAD_ECCENTRICITY = 1, BAD_MEAN_MOTION = 2, BAD_PERTURBED_ECC = 3, BAD_SEMILATUS = 4, DECAYED = 6 };
+
+    int error = OK;
+    bool deepSpace = false;
+    double jdEpoch = 0;       // Julian date of the element epoch
+    double gsto = 0;          // GMST at epoch [rad]
+
+    // Elements (mean, at epoch). no is un-Kozai'd [rad/min] after init().
+    double bstar, inclo, nodeo, ecco, argpo, mo, no;
+
+    // Near-earth cached terms
+    int isimp;
+    double aycof, con41, cc1, cc4, cc5, d2, d3, d4, delmo, eta, argpdot, omgcof, sinmao,
+           t2cof, t3cof, t4cof, t5cof, x1mth2, x7thm1, mdot, nodedot, xlcof, xmcof, nodecf;
+
+    // Deep-space cached terms
+    int irez;
+    double d2201, d2211, d3210, d3222, d4410, d4422, d5220, d5232, d5421, d5433,
+           dedt, del1, del2, del3, didt, dmdt, dnodt, domdt,
+           e3, ee2, peo, pgho, pho, pinco, plo, se2, se3, sgh2, sgh3, sgh4, sh2, sh3, si2, si3,
+           sl2, sl3, sl4, xfact, xgh2, xgh3, xgh4, xh2, xh3, xi2, xi3, xl2, xl3, xl4, xlamo, zmol, zmos;
+    // Resonance integrator state (advanced by propagate)
+    double atime, xli, xni;
+
+    // ------------------------------------------------------------------------
+    bool init(const TleRecord& tle) {
+        const double twopi = 2 * M_PI;
+        const double x2o3 = 2.0 / 3.0;
+        const double temp4 = 1.5e-12;
+
+        jdEpoch = tle.epochJD();
+        double epoch = jdEpoch - 2433281.5;        // days since 1950 Jan 0.0
+        bstar = tle.bstar;
+        inclo = tle.inclination;
+        nodeo = tle.raan;
+        ecco = tle.ecc;
+        argpo = tle.argPerigee;
+        mo = tle.meanAnomaly;
+        no = tle.revsPerDay * twopi / MIN_PER_DAY;  // Kozai mean motion [rad/min]
+        error = OK;
+        deepSpace = false;
+        irez = 0;
+        atime = xli = xni = 0;
+        d2201 = d2211 = d3210 = d3222 = d4410 = d4422 = d5220 = d5232 = d5421 = d5433 = 0;
+        dedt = del1 = del2 = del3 = didt = dmdt = dnodt = domdt = 0;
+        xfact = xlamo = 0;
+
+        double ss = 78.0 / SGP4_RE + 1.0;
+        double qzms2t = std::pow((120.0 - 78.0) / SGP4_RE, 4);
+
+        // --- initl: recover original mean motion and semi-major axis ---
+        double eccsq = ecco * ecco;
+        double omeosq = 1.0 - eccsq;
+        double rteosq = std::sqrt(omeosq);
+        double cosio = std::cos(inclo);
+        double cosio2 = cosio * cosio;
+        double ak = std::pow(SGP4_XKE / no, x2o3);
+        double d1 = 0.75 * SGP4_J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+        double del = d1 / (ak * ak);
+        double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+        del = d1 / (adel * adel);
+        no = no / (1.0 + del);
+        double ao = std::pow(SGP4_XKE / no, x2o3);
+        double sinio = std::sin(inclo);
+        double po = ao * omeosq;
+        double con42 = 1.0 - 5.0 * cosio2;
+        con41 = -con42 - cosio2 - cosio2;
+        double posq = po * po;
+        double rp = ao * (1.0 - ecco);
+        gsto = gstime(epoch + 2433281.5);
+
+        if (omeosq < 0.0 && no < 0.0) { error = BAD_MEAN_MOTION; return false; }
+
+        isimp = (rp < 220.0 / SGP4_RE + 1.0) ? 1 : 0;
+        double sfour = ss;
+        double qzms24 = qzms2t;
+        double perige = (rp - 1.0) * SGP4_RE;
+
+        // For perigees below 156 km, s and qoms2t are altered
+        if (perige < 156.0) {
+            sfour = perige - 78.0;
+            if (perige < 98.0) sfour = 20.0;
+            qzms24 = std::pow((120.0 - sfour) / SGP4_RE, 4);
+            sfour = sfour / SGP4_RE + 1.0;
+        }
+        double pinvsq = 1.0 / posq;
+
+        double tsi = 1.0 / (ao - sfour);
+        eta = ao * ecco * tsi;
+        double etasq = eta * eta;
+        double eeta = ecco * eta;
+        double psisq = std::fabs(1.0 - etasq);
+        double coef = qzms24 * std::pow(tsi, 4);
+        double coef1 = coef / std::pow(psisq, 3.5);
+        double cc2 = coef1 * no * (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq))
+                   + 0.375 * SGP4_J2 * tsi / psisq * con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+        cc1 = bstar * cc2;
+        double cc3 = 0.0;
+        if (ecco > 1.0e-4) cc3 = -2.0 * coef * tsi * SGP4_J3OJ2 * no * sinio / ecco;
+        x1mth2 = 1.0 - cosio2;
+        cc4 = 2.0 * no * coef1 * ao * omeosq *
+              (eta * (2.0 + 0.5 * etasq) + ecco * (0.5 + 2.0 * etasq)
+               - SGP4_J2 * tsi / (ao * psisq) *
+                 (-3.0 * con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta))
+                  + 0.75 * x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * std::cos(2.0 * argpo)));
+        cc5 = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+        double cosio4 = cosio2 * cosio2;
+        double temp1 = 1.5 * SGP4_J2 * pinvsq * no;
+        double temp2 = 0.5 * temp1 * SGP4_J2 * pinvsq;
+        double temp3 = -0.46875 * SGP4_J4 * pinvsq * pinvsq * no;
+        mdot = no + 0.5 * temp1 * rteosq * con41 + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+        argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4)
+                + temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+        double xhdot1 = -temp1 * cosio;
+        nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+        double xpidot = argpdot + nodedot;
+        omgcof = bstar * cc3 * std::cos(argpo);
+        xmcof = 0.0;
+        if (ecco > 1.0e-4) xmcof = -x2o3 * coef * bstar / eeta;
+        nodecf = 3.5 * omeosq * xhdot1 * cc1;
+        t2cof = 1.5 * cc1;
+        if (std::fabs(cosio + 1.0) > 1.5e-12) xlcof = -0.25 * SGP4_J3OJ2 * sinio * (3.0 + 5.0 * cosio) / (1.0 + cosio);
+        else xlcof = -0.25 * SGP4_J3OJ2 * sinio * (3.0 + 5.0 * cosio) / temp4;
+        aycof = -0.5 * SGP4_J3OJ2 * sinio;
+        double delmotemp = 1.0 + eta * std::cos(mo);
+        delmo = delmotemp * delmotemp * delmotemp;
+        sinmao = std::sin(mo);
+        x7thm1 = 7.0 * cosio2 - 1.0;
+
+        // --- deep space initialization (period >= 225 min) ---
+        if (twopi / no >= 225.0) {
+            deepSpace = true;
+            isimp = 1;
+            double tc = 0.0;
+            double inclm = inclo;
+
+            double snodm, cnodm, sinim, cosim, sinomm, cosomm, day, em, emsq, gam, rtemsq,
+                   s1, s2, s3, s4, s5, s6, s7, ss1, ss2, ss3, ss4, ss5, ss6, ss7,
+                   sz1, sz2, sz3, sz11, sz12, sz13, sz21, sz22, sz23, sz31, sz32, sz33,
+                   nm, z1, z2, z3, z11, z12, z13, z21, z22, z23, z31, z32, z33;
+            dscom(epoch, ecco, argpo, tc, inclo, nodeo, no,
+                  snodm, cnodm, sinim, cosim, sinomm, cosomm, day, em, emsq, gam, rtemsq,
+                  s1, s2, s3, s4, s5, s6, s7, ss1, ss2, ss3, ss4, ss5, ss6, ss7,
+                  sz1, sz2, sz3, sz11, sz12, sz13, sz21, sz22, sz23, sz31, sz32, sz33,
+                  nm, z1, z2, z3, z11, z12, z13, z21, z22, z23, z31, z32, z33);
+            (void)snodm; (void)cnodm; (void)sinomm; (void)cosomm; (void)day; (void)gam; (void)rtemsq;
+            (void)s6; (void)s7; (void)ss6; (void)ss7; (void)sz2; (void)sz12; (void)sz22; (void)sz32;
+            (void)z2; (void)z12; (void)z22; (void)z32;
+
+            double argpm = 0.0, nodem = 0.0, mm = 0.0;
+            dsinit(cosim, emsq, s1, s2, s3, s4, s5, sinim, ss1, ss2, ss3, ss4, ss5,
+                   sz1, sz3, sz11, sz13, sz21, sz23, sz31, sz33, 0.0, tc, xpidot,
+                   z1, z3, z11, z13, z21, z23, z31, z33, eccsq, em, argpm, inclm, mm, nm, nodem);
+        }
+
+        // --- higher-order drag terms for non-simplified near-earth ---
+        if (isimp != 1) {
+            double cc1sq = cc1 * cc1;
+            d2 = 4.0 * ao * tsi * cc1sq;
+            double temp = d2 * tsi * cc1 / 3.0;
+            d3 = (17.0 * ao + sfour) * temp;
+            d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * cc1;
+            t3cof = d2 + 2.0 * cc1sq;
+            t4cof = 0.25 * (3.0 * d3 + cc1 * (12.0 * d2 + 10.0 * cc1sq));
+            t5cof = 0.2 * (3.0 * d4 + 12.0 * cc1 * d3 + 6.0 * d2 * d2 + 15.0 * cc1sq * (2.0 * d2 + cc1sq));
+        } else {
+            d2 = d3 = d4 = t3cof = t4cof = t5cof = 0.0;
+        }
+
+        double r[3], v[3];
+        propagate(0.0, r, v);
+        return error == OK;
+    }
+
+    // ------------------------------------------------------------------------
+    // tsince: minutes from epoch. r [km], v [km/s] in TEME. Returns error code;
+    // on the early exits (bad elements) r and v are NaN, on DECAYED they hold
+    // the sub-surface state the model ran into.
+    int propagate(double tsince, double r[3], double v[3]) {
+        const double twopi = 2 * M_PI;
+        const double x2o3 = 2.0 / 3.0;
+        const double temp4 = 1.5e-12;
+        const double vkmpersec = SGP4_RE * SGP4_XKE / 60.0;
+
+        r[0] = r[1] = r[2] = v[0] = v[1] = v[2] = std::numeric_limits<double>::quiet_NaN();
+        error = OK;
+        double t = tsince;
+
+        // --- secular gravity and atmospheric drag ---
+        double xmdf = mo + mdot * t;
+        double argpdf = argpo + argpdot * t;
+        double nodedf = nodeo + nodedot * t;
+        double argpm = argpdf;
+        double mm = xmdf;
+        double t2 = t * t;
+        double nodem = nodedf + nodecf * t2;
+        double tempa = 1.0 - cc1 * t;
+        double tempe = bstar * cc4 * t;
+        double templ = t2cof * t2;
+
+        if (isimp != 1) {
+            double delomg = omgcof * t;
+            double delmtemp = 1.0 + eta * std::cos(xmdf);
+            double delm = xmcof * (delmtemp * delmtemp * delmtemp - delmo);
+            double temp = delomg + delm;
+            mm = xmdf + temp;
+            argpm = argpdf - temp;
+            double t3 = t2 * t;
+            double t4 = t3 * t;
+            tempa = tempa - d2 * t2 - d3 * t3 - d4 * t4;
+            tempe = tempe + bstar * cc5 * (std::sin(mm) - sinmao);
+            templ = templ + t3cof * t3 + t4 * (t4cof + t * t5cof);
+        }
+
+        double nm = no;
+        double em = ecco;
+        double inclm = inclo;
+        if (deepSpace) dspace(t, t, em, argpm, inclm, mm, nodem, nm);
+
+        if (nm <= 0.0) { error = BAD_MEAN_MOTION; return error; }
+        double am = std::pow(SGP4_XKE / nm, x2o3) * tempa * tempa;
+        nm = SGP4_XKE / std::pow(am, 1.5);
+        em = em - tempe;
+
+        if (em >= 1.0 || em < -0.001) { error = BAD_ECCENTRICITY; return error; }
+        if (em < 1.0e-6) em = 1.0e-6;
+        mm = mm + no * templ;
+        double xlm = mm + argpm + nodem;
+        nodem = std::fmod(nodem, twopi);
+        argpm = std::fmod(argpm, twopi);
+        xlm = std::fmod(xlm, twopi);
+        mm = std::fmod(xlm - argpm - nodem, twopi);
+
+        // --- lunar-solar periodics ---
+        double sinim = std::sin(inclm);
+        double cosim = std::cos(inclm);
+        double ep = em, xincp = inclm, argpp = argpm, nodep = nodem, mp = mm;
+        double sinip = sinim, cosip = cosim;
+        if (deepSpace) {
+            dpper(t, ep, xincp, nodep, argpp, mp);
+            if (xincp < 0.0) {
+                xincp = -xincp;
+                nodep = nodep + M_PI;
+                argpp = argpp - M_PI;
+            }
+            if (ep < 0.0 || ep > 1.0) { error = BAD_PERTURBED_ECC; return error; }
+        }
+
+        // --- long period periodics ---
+        double aycofp = aycof, xlcofp = xlcof;
+        if (deepSpace) {
+            sinip = std::sin(xincp);
+            cosip = std::cos(xincp);
+            aycofp = -0.5 * SGP4_J3OJ2 * sinip;
+            if (std::fabs(cosip + 1.0) > 1.5e-12) xlcofp = -0.25 * SGP4_J3OJ2 * sinip * (3.0 + 5.0 * cosip) / (1.0 + cosip);
+            else xlcofp = -0.25 * SGP4_J3OJ2 * sinip * (3.0 + 5.0 * cosip) / temp4;
+        }
+        double axnl = ep * std::cos(argpp);
+        double temp = 1.0 / (am * (1.0 - ep * ep));
+        double aynl = ep * std::sin(argpp) + temp * aycofp;
+        double xl = mp + argpp + nodep + temp * xlcofp * axnl;
+
+        // --- solve Kepler's equation ---
+        double u = std::fmod(xl - nodep, twopi);
+        double eo1 = u, tem5 = 9999.9, sineo1 = 0, coseo1 = 0;
+        for (int ktr = 1; std::fabs(tem5) >= 1.0e-12 && ktr <= 10; ktr++) {
+            sineo1 = std::sin(eo1);
+            coseo1 = std::cos(eo1);
+            tem5 = 1.0 - coseo1 * axnl - sineo1 * aynl;
+            tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+            if (std::fabs(tem5) >= 0.95) tem5 = tem5 > 0.0 ? 0.95 : -0.95;
+            eo1 = eo1 + tem5;
+        }
+
+        // --- short period preliminary quantities ---
+        double ecose = axnl * coseo1 + aynl * sineo1;
+        double esine = axnl * sineo1 - aynl * coseo1;
+        double el2 = axnl * axnl + aynl * aynl;
+        double pl = am * (1.0 - el2);
+        if (pl < 0.0) { error = BAD_SEMILATUS; return error; }
+
+        double rl = am * (1.0 - ecose);
+        double rdotl = std::sqrt(am) * esine / rl;
+        double rvdotl = std::sqrt(pl) / rl;
+        double betal = std::sqrt(1.0 - el2);
+        temp = esine / (1.0 + betal);
+        double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+        double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+        double su = std::atan2(sinu, cosu);
+        double sin2u = (cosu + cosu) * sinu;
+        double cos2u = 1.0 - 2.0 * sinu * sinu;
+        temp = 1.0 / pl;
+        double temp1 = 0.5 * SGP4_J2 * temp;
+        double temp2 = temp1 * temp;
+
+        double con41p = con41, x1mth2p = x1mth2, x7thm1p = x7thm1;
+        if (deepSpace) {
+            double cosisq = cosip * cosip;
+            con41p = 3.0 * cosisq - 1.0;
+            x1mth2p = 1.0 - cosisq;
+            x7thm1p = 7.0 * cosisq - 1.0;
+        }
+
+        // --- update for short period periodics ---
+        double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41p) + 0.5 * temp1 * x1mth2p * cos2u;
+        su = su - 0.25 * temp2 * x7thm1p * sin2u;
+        double xnode = nodep + 1.5 * temp2 * cosip * sin2u;
+        double xinc = xincp + 1.5 * temp2 * cosip * sinip * cos2u;
+        double mvt = rdotl - nm * temp1 * x1mth2p * sin2u / SGP4_XKE;
+        double rvdot = rvdotl + nm * temp1 * (x1mth2p * cos2u + 1.5 * con41p) / SGP4_XKE;
+
+        // --- orientation vectors ---
+        double sinsu = std::sin(su), cossu = std::cos(su);
+        double snod = std::sin(xnode), cnod = std::cos(xnode);
+        double sini = std::sin(xinc), cosi = std::cos(xinc);
+        double xmx = -snod * cosi;
+        double xmy = cnod * cosi;
+        double ux = xmx * sinsu + cnod * cossu;
+        double uy = xmy * sinsu + snod * cossu;
+        double uz = sini * sinsu;
+        double vx = xmx * cossu - cnod * sinsu;
+        double vy = xmy * cossu - snod * sinsu;
+        double vz = sini * cossu;
+
+        r[0] = mrt * ux * SGP4_RE;
+        r[1] = mrt * uy * SGP4_RE;
+        r[2] = mrt * uz * SGP4_RE;
+        v[0] = (mvt * ux + rvdot * vx) * vkmpersec;
+        v[1] = (mvt * uy + rvdot * vy) * vkmpersec;
+        v[2] = (mvt * uz + rvdot * vz) * vkmpersec;
+
+        if (mrt < 1.0) error = DECAYED;
+        return error;
+    }
+
+    // Convenience for the viewer/propagator code: seconds since `refJD`,
+    // position in meters (TEME ~ ECI). Callers must check the result: any
+    // error (decay included) means the object has no usable position.
+    int positionAt(double refJD, double t, Vector3& pos) {
+        double r[3], v[3];
+        int err = propagate((refJD - jdEpoch) * MIN_PER_DAY + t / 60.0, r, v);
+        pos = {r[0] * 1000.0, r[1] * 1000.0, r[2] * 1000.0};
+        return err;
+    }
+
+private:
+    // ------------------------------------------------------------------------
+    // Deep-space common terms (lunar and solar perturbation coefficients)
+    void dscom(double epoch, double ep, double argpp, double tc, double inclp, double nodep, double np,
+               double& snodm, double& cnodm, double& sinim, double& cosim, double& sinomm, double& cosomm,
+               double& day, double& em, double& emsq, double& gam, double& rtemsq,
+               double& s1, double& s2, double& s3, double& s4, double& s5, double& s6, double& s7,
+               double& ss1, double& ss2, double& ss3, double& ss4, double& ss5, double& ss6, double& ss7,
+               double& sz1, double& sz2, double& sz3, double& sz11, double& sz12, double& sz13,
+               double& sz21, double& sz22, double& sz23, double& sz31, double& sz32, double& sz33,
+               double& nm, double& z1, double& z2, double& z3, double& z11, double& z12, double& z13,
+               double& z21, double& z22, double& z23, double& z31, double& z32, double& z33) {
+        const double zes = 0.01675, zel = 0.05490, c1ss = 2.9864797e-6, c1l = 4.7968065e-7;
+        const double zsinis = 0.39785416, zcosis = 0.91744867, zcosgs = 0.1945905, zsings = -0.98088458;
+        const double twopi = 2 * M_PI;
+
+        nm = np;
+        em = ep;
+        snodm = std::sin(nodep);
+        cnodm = std::cos(nodep);
+        sinomm = std::sin(argpp);
+        cosomm = std::cos(argpp);
+        sinim = std::sin(inclp);
+        cosim = std::cos(inclp);
+        emsq = em * em;
+        double betasq = 1.0 - emsq;
+        rtemsq = std::sqrt(betasq);
+
+        peo = pinco = plo = pgho = pho = 0.0;
+        day = epoch + 18261.5 + tc / 1440.0;
+        double xnodce = std::fmod(4.5236020 - 9.2422029e-4 * day, twopi);
+        double stem = std::sin(xnodce);
+        double ctem = std::cos(xnodce);
+        double zcosil = 0.91375164 - 0.03568096 * ctem;
+        double zsinil = std::sqrt(1.0 - zcosil * zcosil);
+        double zsinhl = 0.089683511 * stem / zsinil;
+        double zcoshl = std::sqrt(1.0 - zsinhl * zsinhl);
+        gam = 5.8351514 + 0.0019443680 * day;
+        double zx = 0.39785416 * stem / zsinil;
+        double zy = zcoshl * ctem + 0.91744867 * zsinhl * stem;
+        zx = std::atan2(zx, zy);
+        zx = gam + zx - xnodce;
+        double zcosgl = std::cos(zx);
+        double zsingl = std::sin(zx);
+
+        // Solar terms first, then lunar (lsflg = 2)
+        double zcosg = zcosgs, zsing = zsings, zcosi = zcosis, zsini = zsinis;
+        double zcosh = cnodm, zsinh = snodm, cc = c1ss, xnoi = 1.0 / nm;
+
+        for (int lsflg = 1; lsflg <= 2; lsflg++) {
+            double a1 = zcosg * zcosh + zsing * zcosi * zsinh;
+            double a3 = -zsing * zcosh + zcosg * zcosi * zsinh;
+            double a7 = -zcosg * zsinh + zsing * zcosi * zcosh;
+            double a8 = zsing * zsini;
+            double a9 = zsing * zsinh + zcosg * zcosi * zcosh;
+            double a10 = zcosg * zsini;
+            double a2 = cosim * a7 + sinim * a8;
+            double a4 = cosim * a9 + sinim * a10;
+            double a5 = -sinim * a7 + cosim * a8;
+            double a6 = -sinim * a9 + cosim * a10;
+
+            double x1 = a1 * cosomm + a2 * sinomm;
+            double x2 = a3 * cosomm + a4 * sinomm;
+            double x3 = -a1 * sinomm + a2 * cosomm;
+            double x4 = -a3 * sinomm + a4 * cosomm;
+            double x5 = a5 * sinomm;
+            double x6 = a6 * sinomm;
+            double x7 = a5 * cosomm;
+            double x8 = a6 * cosomm;
+
+            z31 = 12.0 * x1 * x1 - 3.0 * x3 * x3;
+            z32 = 24.0 * x1 * x2 - 6.0 * x3 * x4;
+            z33 = 12.0 * x2 * x2 - 3.0 * x4 * x4;
+            z1 = 3.0 * (a1 * a1 + a2 * a2) + z31 * emsq;
+            z2 = 6.0 * (a1 * a3 + a2 * a4) + z32 * emsq;
+            z3 = 3.0 * (a3 * a3 + a4 * a4) + z33 * emsq;
+            z11 = -6.0 * a1 * a5 + emsq * (-24.0 * x1 * x7 - 6.0 * x3 * x5);
+            z12 = -6.0 * (a1 * a6 + a3 * a5) + emsq * (-24.0 * (x2 * x7 + x1 * x8) - 6.0 * (x3 * x6 + x4 * x5));
+            z13 = -6.0 * a3 * a6 + emsq * (-24.0 * x2 * x8 - 6.0 * x4 * x6);
+            z21 = 6.0 * a2 * a5 + emsq * (24.0 * x1 * x5 - 6.0 * x3 * x7);
+            z22 = 6.0 * (a4 * a5 + a2 * a6) + emsq * (24.0 * (x2 * x5 + x1 * x6) - 6.0 * (x4 * x7 + x3 * x8));
+            z23 = 6.0 * a4 * a6 + emsq * (24.0 * x2 * x6 - 6.0 * x4 * x8);
+            z1 = z1 + z1 + betasq * z31;
+            z2 = z2 + z2 + betasq * z32;
+            z3 = z3 + z3 + betasq * z33;
+            s3 = cc * xnoi;
+            s2 = -0.5 * s3 / rtemsq;
+            s4 = s3 * rtemsq;
+            s1 = -15.0 * em * s4;
+            s5 = x1 * x3 + x2 * x4;
+            s6 = x2 * x3 + x1 * x4;
+            s7 = x2 * x4 - x1 * x3;
+
+            if (lsflg == 1) {
+                ss1 = s1; ss2 = s2; ss3 = s3; ss4 = s4; ss5 = s5; ss6 = s6; ss7 = s7;
+                sz1 = z1; sz2 = z2; sz3 = z3;
+                sz11 = z11; sz12 = z12; sz13 = z13;
+                sz21 = z21; sz22 = z22; sz23 = z23;
+                sz31 = z31; sz32 = z32; sz33 = z33;
+                zcosg = zcosgl;
+                zsing = zsingl;
+                zcosi = zcosil;
+                zsini = zsinil;
+                zcosh = zcoshl * cnodm + zsinhl * snodm;
+                zsinh = snodm * zcoshl - cnodm * zsinhl;
+                cc = c1l;
+            }
+        }
+
+        zmol = std::fmod(4.7199672 + 0.22997150 * day - gam, twopi);
+        zmos = std::fmod(6.2565837 + 0.017201977 * day, twopi);
+
+        // Solar
+        se2 = 2.0 * ss1 * ss6;
+        se3 = 2.0 * ss1 * ss7;
+        si2 = 2.0 * ss2 * sz12;
+        si3 = 2.0 * ss2 * (sz13 - sz11);
+        sl2 = -2.0 * ss3 * sz2;
+        sl3 = -2.0 * ss3 * (sz3 - sz1);
+        sl4 = -2.0 * ss3 * (-21.0 - 9.0 * emsq) * zes;
+        sgh2 = 2.0 * ss4 * sz32;
+        sgh3 = 2.0 * ss4 * (sz33 - sz31);
+        sgh4 = -18.0 * ss4 * zes;
+        sh2 = -2.0 * ss2 * sz22;
+        sh3 = -2.0 * ss2 * (sz23 - sz21);
+
+        // Lunar
+        ee2 = 2.0 * s1 * s6;
+        e3 = 2.0 * s1 * s7;
+        xi2 = 2.0 * s2 * z12;
+        xi3 = 2.0 * s2 * (z13 - z11);
+        xl2 = -2.0 * s3 * z2;
+        xl3 = -2.0 * s3 * (z3 - z1);
+        xl4 = -2.0 * s3 * (-21.0 - 9.0 * emsq) * zel;
+        xgh2 = 2.0 * s4 * z32;
+        xgh3 = 2.0 * s4 * (z33 - z31);
+        xgh4 = -18.0 * s4 * zel;
+        xh2 = -2.0 * s2 * z22;
+        xh3 = -2.0 * s2 * (z23 - z21);
+    }
+
+    // ------------------------------------------------------------------------
+    // Deep-space long-period periodics (lunar-solar), applied every step
+    void dpper(double t, double& ep, double& inclp, double& nodep, double& argpp, double& mp) const {
+        const double zns = 1.19459e-5, zes = 0.01675, znl = 1.5835218e-4, zel = 0.05490;
+        const double twopi = 2 * M_PI;
+
+        double zm = zmos + zns * t;
+        double zf = zm + 2.0 * zes * std::sin(zm);
+        double sinzf = std::sin(zf);
+        double f2 = 0.5 * sinzf * sinzf - 0.25;
+        double f3 = -0.5 * sinzf * std::cos(zf);
+        double ses = se2 * f2 + se3 * f3;
+        double sis = si2 * f2 + si3 * f3;
+        double sls = sl2 * f2 + sl3 * f3 + sl4 * sinzf;
+        double sghs = sgh2 * f2 + sgh3 * f3 + sgh4 * sinzf;
+        double shs = sh2 * f2 + sh3 * f3;
+
+        zm = zmol + znl * t;
+        zf = zm + 2.0 * zel * std::sin(zm);
+        sinzf = std::sin(zf);
+        f2 = 0.5 * sinzf * sinzf - 0.25;
+        f3 = -0.5 * sinzf * std::cos(zf);
+        double sel = ee2 * f2 + e3 * f3;
+        double sil = xi2 * f2 + xi3 * f3;
+        double sll = xl2 * f2 + xl3 * f3 + xl4 * sinzf;
+        double sghl = xgh2 * f2 + xgh3 * f3 + xgh4 * sinzf;
+        double shll = xh2 * f2 + xh3 * f3;
+
+        double pe = ses + sel - peo;
+        double pinc = sis + sil - pinco;
+        double pl = sls + sll - plo;
+        double pgh = sghs + sghl - pgho;
+        double ph = shs + shll - pho;
+
+        inclp = inclp + pinc;
+        ep = ep + pe;
+        double sinip = std::sin(inclp);
+        double cosip = std::cos(inclp);
+
+        if (inclp >= 0.2) {
+            ph = ph / sinip;
+            pgh = pgh - cosip * ph;
+            argpp = argpp + pgh;
+            nodep = nodep + ph;
+            mp = mp + pl;
+        } else {
+            // Lyddane modification for low inclinations
+            double sinop = std::sin(nodep);
+            double cosop = std::cos(nodep);
+            double alfdp = sinip * sinop;
+            double betdp = sinip * cosop;
+            double dalf = ph * cosop + pinc * cosip * sinop;
+            double dbet = -ph * sinop + pinc * cosip * cosop;
+            alfdp = alfdp + dalf;
+            betdp = betdp + dbet;
+            nodep = std::fmod(nodep, twopi);
+            double xls = mp + argpp + cosip * nodep;
+            double dls = pl + pgh - pinc * nodep * sinip;
+            xls = xls + dls;
+            double xnoh = nodep;
+            nodep = std::atan2(alfdp, betdp);
+            if (std::fabs(xnoh - nodep) > M_PI) {
+                if (nodep < xnoh) nodep = nodep + twopi;
+                else nodep = nodep - twopi;
+            }
+            mp = mp + pl;
+            argpp = xls - mp - cosip * nodep;
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Deep-space secular rates and resonance coefficients (12 h / 24 h orbits)
+    void dsinit(double cosim, double emsq, double s1, double s2, double s3, double s4, double s5,
+                double sinim, double ss1, double ss2, double ss3, double ss4, double ss5,
+                double sz1, double sz3, double sz11, double sz13, double sz21, double sz23, double sz31, double sz33,
+                double t, double tc, double xpidot,
+                double z1, double z3, double z11, double z13, double z21, double z23, double z31, double z33,
+                double eccsq, double& em, double& argpm, double& inclm, double& mm, double& nm, double& nodem) {
+        const double q22 = 1.7891679e-6, q31 = 2.1460748e-6, q33 = 2.2123015e-7;
+        const double root22 = 1.7891679e-6, root44 = 7.3636953e-9, root54 = 2.1765803e-9;
+        const double rptim = 4.37526908801129966e-3;   // earth rotation [rad/min]
+        const double root32 = 3.7393792e-7, root52 = 1.1428639e-7;
+        const double x2o3 = 2.0 / 3.0;
+        const double znl = 1.5835218e-4, zns = 1.19459e-5;
+        const double twopi = 2 * M_PI;
+
+        irez = 0;
+        if (nm < 0.0052359877 && nm > 0.0034906585) irez = 1;
+        if (nm >= 8.26e-3 && nm <= 9.24e-3 && em >= 0.5) irez = 2;
+
+        // Solar terms
+        double ses = ss1 * zns * ss5;
+        double sis = ss2 * zns * (sz11 + sz13);
+        double sls = -zns * ss3 * (sz1 + sz3 - 14.0 - 6.0 * emsq);
+        double sghs = ss4 * zns * (sz31 + sz33 - 6.0);
+        double shs = -zns * ss2 * (sz21 + sz23);
+        if (inclm < 5.2359877e-2 || inclm > M_PI - 5.2359877e-2) shs = 0.0;
+        if (sinim != 0.0) shs = shs / sinim;
+        double sgs = sghs - cosim * shs;
+
+        // Lunar terms
+        dedt = ses + s1 * znl * s5;
+        didt = sis + s2 * znl * (z11 + z13);
+        dmdt = sls - znl * s3 * (z1 + z3 - 14.0 - 6.0 * emsq);
+        double sghl = s4 * znl * (z31 + z33 - 6.0);
+        double shll = -znl * s2 * (z21 + z23);
+        if (inclm < 5.2359877e-2 || inclm > M_PI - 5.2359877e-2) shll = 0.0;
+        domdt = sgs + sghl;
+        dnodt = shs;
+        if (sinim != 0.0) {
+            domdt = domdt - cosim / sinim * shll;
+            dnodt = dnodt + shll / sinim;
+        }
+
+        // Deep space resonance effects
+        double dndt = 0.0;
+        double theta = std::fmod(gsto + tc * rptim, twopi);
+        em = em + dedt * t;
+        inclm = inclm + didt * t;
+        argpm = argpm + domdt * t;
+        nodem = nodem + dnodt * t;
+        mm = mm + dmdt * t;
+
+        if (irez != 0) {
+            double aonv = std::pow(nm / SGP4_XKE, x2o3);
+
+            // Geopotential resonance for 12 hour orbits
+            if (irez == 2) {
+                double cosisq = cosim * cosim;
+                double emo = em;
+                em = ecco;
+                double emsqo = emsq;
+                emsq = eccsq;
+                double eoc = em * emsq;
+                double g201 = -0.306 - (em - 0.64) * 0.440;
+                double g211, g310, g322, g410, g422, g520, g521, g532, g533;
+
+                if (em <= 0.65) {
+                    g211 = 3.616 - 13.2470 * em + 16.2900 * emsq;
+                    g310 = -19.302 + 117.3900 * em - 228.4190 * emsq + 156.5910 * eoc;
+                    g322 = -18.9068 + 109.7927 * em - 214.6334 * emsq + 146.5816 * eoc;
+                    g410 = -41.122 + 242.6940 * em - 471.0940 * emsq + 313.9530 * eoc;
+                    g422 = -146.407 + 841.8800 * em - 1629.014 * emsq + 1083.4350 * eoc;
+                    g520 = -532.114 + 3017.977 * em - 5740.032 * emsq + 3708.2760 * eoc;
+                } else {
+                    g211 = -72.099 + 331.819 * em - 508.738 * emsq + 266.724 * eoc;
+                    g310 = -346.844 + 1582.851 * em - 2415.925 * emsq + 1246.113 * eoc;
+                    g322 = -342.585 + 1554.908 * em - 2366.899 * emsq + 1215.972 * eoc;
+                    g410 = -1052.797 + 4758.686 * em - 7193.992 * emsq + 3651.957 * eoc;
+                    g422 = -3581.690 + 16178.110 * em - 24462.770 * emsq + 12422.520 * eoc;
+                    if (em > 0.715) g520 = -5149.66 + 29936.92 * em - 54087.36 * emsq + 31324.56 * eoc;
+                    else g520 = 1464.74 - 4664.75 * em + 3763.64 * emsq;
+                }
+                if (em < 0.7) {
+                    g533 = -919.22770 + 4988.6100 * em - 9064.7700 * emsq + 5542.21 * eoc;
+                    g521 = -822.71072 + 4568.6173 * em - 8491.4146 * emsq + 5337.524 * eoc;
+                    g532 = -853.66600 + 4690.2500 * em - 8624.7700 * emsq + 5341.4 * eoc;
+                } else {
+                    g533 = -37995.780 + 161616.52 * em - 229838.20 * emsq + 109377.94 * eoc;
+                    g521 = -51752.104 + 218913.95 * em - 309468.16 * emsq + 146349.42 * eoc;
+                    g532 = -40023.880 + 170470.89 * em - 242699.48 * emsq + 115605.82 * eoc;
+                }
+
+                double sini2 = sinim * sinim;
+                double f220 = 0.75 * (1.0 + 2.0 * cosim + cosisq);
+                double f221 = 1.5 * sini2;
+                double f321 = 1.875 * sinim * (1.0 - 2.0 * cosim - 3.0 * cosisq);
+                double f322 = -1.875 * sinim * (1.0 + 2.0 * cosim - 3.0 * cosisq);
+                double f441 = 35.0 * sini2 * f220;
+                double f442 = 39.3750 * sini2 * sini2;
+                double f522 = 9.84375 * sinim * (sini2 * (1.0 - 2.0 * cosim - 5.0 * cosisq)
+                            + 0.33333333 * (-2.0 + 4.0 * cosim + 6.0 * cosisq));
+                double f523 = sinim * (4.92187512 * sini2 * (-2.0 - 4.0 * cosim + 10.0 * cosisq)
+                            + 6.56250012 * (1.0 + 2.0 * cosim - 3.0 * cosisq));
+                double f542 = 29.53125 * sinim * (2.0 - 8.0 * cosim + cosisq * (-12.0 + 8.0 * cosim + 10.0 * cosisq));
+                double f543 = 29.53125 * sinim * (-2.0 - 8.0 * cosim + cosisq * (12.0 + 8.0 * cosim - 10.0 * cosisq));
+                double xno2 = nm * nm;
+                double ainv2 = aonv * aonv;
+                double temp1 = 3.0 * xno2 * ainv2;
+                double temp = temp1 * root22;
+                d2201 = temp * f220 * g201;
+                d2211 = temp * f221 * g211;
+                temp1 = temp1 * aonv;
+                temp = temp1 * root32;
+                d3210 = temp * f321 * g310;
+                d3222 = temp * f322 * g322;
+                temp1 = temp1 * aonv;
+                temp = 2.0 * temp1 * root44;
+                d4410 = temp * f441 * g410;
+                d4422 = temp * f442 * g422;
+                temp1 = temp1 * aonv;
+                temp = temp1 * root52;
+                d5220 = temp * f522 * g520;
+                d5232 = temp * f523 * g532;
+                temp = 2.0 * temp1 * root54;
+                d5421 = temp * f542 * g521;
+                d5433 = temp * f543 * g533;
+                xlamo = std::fmod(mo + nodeo + nodeo - theta - theta, twopi);
+                xfact = mdot + dmdt + 2.0 * (nodedot + dnodt - rptim) - no;
+                em = emo;
+                emsq = emsqo;
+            }
+
+            // Synchronous resonance terms
+            if (irez == 1) {
+                double g200 = 1.0 + emsq * (-2.5 + 0.8125 * emsq);
+                double g310 = 1.0 + 2.0 * emsq;
+                double g300 = 1.0 + emsq * (-6.0 + 6.60937 * emsq);
+                double f220 = 0.75 * (1.0 + cosim) * (1.0 + cosim);
+                double f311 = 0.9375 * sinim * sinim * (1.0 + 3.0 * cosim) - 0.75 * (1.0 + cosim);
+                double f330 = 1.0 + cosim;
+                f330 = 1.875 * f330 * f330 * f330;
+                del1 = 3.0 * nm * nm * aonv * aonv;
+                del2 = 2.0 * del1 * f220 * g200 * q22;
+                del3 = 3.0 * del1 * f330 * g300 * q33 * aonv;
+                del1 = del1 * f311 * g310 * q31 * aonv;
+                xlamo = std::fmod(mo + nodeo + argpo - theta, twopi);
+                xfact = mdot + xpidot - rptim + dmdt + domdt + dnodt - no;
+            }
+
+            // Initialize the resonance integrator
+            xli = xlamo;
+            xni = no;
+            atime = 0.0;
+            nm = no + dndt;
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Deep-space secular effects + resonance integration (Euler-Maclaurin, 720 min steps)
+    void dspace(double t, double tc, double& em, double& argpm, double& inclm, double& mm,
+                double& nodem, double& nm) {
+        const double fasx2 = 0.13130908, fasx4 = 2.8843198, fasx6 = 0.37448087;
+        const double g22 = 5.7686396, g32 = 0.95240898, g44 = 1.8014998, g52 = 1.0508330, g54 = 4.4108898;
+        const double rptim = 4.37526908801129966e-3;
+        const double stepp = 720.0, stepn = -720.0, step2 = 259200.0;
+        const double twopi = 2 * M_PI;
+
+        double dndt = 0.0;
+        double theta = std::fmod(gsto + tc * rptim, twopi);
+        em = em + dedt * t;
+        inclm = inclm + didt * t;
+        argpm = argpm + domdt * t;
+        nodem = nodem + dnodt * t;
+        mm = mm + dmdt * t;
+
+        if (irez == 0) return;
+
+        // Restart from epoch when stepping backwards or changing direction
+        if (atime == 0.0 || t * atime <= 0.0 || std::fabs(t) < std::fabs(atime)) {
+            atime = 0.0;
+            xni = no;
+            xli = xlamo;
+        }
+        double delt = (t > 0.0) ? stepp : stepn;
+        double ft = 0.0, xndt = 0.0, xldot = 0.0, xnddt = 0.0;
+
+        for (;;) {
+            if (irez != 2) {
+                // Near-synchronous
+                xndt = del1 * std::sin(xli - fasx2) + del2 * std::sin(2.0 * (xli - fasx4))
+                     + del3 * std::sin(3.0 * (xli - fasx6));
+                xldot = xni + xfact;
+                xnddt = del1 * std::cos(xli - fasx2) + 2.0 * del2 * std::cos(2.0 * (xli - fasx4))
+                      + 3.0 * del3 * std::cos(3.0 * (xli - fasx6));
+                xnddt = xnddt * xldot;
+            } else {
+                // Near half-day
+                double xomi = argpo + argpdot * atime;
+                double x2omi = xomi + xomi;
+                double x2li = xli + xli;
+                xndt = d2201 * std::sin(x2omi + xli - g22) + d2211 * std::sin(xli - g22)
+                     + d3210 * std::sin(xomi + xli - g32) + d3222 * std::sin(-xomi + xli - g32)
+                     + d4410 * std::sin(x2omi + x2li - g44) + d4422 * std::sin(x2li - g44)
+                     + d5220 * std::sin(xomi + xli - g52) + d5232 * std::sin(-xomi + xli - g52)
+                     + d5421 * std::sin(xomi + x2li - g54) + d5433 * std::sin(-xomi + x2li - g54);
+                xldot = xni + xfact;
+                xnddt = d2201 * std::cos(x2omi + xli - g22) + d2211 * std::cos(xli - g22)
+                      + d3210 * std::cos(xomi + xli - g32) + d3222 * std::cos(-xomi + xli - g32)
+                      + d5220 * std::cos(xomi + xli - g52) + d5232 * std::cos(-xomi + xli - g52)
+                      + 2.0 * (d4410 * std::cos(x2omi + x2li - g44) + d4422 * std::cos(x2li - g44)
+                             + d5421 * std::cos(xomi + x2li - g54) + d5433 * std::cos(-xomi + x2li - g54));
+                xnddt = xnddt * xldot;
+            }
+
+            if (std::fabs(t - atime) >= stepp) {
+                xli = xli + xldot * delt + xndt * step2;
+                xni = xni + xndt * delt + xnddt * step2;
+                atime = atime + delt;
+            } else {
+                ft = t - atime;
+                break;
+            }
+        }
+
+        nm = xni + xndt * ft + xnddt * ft * ft * 0.5;
+        double xl = xli + xldot * ft + xndt * ft * ft * 0.5;
+        if (irez != 1) mm = xl - 2.0 * nodem + 2.0 * theta;
+        else mm = xl - nodem - argpm + theta;
+        dndt = nm - no;
+        nm = no + dndt;
+    }
+};
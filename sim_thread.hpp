@@ -0,0 +1,120 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+// ============================================================================
+// Physics on its own thread, state handed to the renderer without locks.
+//
+// TripleBuffer<T>: one writer, one reader, three copies of T. The writer
+// fills its private back buffer and publish()es it by swapping it with the
+// shared middle slot; the reader's acquire() swaps the middle slot with its
+// private front buffer when something new was published. Neither side ever
+// waits for the other: the reader always holds a complete snapshot (the
+// newest one), the writer always has a buffer to fill. The writer must
+// rewrite every field it uses, since its back buffer holds an old frame.
+//
+// FixedStepThread runs step() at a fixed rate on a dedicated thread and
+// measures the steps per second it actually achieved. When a step runs
+// long it catches up, but never by more than MAX_CATCH_UP steps, so one
+// slow step cannot turn into a burst that starves everything else.
+// ============================================================================
+
+template <class T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& back() { return buffers[backIndex]; }
+    void publish() {
+        uint8_t old = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel);
+        backIndex = old & INDEX;
+    }
+
+    // Reader side: true if a newer snapshot was taken; front() is the latest
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t old = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = old & INDEX;
+        return true;
+    }
+    const T& front() const { return buffers[frontIndex]; }
+    T& front() { return buffers[frontIndex]; }
+
+    // Same object in all three slots (sizes vectors once, before start)
+    void fill(const T& value) {
+        for (auto& b : buffers) b = value;
+    }
+
+private:
+    static const uint8_t INDEX = 3, FRESH = 4;
+    T buffers[3];
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t backIndex = 0;      // writer-owned
+    alignas(64) uint8_t frontIndex = 2;     // reader-owned
+};
+
+class FixedStepThread {
+public:
+    static const int MAX_CATCH_UP = 5;
+
+    FixedStepThread() = default;
+    FixedStepThread(const FixedStepThread&) = delete;
+    FixedStepThread& operator=(const FixedStepThread&) = delete;
+    ~FixedStepThread() { stop(); }
+
+    // step() is called `stepsPerSecond` times per wall-clock second
+    void start(double stepsPerSecond, std::function<void()> step) {
+        stop();
+        rate.store(stepsPerSecond);
+        running.store(true);
+        worker = std::thread([this, step] { loop(step); });
+    }
+
+    void stop() {
+        running.store(false);
+        if (worker.joinable()) worker.join();
+    }
+
+    bool isRunning() const { return running.load(); }
+    void setRate(double stepsPerSecond) { rate.store(stepsPerSecond); }
+    uint64_t steps() const { return stepCount.load(std::memory_order_relaxed); }
+    double measuredRate() const { return measured.load(std::memory_order_relaxed); }     // steps/s, last ~0.5 s
+    double stepSeconds() const { return stepTime.load(std::memory_order_relaxed); }      // wall time of one step
+
+private:
+    void loop(const std::function<void()>& step) {
+        using Clock = std::chrono::steady_clock;
+        auto next = Clock::now();
+        auto windowStart = next;
+        uint64_t windowSteps = 0;
+        double stepAvg = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate.load()));
+            auto t0 = Clock::now();
+            step();
+            auto t1 = Clock::now();
+            stepCount.fetch_add(1, std::memory_order_relaxed);
+            windowSteps++;
+            stepAvg += 0.1 * (std::chrono::duration<double>(t1 - t0).count() - stepAvg);
+            stepTime.store(stepAvg, std::memory_order_relaxed);
+
+            double window = std::chrono::duration<double>(t1 - windowStart).count();
+            if (window >= 0.5) {
+                measured.store(windowSteps / window, std::memory_order_relaxed);
+                windowStart = t1;
+                windowSteps = 0;
+            }
+
+            next += period;
+            if (next < t1 - period * MAX_CATCH_UP) next = t1 - period * MAX_CATCH_UP;
+            if (next > t1) std::this_thread::sleep_until(next);
+        }
+    }
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<double> rate{60.0}, measured{0.0}, stepTime{0.0};
+    std::atomic<uint64_t> stepCount{0};
+};
@@ -0,0 +1,311 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ============================================================================
+// Live state in POSIX shared memory, for other processes on the machine.
+//
+// StatePublisher (the simulation) owns a shm_open() object laid out as
+//
+//   header   StateShmHeader (128 bytes): layout, and `latest`, the newest
+//            complete frame number (0 = none yet)
+//   slots    `slots` fixed-size frames, frame f in slot f % slots:
+//              StateSlotHeader (64 bytes: seq, frame, sim time, count,
+//              publish time), then columns x, y, z, vx, vy, vz (double,
+//              ECI m and m/s) and flags (uint8, STATE_VISIBLE_*), each
+//              column padded to 64 bytes
+//
+// Each slot is a seqlock: seq is odd while the slot is being written and
+// 2 * frame once frame is complete. Readers copy (or use in place) and then
+// check seq again; they never write to the mapping, so they map it
+// read-only, and the simulation never waits for them. With a ring of slots
+// a reader has slots - 1 frames of time before the slot it is reading gets
+// reused, so retries only happen to readers that fall that far behind.
+//
+// The publisher fills a slot in place: begin() hands out the column
+// pointers, commit() makes the frame visible. publishNs is steady_clock
+// (CLOCK_MONOTONIC on Linux), which is the same clock in every process, so
+// readers can measure latency directly.
+//
+// StateSubscriber is the reader side: latest(), read() a frame into a
+// StateFrame, or view() it in place and stillValid() afterwards.
+// ============================================================================
+
+const char STATE_SHM_MAGIC[8] = {'O', 'R', 'B', 'S', 'T', 'A', 'T', 'E'};
+const uint32_t STATE_SHM_VERSION = 1;
+const uint8_t STATE_VISIBLE_HOME = 1;       // seen by station 0
+const uint8_t STATE_VISIBLE_ANY = 2;        // seen by any station
+
+struct StateShmHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slots;
+    uint64_t objects;           // column capacity
+    uint64_t slotBytes;
+    uint64_t headerBytes;       // offset of slot 0
+    uint64_t reserved[3];
+    alignas(64) std::atomic<uint64_t> latest;
+    uint64_t pad[7];
+};
+static_assert(sizeof(StateShmHeader) == 128, "state header layout");
+
+struct StateSlotHeader {
+    std::atomic<uint64_t> seq;
+    uint64_t frame;
+    double simTime;             // s
+    uint64_t count;             // objects in this frame
+    int64_t publishNs;          // steady_clock at commit
+    uint64_t reserved[3];
+};
+static_assert(sizeof(StateSlotHeader) == 64, "state slot layout");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics");
+
+inline size_t stateColumnBytes(size_t objects, size_t elem) { return (objects * elem + 63) & ~size_t(63); }
+inline size_t stateSlotBytes(size_t objects) {
+    return sizeof(StateSlotHeader) + 6 * stateColumnBytes(objects, sizeof(double)) + stateColumnBytes(objects, 1);
+}
+
+inline int64_t stateClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Column pointers into one slot
+template <class D, class F>
+struct StateColumns {
+    D *x = nullptr, *y = nullptr, *z = nullptr, *vx = nullptr, *vy = nullptr, *vz = nullptr;
+    F* flags = nullptr;
+
+    void point(char* slot, size_t objects) {
+        size_t col = stateColumnBytes(objects, sizeof(double));
+        char* p = slot + sizeof(StateSlotHeader);
+        for (D** c : {&x, &y, &z, &vx, &vy, &vz}) { *c = (D*)p; p += col; }
+        flags = (F*)p;
+    }
+};
+
+class StatePublisher {
+public:
+    static const uint32_t DEFAULT_SLOTS = 4;
+    using Slot = StateColumns<double, uint8_t>;
+
+    StatePublisher() = default;
+    StatePublisher(const StatePublisher&) = delete;
+    StatePublisher& operator=(const StatePublisher&) = delete;
+    ~StatePublisher() { close(); }
+
+    // Create the object `name` ("/orbit3d") for up to `objects`. A stale
+    // one is unlinked first, so readers still mapping it are not cut off.
+    bool open(const char* name, size_t objects, uint32_t slots = DEFAULT_SLOTS) {
+        close();
+        if (slots < 2) slots = 2;
+        shmName = name;
+        ::shm_unlink(name);
+        int fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) { shmName.clear(); return false; }
+        mapBytes = sizeof(StateShmHeader) + slots * stateSlotBytes(objects);
+        bool sized = ::ftruncate(fd, (off_t)mapBytes) == 0;
+        void* p = sized ? ::mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED) { ::shm_unlink(name); shmName.clear(); return false; }
+        base = (char*)p;
+        // Slot seqs start at 0 (even, frame 0: nothing); the header goes last
+        StateShmHeader* h = header();
+        h->version = STATE_SHM_VERSION;
+        h->slots = slots;
+        h->objects = objects;
+        h->slotBytes = stateSlotBytes(objects);
+        h->headerBytes = sizeof(StateShmHeader);
+        h->latest.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(h->magic, STATE_SHM_MAGIC, 8);
+        frame = 0;
+        return true;
+    }
+
+    void close() {
+        if (base) ::munmap(base, mapBytes);
+        if (!shmName.empty()) ::shm_unlink(shmName.c_str());
+        base = nullptr;
+        shmName.clear();
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    size_t capacity() const { return base ? header()->objects : 0; }
+    uint64_t frames() const { return frame; }
+
+    // Start the next frame; fill the returned columns, then commit()
+    Slot begin(double simTime, size_t count) {
+        frame++;
+        StateSlotHeader* s = slotHeader(frame);
+        s->seq.store(2 * frame - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s->frame = frame;
+        s->simTime = simTime;
+        s->count = count < capacity() ? count : capacity();
+        Slot cols;
+        cols.point((char*)s, capacity());
+        return cols;
+    }
+
+    void commit() {
+        StateSlotHeader* s = slotHeader(frame);
+        s->publishNs = stateClockNs();
+        s->seq.store(2 * frame, std::memory_order_release);
+        header()->latest.store(frame, std::memory_order_release);
+    }
+
+    // Copying convenience over begin()/commit(); any column may be null
+    void publish(double simTime, size_t count, const double* x, const double* y, const double* z,
+                 const double* vx, const double* vy, const double* vz, const uint8_t* flags) {
+        Slot s = begin(simTime, count);
+        count = slotHeader(frame)->count;
+        const double* src[6] = {x, y, z, vx, vy, vz};
+        double* dst[6] = {s.x, s.y, s.z, s.vx, s.vy, s.vz};
+        for (int c = 0; c < 6; c++) {
+            if (src[c]) std::memcpy(dst[c], src[c], count * sizeof(double));
+            else std::memset(dst[c], 0, count * sizeof(double));
+        }
+        if (flags) std::memcpy(s.flags, flags, count);
+        else std::memset(s.flags, 0, count);
+        commit();
+    }
+
+private:
+    StateShmHeader* header() const { return (StateShmHeader*)base; }
+    StateSlotHeader* slotHeader(uint64_t f) const {
+        const StateShmHeader* h = header();
+        return (StateSlotHeader*)(base + h->headerBytes + (f % h->slots) * h->slotBytes);
+    }
+
+    char* base = nullptr;
+    size_t mapBytes = 0;
+    std::string shmName;
+    uint64_t frame = 0;
+};
+
+// One consistent frame, copied out of the ring
+struct StateFrame {
+    uint64_t frame = 0;
+    double simTime = 0;
+    int64_t publishNs = 0;
+    std::vector<double> x, y, z, vx, vy, vz;
+    std::vector<uint8_t> flags;
+
+    size_t size() const { return x.size(); }
+};
+
+// A frame read in place; valid only while stillValid() says so
+struct StateView {
+    uint64_t frame = 0;
+    double simTime = 0;
+    int64_t publishNs = 0;
+    size_t count = 0;
+    StateColumns<const double, const uint8_t> columns;
+};
+
+class StateSubscriber {
+public:
+    StateSubscriber() = default;
+    StateSubscriber(const StateSubscriber&) = delete;
+    StateSubscriber& operator=(const StateSubscriber&) = delete;
+    ~StateSubscriber() { close(); }
+
+    // Map `name` read-only; false until a publisher has created it
+    bool open(const char* name) {
+        close();
+        int fd = ::shm_open(name, O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        bool ok = ::fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(StateShmHeader);
+        void* p = ok ? ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = (const char*)p;
+        mapBytes = (size_t)st.st_size;
+        const StateShmHeader* h = header();
+        if (std::memcmp(h->magic, STATE_SHM_MAGIC, 8) != 0 || h->version != STATE_SHM_VERSION || h->slots < 2 ||
+            h->slotBytes != stateSlotBytes(h->objects) || h->headerBytes + h->slots * h->slotBytes > mapBytes) {
+            close();
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    void close() {
+        if (base) ::munmap((void*)base, mapBytes);
+        base = nullptr;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    size_t capacity() const { return header()->objects; }
+    uint32_t slots() const { return header()->slots; }
+
+    // Newest complete frame number (0 = none yet)
+    uint64_t latest() const { return header()->latest.load(std::memory_order_acquire); }
+
+    // Copy frame f; false if it is not published yet or already overwritten
+    bool read(uint64_t f, StateFrame& out) const {
+        StateView v;
+        if (!view(f, v)) return false;
+        for (auto* c : {&out.x, &out.y, &out.z, &out.vx, &out.vy, &out.vz}) c->resize(v.count);
+        out.flags.resize(v.count);
+        const double* src[6] = {v.columns.x, v.columns.y, v.columns.z, v.columns.vx, v.columns.vy, v.columns.vz};
+        std::vector<double>* dst[6] = {&out.x, &out.y, &out.z, &out.vx, &out.vy, &out.vz};
+        for (int c = 0; c < 6; c++) std::memcpy(dst[c]->data(), src[c], v.count * sizeof(double));
+        std::memcpy(out.flags.data(), v.columns.flags, v.count);
+        if (!stillValid(v)) return false;
+        out.frame = v.frame;
+        out.simTime = v.simTime;
+        out.publishNs = v.publishNs;
+        return true;
+    }
+
+    // Newest frame; retries while the writer laps the reader. False if none
+    bool readLatest(StateFrame& out) const {
+        for (int attempt = 0; attempt < 64; attempt++) {
+            uint64_t f = latest();
+            if (f == 0) return false;
+            if (read(f, out)) return true;
+        }
+        return false;
+    }
+
+    // Zero-copy: point v at frame f's columns. Whatever is read through
+    // them only counts if stillValid(v) holds afterwards.
+    bool view(uint64_t f, StateView& v) const {
+        if (f == 0) return false;
+        const StateSlotHeader* s = slotHeader(f);
+        if (s->seq.load(std::memory_order_acquire) != 2 * f) return false;
+        v.frame = f;
+        v.simTime = s->simTime;
+        v.publishNs = s->publishNs;
+        v.count = s->count < capacity() ? s->count : capacity();
+        v.columns.point((char*)s, capacity());
+        return stillValid(v);
+    }
+
+    bool stillValid(const StateView& v) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slotHeader(v.frame)->seq.load(std::memory_order_relaxed) == 2 * v.frame;
+    }
+
+private:
+    const StateShmHeader* header() const { return (const StateShmHeader*)base; }
+    const StateSlotHeader* slotHeader(uint64_t f) const {
+        const StateShmHeader* h = header();
+        return (const StateSlotHeader*)(base + h->headerBytes + (f % h->slots) * h->slotBytes);
+    }
+
+    const char* base = nullptr;
+    size_t mapBytes = 0;
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "integrators.hpp"
+#include <cmath>
+
+// ============================================================================
+// Time warp: advance an orbit by any interval at a cost that does not grow
+// with the interval.
+//
+// TimeWarp::advance() picks one of three paths per call:
+//
+//   Integrated   the interval is at most MAX_INTEGRATED_STEPS steps of the
+//                selected integrator: step through it as before
+//   Analytic     the force is two-body (checked at the current state) and
+//                the orbit is bound: keplerJump(), closed form, O(1)
+//   Adaptive     anything else (perturbed or unbound): DP54 with error
+//                control, whose steps follow the dynamics, not the warp
+//
+// keplerJump() solves Kepler's equation in eccentric-anomaly difference
+// form straight from the state (no element conversion, so circular and
+// equatorial orbits need no special cases) and applies the Lagrange f and
+// g coefficients for position and velocity. The interval is reduced by
+// whole periods first, so long jumps keep full precision.
+//
+// The same jump samples a track backwards from a state (breadcrumbs) at
+// any spacing, instead of keeping every step.
+// ============================================================================
+
+// Two-body state after dt seconds (either sign). False for unbound orbits.
+inline bool keplerJump(OrbitState& s, double dt) {
+    double r0 = s.pos.magnitude(), v2 = s.vel.dot(s.vel);
+    double a = 1.0 / (2.0 / r0 - v2 / MU_EARTH);
+    if (!(a > 0)) return false;
+    double n = std::sqrt(MU_EARTH / (a * a * a)), period = 2 * M_PI / n;
+    dt -= period * std::floor(dt / period + 0.5);           // |dt| <= period / 2
+
+    double sqrtA = std::sqrt(a), sigma = s.pos.dot(s.vel) / std::sqrt(MU_EARTH);
+    double ec = 1.0 - r0 / a, es = sigma / sqrtA;             // e cos E0, e sin E0
+    // n dt = dE - ec sin dE + es (1 - cos dE)
+    double M = n * dt, dE = M;
+    for (int k = 0; k < 30; k++) {
+        double sE = std::sin(dE), cE = std::cos(dE);
+        double f = dE - ec * sE + es * (1 - cE) - M;
+        double step = f / (1 - ec * cE + es * sE);
+        dE -= step;
+        if (std::fabs(step) < 1e-14) break;
+    }
+    double sE = std::sin(dE), cE = std::cos(dE);
+    double r = a + (r0 - a) * cE + sigma * sqrtA * sE;
+    double f = 1 - a / r0 * (1 - cE);
+    double g = dt + (sE - dE) / n;
+    double fDot = -std::sqrt(MU_EARTH * a) / (r * r0) * sE;
+    double gDot = 1 - a / r * (1 - cE);
+    Vector3 p = s.pos * f + s.vel * g;
+    s.vel = s.pos * fDot + s.vel * gDot;
+    s.pos = p;
+    return true;
+}
+
+enum class WarpPath { Integrated, Analytic, Adaptive };
+
+inline const char* warpPathName(WarpPath p) {
+    switch (p) {
+        case WarpPath::Integrated: return "integrated";
+        case WarpPath::Analytic:   return "analytic";
+        case WarpPath::Adaptive:   return "adaptive";
+    }
+    return "?";
+}
+
+class TimeWarp {
+public:
+    static const int MAX_INTEGRATED_STEPS = 64;
+    double perturbationTolerance = 1e-9;    // |a - a_two_body| / |a_two_body| still treated as two-body
+
+    WarpPath lastPath() const { return path; }
+
+    // Advance s from t by `duration` seconds
+    template <class Force>
+    void advance(Integrator& integrator, OrbitState& s, double t, double duration, Force f) {
+        if (duration <= MAX_INTEGRATED_STEPS * integrator.dt) {
+            path = WarpPath::Integrated;
+            integrator.advance(s, t, duration, f);
+            return;
+        }
+        if (isTwoBody(s, t, f) && keplerJump(s, duration)) {
+            path = WarpPath::Analytic;
+            return;
+        }
+        path = WarpPath::Adaptive;
+        adaptive.advance(s, t, duration, f);
+    }
+
+private:
+    template <class Force>
+    bool isTwoBody(const OrbitState& s, double t, Force& f) const {
+        double r2 = s.pos.dot(s.pos), central = MU_EARTH / r2;
+        Vector3 kepler = s.pos * (-central / std::sqrt(r2));
+        return (f(s.pos, s.vel, t) - kepler).magnitude() <= perturbationTolerance * central;
+    }
+
+    Integrator adaptive{IntegratorKind::DormandPrince54, 60.0, 1e-10};
+    WarpPath path = WarpPath::Integrated;
+};
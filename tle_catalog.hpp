@@ -0,0 +1,304 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "kepler_batch.hpp"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ============================================================================
+// TleCatalog: CelesTrak-style TLE / 3LE catalog loader.
+//
+// The file is mmap'd and parsed in place: fixed-column fields are read
+// straight out of the mapping (no std::string per line, no getline), both
+// line checksums are validated, and every good record lands in a flat
+// std::vector<TleRecord>. reload() re-maps the file when its size/mtime
+// changed and only re-parses records whose raw bytes differ (FNV-1a hash
+// per record, matched by catalog number).
+// ============================================================================
+
+const double MIN_PER_DAY = 1440.0;
+const double SEC_PER_DAY = 86400.0;
+
+struct TleRecord {
+    char name[25];          // 3LE title line (blank-padded, NUL-terminated), "" for 2LE
+    int satnum;
+    int epochYear;          // 4-digit
+    double epochDay;        // day of year incl. fraction (1.0 = Jan 1 00:00 UTC)
+    double ndot;            // rev/day^2 (first derivative / 2, as printed)
+    double nddot;           // rev/day^3 (second derivative / 6, as printed)
+    double bstar;           // 1/earth radii
+    double inclination;     // rad
+    double raan;            // rad
+    double ecc;
+    double argPerigee;      // rad
+    double meanAnomaly;     // rad (at epoch)
+    double revsPerDay;      // mean motion as printed
+    uint64_t hash;          // FNV-1a of the raw record, drives incremental reload
+
+    double meanMotion() const { return revsPerDay * (2 * M_PI / SEC_PER_DAY); }   // rad/s
+    // a(1 + e) with a = cbrt(mu / n^2) [m]
+    double apogeeRadius() const { return std::cbrt(MU_EARTH / (meanMotion() * meanMotion())) * (1 + ecc); }
+
+    // Julian date of the element epoch (UTC)
+    double epochJD() const {
+        int y = epochYear - 1;
+        // JD of Jan 0.0 of epochYear (Gregorian), valid 1901..2099
+        double jan0 = 1721424.5 + 365.0 * y + y / 4 - y / 100 + y / 400;
+        return jan0 + epochDay;
+    }
+
+    // Mean anomaly advanced (two-body) from the element epoch to refJD
+    double meanAnomalyAt(double refJD) const {
+        return std::fmod(meanAnomaly + meanMotion() * (refJD - epochJD()) * SEC_PER_DAY, 2 * M_PI);
+    }
+};
+
+// --- FIXED-COLUMN FIELD PARSERS (no allocation) ---
+// cols are 1-based, inclusive, exactly as in the TLE spec.
+inline double tleNumber(const char* line, int c0, int c1) {
+    const double POW10[] = {1, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10, 1e-11, 1e-12};
+    const char* p = line + c0 - 1;
+    const char* end = line + c1;
+    while (p < end && *p == ' ') p++;
+    double sign = 1.0;
+    if (p < end && (*p == '-' || *p == '+')) { if (*p == '-') sign = -1.0; p++; }
+    uint64_t digits = 0;
+    int fracDigits = -1;
+    for (; p < end; p++) {
+        if (*p >= '0' && *p <= '9') { digits = digits * 10 + (*p - '0'); if (fracDigits >= 0) fracDigits++; }
+        else if (*p == '.') fracDigits = 0;
+        else break;
+    }
+    if (fracDigits > 12) fracDigits = 12;
+    return sign * (double)digits * (fracDigits > 0 ? POW10[fracDigits] : 1.0);
+}
+
+// "Implied decimal + exponent" fields like " 28098-4" -> 0.28098e-4
+inline double tleExponent(const char* line, int c0, int c1) {
+    const char* p = line + c0 - 1;
+    const char* end = line + c1;
+    while (p < end && *p == ' ') p++;
+    double sign = 1.0;
+    if (p < end && (*p == '-' || *p == '+')) { if (*p == '-') sign = -1.0; p++; }
+    double mant = 0, scale = 1;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) { mant = mant * 10 + (*p - '0'); scale *= 10; }
+    int expSign = 1, expo = 0;
+    if (p < end && (*p == '-' || *p == '+')) { if (*p == '-') expSign = -1; p++; }
+    for (; p < end && *p >= '0' && *p <= '9'; p++) expo = expo * 10 + (*p - '0');
+    return sign * (mant / scale) * std::pow(10.0, expSign * expo);
+}
+
+inline bool tleChecksumOk(const char* line) {
+    int sum = 0;
+    for (int i = 0; i < 68; i++) {
+        char ch = line[i];
+        if (ch >= '0' && ch <= '9') sum += ch - '0';
+        else if (ch == '-') sum += 1;
+    }
+    return line[68] >= '0' && line[68] <= '9' && (sum % 10) == line[68] - '0';
+}
+
+inline uint64_t fnv1a(const char* p, size_t n, uint64_t h = 1469598103934665603ull) {
+    for (size_t i = 0; i < n; i++) { h ^= (unsigned char)p[i]; h *= 1099511628211ull; }
+    return h;
+}
+
+// Parse one record whose lines are already located. Returns false on a
+// malformed or checksum-failed record.
+inline bool parseTle(const char* title, size_t titleLen, const char* l1, const char* l2, TleRecord& out) {
+    if (l1[0] != '1' || l2[0] != '2') return false;
+    if (!tleChecksumOk(l1) || !tleChecksumOk(l2)) return false;
+
+    const double DEG = M_PI / 180.0;
+    size_t n = titleLen < sizeof(out.name) - 1 ? titleLen : sizeof(out.name) - 1;
+    if (title && n >= 2 && title[0] == '0' && title[1] == ' ') { title += 2; n -= 2; }   // "0 NAME" 3LE flavour
+    std::memcpy(out.name, title ? title : "", title ? n : 0);
+    while (n > 0 && (out.name[n - 1] == ' ' || out.name[n - 1] == '\r')) n--;
+    out.name[title ? n : 0] = '\0';
+
+    out.satnum = (int)tleNumber(l1, 3, 7);
+    int yy = (int)tleNumber(l1, 19, 20);
+    out.epochYear = yy < 57 ? 2000 + yy : 1900 + yy;
+    out.epochDay = tleNumber(l1, 21, 32);
+    out.ndot = tleNumber(l1, 34, 43);
+    out.nddot = tleExponent(l1, 45, 52);
+    out.bstar = tleExponent(l1, 54, 61);
+
+    out.inclination = tleNumber(l2, 9, 16) * DEG;
+    out.raan = tleNumber(l2, 18, 25) * DEG;
+    out.ecc = tleNumber(l2, 27, 33) * 1e-7;
+    out.argPerigee = tleNumber(l2, 35, 42) * DEG;
+    out.meanAnomaly = tleNumber(l2, 44, 51) * DEG;
+    out.revsPerDay = tleNumber(l2, 53, 63);
+    return out.revsPerDay > 0;
+}
+
+class TleCatalog {
+public:
+    std::vector<TleRecord> records;
+    size_t badRecords = 0;          // checksum / format failures in the last (re)load
+    size_t reparsed = 0;            // records actually parsed in the last (re)load
+    size_t removed = 0;             // records the last reload dropped
+    size_t moved = 0;               // unchanged records the last reload found at a new index
+
+    TleCatalog() = default;
+    TleCatalog(const TleCatalog&) = delete;
+    TleCatalog& operator=(const TleCatalog&) = delete;
+    ~TleCatalog() { unmap(); }
+
+    bool load(const char* path) {
+        filePath = path;
+        records.clear();
+        index.clear();
+        loaded = false;
+        return reload() != NO_FILE;
+    }
+
+    static const size_t NO_FILE = (size_t)-1;
+
+    // Re-read the file if it changed since the last load. Returns the number
+    // of records that were (re)parsed, dropped or moved (anything that makes
+    // `records` differ), 0 if nothing changed, NO_FILE on error.
+    size_t reload() {
+        struct stat st;
+        if (stat(filePath.c_str(), &st) != 0) return NO_FILE;
+        if (loaded && st.st_size == fileSize && st.st_mtime == fileMtime) return 0;
+
+        int fd = open(filePath.c_str(), O_RDONLY);
+        if (fd < 0) return NO_FILE;
+        mappedSize = (size_t)st.st_size;
+        if (mappedSize > 0) {
+            void* p = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { close(fd); mappedSize = 0; return NO_FILE; }
+            madvise(p, mappedSize, MADV_SEQUENTIAL);
+            data = (const char*)p;
+        }
+        close(fd);
+
+        // Records are copied out, so the mapping only lives for the parse
+        parseAll();
+        unmap();
+        loaded = true;
+        fileSize = st.st_size;
+        fileMtime = st.st_mtime;
+        return reparsed + removed + moved;
+    }
+
+    // Catalog number -> index into records
+    const TleRecord* find(int satnum) const {
+        auto it = index.find(satnum);
+        return it == index.end() ? nullptr : &records[it->second];
+    }
+
+    // Latest element epoch in the catalog (used as t = 0 by the propagators)
+    double latestEpochJD() const {
+        double jd = 0;
+        for (const auto& r : records) if (r.epochJD() > jd) jd = r.epochJD();
+        return jd;
+    }
+
+    // Fill a KeplerBatch with every record, mean anomaly advanced from each
+    // record's own epoch to the common reference epoch `refJD` (t = 0).
+    void toKeplerBatch(KeplerBatch& batch, double refJD) const {
+        batch.clear();
+        batch.reserve(records.size());
+        for (const auto& r : records) {
+            batch.add(r.inclination, r.raan, r.ecc, r.argPerigee, r.meanAnomalyAt(refJD), r.meanMotion());
+        }
+    }
+
+private:
+    void unmap() {
+        if (data) munmap((void*)data, mappedSize);
+        data = nullptr;
+        mappedSize = 0;
+    }
+
+    // Find the end of the line starting at p (excluding \r\n)
+    const char* lineEnd(const char* p, const char* end) const {
+        const char* nl = (const char*)std::memchr(p, '\n', end - p);
+        return nl ? nl : end;
+    }
+
+    void parseAll() {
+        std::vector<TleRecord> fresh;
+        std::unordered_map<int, size_t> freshIndex;
+        fresh.reserve(records.empty() ? mappedSize / 140 : records.size());
+        freshIndex.reserve(fresh.capacity());
+        badRecords = 0;
+        reparsed = removed = moved = 0;
+
+        const char* p = data;
+        const char* end = data + mappedSize;
+        const char* title = nullptr;
+        size_t titleLen = 0;
+
+        while (p < end) {
+            const char* e = lineEnd(p, end);
+            size_t len = e - p;
+            if (len > 0 && p[len - 1] == '\r') len--;
+
+            if (len >= 69 && p[0] == '1' && p[1] == ' ') {
+                const char* l1 = p;
+                const char* next = e < end ? e + 1 : end;
+                const char* e2 = lineEnd(next, end);
+                size_t len2 = e2 - next;
+                if (len2 > 0 && next[len2 - 1] == '\r') len2--;
+
+                if (len2 >= 69 && next[0] == '2') {
+                    const char* recStart = title ? title : l1;
+                    uint64_t h = fnv1a(recStart, (next + 69) - recStart);
+
+                    // Unchanged record? Reuse the previous parse.
+                    int satnum = (int)tleNumber(l1, 3, 7);
+                    auto old = index.find(satnum);
+                    TleRecord rec;
+                    bool ok;
+                    if (old != index.end() && records[old->second].hash == h) {
+                        rec = records[old->second];
+                        ok = true;
+                        moved += old->second != fresh.size();
+                    } else {
+                        ok = parseTle(title, titleLen, l1, next, rec);
+                        rec.hash = h;
+                        reparsed++;
+                    }
+                    if (ok) {
+                        freshIndex[rec.satnum] = fresh.size();
+                        fresh.push_back(rec);
+                    } else {
+                        badRecords++;
+                    }
+                    title = nullptr;
+                    p = e2 < end ? e2 + 1 : end;
+                    continue;
+                }
+                badRecords++;
+                title = nullptr;
+            } else if (len > 0) {
+                title = p;          // candidate 3LE name line
+                titleLen = len;
+            }
+            p = e < end ? e + 1 : end;
+        }
+
+        for (const auto& kv : index) removed += freshIndex.find(kv.first) == freshIndex.end();
+        records.swap(fresh);
+        index.swap(freshIndex);
+    }
+
+    std::string filePath;
+    const char* data = nullptr;
+    size_t mappedSize = 0;
+    bool loaded = false;
+    off_t fileSize = 0;
+    time_t fileMtime = 0;
+    std::unordered_map<int, size_t> index;
+};
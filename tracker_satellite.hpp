@@ -0,0 +1,52 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "integrators.hpp"
+#include "time_warp.hpp"
+#include <cmath>
+
+// ============================================================================
+// The 2D tracker's physics (Tracker.cpp): the integrated satellite and the
+// rotating ground station. Kept apart from the SFML code so headless tools
+// (bench_suite) run exactly what the tracker runs.
+// ============================================================================
+
+class Satellite {
+public:
+    Vector3 pos;
+    Vector3 vel;
+    double time = 0.0;
+    Integrator integrator;          // Forest-Ruth, 10 s steps by default (I key cycles)
+    TimeWarp warp;                  // long steps jump analytically instead
+
+    Satellite(Vector3 p, Vector3 v) : pos(p), vel(v) {}
+
+    // Advance dt seconds: integrator substeps, or one Kepler jump when dt
+    // spans more than TimeWarp::MAX_INTEGRATED_STEPS of them
+    void update(double dt) {
+        OrbitState s = {pos, vel};
+        warp.advance(integrator, s, time, dt, TwoBodyForce());
+        pos = s.pos;
+        vel = s.vel;
+        time += dt;
+    }
+};
+
+// --- Geography Helper ---
+inline Vector3 getStationPos(double lat, double lon, double time) {
+    double latRad = lat * (M_PI / 180.0);
+    double lonRad = lon * (M_PI / 180.0);
+
+    // 1. Fixed Earth Position (ECEF)
+    double x = R_EARTH * std::cos(latRad) * std::cos(lonRad);
+    double y = R_EARTH * std::cos(latRad) * std::sin(lonRad);
+    double z = R_EARTH * std::sin(latRad);
+
+    // 2. Rotate with Earth 
+    double rotationAngle = EARTH_ROTATION_SPEED * time;
+
+    // Rotation Matrix (Z-axis)
+    double x_rot = x * std::cos(rotationAngle) - y * std::sin(rotationAngle);
+    double y_rot = x * std::sin(rotationAngle) + y * std::cos(rotationAngle);
+    
+    return {x_rot, y_rot, z};
+}
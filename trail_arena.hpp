@@ -0,0 +1,129 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+// ============================================================================
+// TrailArena: position history for every object in one contiguous block.
+//
+// Each object owns a fixed-capacity ring of TrailSample (float ECI metres +
+// float seconds since the arena epoch, 16 bytes) at [i * capacity, ...), so
+// append is O(1) and never moves memory, and the whole catalog's history
+// is objects * capacity * 16 bytes, fixed at reset(). With a byte budget
+// the per-object capacity shrinks to fit: 100k objects in 64 MB keep about
+// 40 samples each.
+//
+// Decimation is by simulation time, per object: push() only stores a
+// sample once `interval` seconds have passed since that object's last one,
+// so trail density no longer depends on the frame rate or on how many
+// objects share a counter.
+//
+// Floats hold ECI to ~0.5 m at GEO and time to ~0.1 s over ten days from
+// the epoch, well below a pixel.
+// ============================================================================
+
+struct TrailSample {
+    float x, y, z;      // ECI [m]
+    float t;            // s since TrailArena::epoch
+};
+
+class TrailArena {
+public:
+    double epoch = 0;           // time origin of TrailSample::t
+    double interval = 0;        // min seconds between samples (0 = every push)
+
+    TrailArena() = default;
+    TrailArena(size_t objects, uint32_t maxCapacity, double sampleInterval, size_t budgetBytes = 0) {
+        reset(objects, maxCapacity, sampleInterval, budgetBytes);
+    }
+
+    // Forget all history. Capacity = maxCapacity, or less to fit budgetBytes.
+    void reset(size_t objects, uint32_t maxCapacity, double sampleInterval, size_t budgetBytes = 0, double t0 = 0) {
+        cap = maxCapacity;
+        if (budgetBytes && objects) {
+            size_t fit = budgetBytes / (objects * sizeof(TrailSample));
+            cap = (uint32_t)std::max<size_t>(2, std::min<size_t>(cap, fit));
+        }
+        n = objects;
+        interval = sampleInterval;
+        epoch = t0;
+        samples.assign(n * cap, TrailSample{0, 0, 0, 0});
+        head.assign(n, 0);
+        count.assign(n, 0);
+        lastT.assign(n, 0.0);
+    }
+
+    size_t objects() const { return n; }
+    uint32_t capacity() const { return cap; }
+    size_t bytes() const {
+        return samples.size() * sizeof(TrailSample) + n * (2 * sizeof(uint32_t) + sizeof(double));
+    }
+
+    // Record object i at time t if its interval has elapsed; true if stored
+    // (never a NaN position: an object without one, e.g. decayed, leaves a gap)
+    bool push(size_t i, double t, double x, double y, double z) {
+        if (x != x || (count[i] && t - lastT[i] < interval)) return false;
+        samples[i * cap + head[i]] = TrailSample{(float)x, (float)y, (float)z, (float)(t - epoch)};
+        head[i] = head[i] + 1 == cap ? 0 : head[i] + 1;
+        if (count[i] < cap) count[i]++;
+        lastT[i] = t;
+        return true;
+    }
+
+    // Objects [begin, end) from column arrays; safe to split across threads
+    void pushRange(size_t begin, size_t end, double t, const double* x, const double* y, const double* z) {
+        for (size_t i = begin; i < end; i++) push(i, t, x[i], y[i], z[i]);
+    }
+
+    uint32_t size(size_t i) const { return count[i]; }
+
+    // k-th stored sample of object i, 0 = oldest
+    const TrailSample& at(size_t i, uint32_t k) const {
+        uint32_t slot = head[i] + cap - count[i] + k;
+        if (slot >= cap) slot -= cap;
+        if (slot >= cap) slot -= cap;
+        return samples[i * cap + slot];
+    }
+
+    // Object i's ring as stored: size(i) valid samples at [0, size(i)),
+    // in slot order (oldest first only until the ring wraps)
+    const TrailSample* ring(size_t i) const { return samples.data() + i * cap; }
+
+    // Visit object i's samples oldest to newest (two linear runs, no modulo)
+    template <class Fn>
+    void forEach(size_t i, Fn fn) const {
+        const TrailSample* ring = samples.data() + i * cap;
+        uint32_t start = head[i] >= count[i] ? head[i] - count[i] : head[i] + cap - count[i];
+        uint32_t first = std::min(count[i], cap - start);
+        for (uint32_t k = 0; k < first; k++) fn(ring[start + k]);
+        for (uint32_t k = 0; k < count[i] - first; k++) fn(ring[k]);
+    }
+
+    // Raw rings for checkpoints (checkpoint.hpp): n * capacity samples
+    // object-major, then per object the next write slot, the stored count
+    // and the time of the newest sample
+    const TrailSample* data() const { return samples.data(); }
+    const uint32_t* heads() const { return head.data(); }
+    const uint32_t* counts() const { return count.data(); }
+    const double* lastTimes() const { return lastT.data(); }
+
+    void restore(size_t objects, uint32_t capacity, double sampleInterval, double t0,
+                 const TrailSample* s, const uint32_t* h, const uint32_t* c, const double* last) {
+        n = objects;
+        cap = capacity;
+        interval = sampleInterval;
+        epoch = t0;
+        samples.assign(s, s + n * cap);
+        head.assign(h, h + n);
+        count.assign(c, c + n);
+        lastT.assign(last, last + n);
+    }
+
+private:
+    size_t n = 0;
+    uint32_t cap = 0;
+    std::vector<TrailSample> samples;       // n * cap, object-major
+    std::vector<uint32_t> head, count;      // next write slot, stored samples
+    std::vector<double> lastT;              // time of the newest sample
+};
@@ -0,0 +1,275 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ============================================================================
+// Binary columnar trajectory stream.
+//
+//   header   TrajectoryHeader (64 bytes, little endian)
+//   ids      uint32 satnum[objects]
+//   base     double x[objects], y[objects], z[objects]   (F32_DELTA only)
+//   frames   frameCount fixed-size records:
+//              F64:        double t, double x[N], double y[N], double z[N]
+//              F32_DELTA:  double t, float dx[N], float dy[N], float dz[N]
+//
+// Positions are ECI metres. F32_DELTA stores each frame as the float
+// difference from the previous *decoded* frame (the writer tracks what the
+// reader will reconstruct), so rounding never accumulates: the error stays
+// at float precision of one step's motion (~cm for LEO at 60 s) and the
+// stream is half the size. Decoding is sequential from the base frame.
+// An object without a position (NaN, e.g. decayed under SGP4) stays NaN
+// from that frame on in F32_DELTA, since its decoded reference is lost.
+//
+// TrajectoryWriter stages small frames in a large buffer and hands big ones
+// to writev() straight from the column arrays; nothing is flushed per frame.
+// ============================================================================
+
+enum class TrajectoryEncoding : uint32_t { F64 = 0, F32_DELTA = 1 };
+
+struct TrajectoryHeader {
+    char magic[8];              // "ORBTRAJ\0"
+    uint32_t version;           // 1
+    uint32_t encoding;          // TrajectoryEncoding
+    uint64_t objects;
+    uint64_t frameCount;        // patched on close()
+    double startTime;           // s
+    double cadence;             // s between frames
+    uint64_t reserved[2];
+};
+static_assert(sizeof(TrajectoryHeader) == 64, "trajectory header layout");
+
+const char TRAJECTORY_MAGIC[8] = {'O', 'R', 'B', 'T', 'R', 'A', 'J', '\0'};
+
+class TrajectoryWriter {
+public:
+    TrajectoryWriter() = default;
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+    ~TrajectoryWriter() { close(); }
+
+    bool open(const char* path, size_t objects, const uint32_t* ids, TrajectoryEncoding enc,
+              double startTime, double cadence) {
+        fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        n = objects;
+        encoding = enc;
+        frames = 0;
+        written = 0;
+        failed = false;
+        stage.clear();
+        stage.reserve(STAGE_BYTES);
+
+        TrajectoryHeader h = {};
+        std::memcpy(h.magic, TRAJECTORY_MAGIC, sizeof(h.magic));
+        h.version = 1;
+        h.encoding = (uint32_t)enc;
+        h.objects = objects;
+        h.startTime = startTime;
+        h.cadence = cadence;
+        append(&h, sizeof(h));
+        append(ids, n * sizeof(uint32_t));
+        haveBase = false;
+        return !failed;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+    uint64_t frameCount() const { return frames; }
+    uint64_t bytesWritten() const { return written + stage.size(); }
+    bool ok() const { return !failed; }
+
+    size_t frameBytes() const {
+        return sizeof(double) + 3 * n * (encoding == TrajectoryEncoding::F64 ? sizeof(double) : sizeof(float));
+    }
+
+    void writeFrame(double t, const double* x, const double* y, const double* z) {
+        if (encoding == TrajectoryEncoding::F64) {
+            struct iovec iov[4] = {{&t, sizeof(t)}, {(void*)x, n * sizeof(double)},
+                                   {(void*)y, n * sizeof(double)}, {(void*)z, n * sizeof(double)}};
+            appendv(iov, 4);
+        } else {
+            if (!haveBase) {
+                // Base frame: the reference the first deltas start from
+                prevX.assign(x, x + n); prevY.assign(y, y + n); prevZ.assign(z, z + n);
+                append(x, n * sizeof(double)); append(y, n * sizeof(double)); append(z, n * sizeof(double));
+                dx.resize(n); dy.resize(n); dz.resize(n);
+                haveBase = true;
+            }
+            encodeDelta(x, prevX.data(), dx.data());
+            encodeDelta(y, prevY.data(), dy.data());
+            encodeDelta(z, prevZ.data(), dz.data());
+            struct iovec iov[4] = {{&t, sizeof(t)}, {dx.data(), n * sizeof(float)},
+                                   {dy.data(), n * sizeof(float)}, {dz.data(), n * sizeof(float)}};
+            appendv(iov, 4);
+        }
+        frames++;
+    }
+
+    // Flush, patch the frame count into the header, close. Returns success.
+    bool close() {
+        if (fd < 0) return !failed;
+        flush();
+        if (!failed) {
+            uint64_t count = frames;
+            if (pwrite(fd, &count, sizeof(count), offsetof(TrajectoryHeader, frameCount)) != (ssize_t)sizeof(count)) failed = true;
+        }
+        ::close(fd);
+        fd = -1;
+        return !failed;
+    }
+
+private:
+    static const size_t STAGE_BYTES = 8 << 20;
+
+    // delta = float(cur - prev); prev += delta (exactly what the reader does)
+    void encodeDelta(const double* cur, double* prev, float* out) {
+        for (size_t i = 0; i < n; i++) {
+            float d = (float)(cur[i] - prev[i]);
+            out[i] = d;
+            prev[i] += d;
+        }
+    }
+
+    void append(const void* p, size_t bytes) {
+        struct iovec iov = {(void*)p, bytes};
+        appendv(&iov, 1);
+    }
+
+    // Small pieces are copied into the staging buffer; anything that would
+    // not fit goes out with one writev() behind whatever is staged.
+    void appendv(struct iovec* iov, int count) {
+        size_t total = 0;
+        for (int k = 0; k < count; k++) total += iov[k].iov_len;
+        if (stage.size() + total <= STAGE_BYTES) {
+            for (int k = 0; k < count; k++) {
+                const char* p = (const char*)iov[k].iov_base;
+                stage.insert(stage.end(), p, p + iov[k].iov_len);
+            }
+            return;
+        }
+        struct iovec all[8];
+        int m = 0;
+        if (!stage.empty()) all[m++] = {stage.data(), stage.size()};
+        for (int k = 0; k < count; k++) all[m++] = iov[k];
+        writeAll(all, m);
+        stage.clear();
+    }
+
+    void flush() {
+        if (stage.empty()) return;
+        struct iovec iov = {stage.data(), stage.size()};
+        writeAll(&iov, 1);
+        stage.clear();
+    }
+
+    // writev() until everything is out (handles short writes)
+    void writeAll(struct iovec* iov, int count) {
+        while (count > 0 && !failed) {
+            ssize_t w = ::writev(fd, iov, count);
+            if (w < 0) { failed = true; return; }
+            written += (uint64_t)w;
+            while (count > 0 && (size_t)w >= iov->iov_len) { w -= iov->iov_len; iov++; count--; }
+            if (count > 0) { iov->iov_base = (char*)iov->iov_base + w; iov->iov_len -= w; }
+        }
+    }
+
+    int fd = -1;
+    size_t n = 0;
+    TrajectoryEncoding encoding = TrajectoryEncoding::F64;
+    uint64_t frames = 0, written = 0;
+    bool failed = false, haveBase = false;
+    std::vector<char> stage;
+    std::vector<double> prevX, prevY, prevZ;
+    std::vector<float> dx, dy, dz;
+};
+
+// mmap'd sequential reader (frames decode in order; F32_DELTA needs that)
+class TrajectoryReader {
+public:
+    TrajectoryHeader header = {};
+    const uint32_t* ids = nullptr;
+
+    TrajectoryReader() = default;
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+    ~TrajectoryReader() { if (data) munmap((void*)data, size); }
+
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TrajectoryHeader)) { ::close(fd); return false; }
+        size = (size_t)st.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) { data = nullptr; return false; }
+        data = (const char*)p;
+        madvise(p, size, MADV_SEQUENTIAL);
+
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic)) != 0 || header.version != 1) return false;
+        if (header.encoding > (uint32_t)TrajectoryEncoding::F32_DELTA) return false;
+        // Everything the header promises must lie inside the mapping (a
+        // truncated or corrupt file is rejected here, before any copy);
+        // n <= size / 8 also keeps the byte counts below from overflowing
+        if (header.objects > size / sizeof(double)) return false;
+        size_t n = header.objects;
+        bool f64 = header.encoding == (uint32_t)TrajectoryEncoding::F64;
+        size_t fixed = sizeof(header) + n * sizeof(uint32_t) + (f64 ? 0 : 3 * n * sizeof(double));
+        size_t frameBytes = sizeof(double) + 3 * n * (f64 ? sizeof(double) : sizeof(float));
+        if (fixed > size || header.frameCount > (size - fixed) / frameBytes) return false;
+        ids = (const uint32_t*)(data + sizeof(header));
+        cursor = sizeof(header) + n * sizeof(uint32_t);
+        x.resize(n); y.resize(n); z.resize(n);
+        if (header.encoding == (uint32_t)TrajectoryEncoding::F32_DELTA) {
+            // memcpy: the base frame sits behind 4-byte ids, not 8-byte aligned
+            std::memcpy(x.data(), data + cursor, n * sizeof(double)); cursor += n * sizeof(double);
+            std::memcpy(y.data(), data + cursor, n * sizeof(double)); cursor += n * sizeof(double);
+            std::memcpy(z.data(), data + cursor, n * sizeof(double)); cursor += n * sizeof(double);
+        }
+        nextFrame = 0;
+        return true;
+    }
+
+    size_t objects() const { return header.objects; }
+    uint64_t frameCount() const { return header.frameCount; }
+
+    // Decode the next frame into x/y/z; false at the end
+    bool next(double& t) {
+        size_t n = header.objects;
+        bool f64 = header.encoding == (uint32_t)TrajectoryEncoding::F64;
+        size_t bytes = sizeof(double) + 3 * n * (f64 ? sizeof(double) : sizeof(float));
+        if (nextFrame >= header.frameCount || cursor + bytes > size) return false;
+        const char* p = data + cursor;
+        std::memcpy(&t, p, sizeof(double));
+        p += sizeof(double);
+        if (f64) {
+            std::memcpy(x.data(), p, n * sizeof(double)); p += n * sizeof(double);
+            std::memcpy(y.data(), p, n * sizeof(double)); p += n * sizeof(double);
+            std::memcpy(z.data(), p, n * sizeof(double));
+        } else {
+            const float* d = (const float*)p;
+            for (size_t i = 0; i < n; i++) x[i] += d[i];
+            for (size_t i = 0; i < n; i++) y[i] += d[n + i];
+            for (size_t i = 0; i < n; i++) z[i] += d[2 * n + i];
+        }
+        cursor += bytes;
+        nextFrame++;
+        return true;
+    }
+
+    std::vector<double> x, y, z;        // last decoded frame [m]
+
+private:
+    const char* data = nullptr;
+    size_t size = 0, cursor = 0;
+    uint64_t nextFrame = 0;
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// View transform: one matrix per frame, whole point arrays per call.
+//
+// The viewers used to run every point through rotateY() and rotateX() (four
+// sin/cos each), spin the earth per point and normalise it for lighting
+// with a sqrt. ViewTransform folds model (earth spin, ECI -> visual axes,
+// scale) and camera rotation into a single 3x3 matrix once per frame;
+// project() then applies it to SoA float arrays together with the
+// perspective divide and the near-plane test, in one branch-free loop that
+// the compiler vectorises (-O3 -march=native):
+//
+//   view = M * p,   s = focal / (camDist - view.z),
+//   screen = (view.x * s + cx, view.y * s + cy),   keep = view.z < nearZ
+//
+// PointCloud holds a mesh as SoA positions plus unit normals computed once
+// at generation, so per-frame lighting is one dot product with the light
+// direction taken into model space (lightInModel()).
+// ============================================================================
+
+struct Mat3 {
+    double m[3][3];
+
+    static Mat3 identity() { return {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}}; }
+    static Mat3 rotateX(double a) {
+        double c = std::cos(a), s = std::sin(a);
+        return {{{1, 0, 0}, {0, c, -s}, {0, s, c}}};
+    }
+    static Mat3 rotateY(double a) {
+        double c = std::cos(a), s = std::sin(a);
+        return {{{c, 0, s}, {0, 1, 0}, {-s, 0, c}}};
+    }
+    static Mat3 scale(double k) { return {{{k, 0, 0}, {0, k, 0}, {0, 0, k}}}; }
+
+    Mat3 operator*(const Mat3& b) const {
+        Mat3 r;
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) r.m[i][j] = m[i][0] * b.m[0][j] + m[i][1] * b.m[1][j] + m[i][2] * b.m[2][j];
+        return r;
+    }
+
+    // Rotations only: the inverse is the transpose
+    Mat3 transposed() const {
+        Mat3 r;
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) r.m[i][j] = m[j][i];
+        return r;
+    }
+
+    void apply(double x, double y, double z, double& ox, double& oy, double& oz) const {
+        ox = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+        oy = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+        oz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+    }
+};
+
+// Mesh / point set as SoA floats, with unit normals fixed at generation
+struct PointCloud {
+    std::vector<float> x, y, z;
+    std::vector<float> nx, ny, nz;
+
+    size_t size() const { return x.size(); }
+
+    void add(double px, double py, double pz, double qx, double qy, double qz) {
+        x.push_back((float)px); y.push_back((float)py); z.push_back((float)pz);
+        nx.push_back((float)qx); ny.push_back((float)qy); nz.push_back((float)qz);
+    }
+    // Point on a sphere about the origin: the normal is the direction
+    void addOnSphere(double px, double py, double pz) {
+        double r = std::sqrt(px * px + py * py + pz * pz);
+        add(px, py, pz, px / r, py / r, pz / r);
+    }
+};
+
+// Output of project(): screen position, view depth, near-plane keep flag
+struct ProjectedPoints {
+    std::vector<float> sx, sy, vz;
+    std::vector<uint8_t> keep;
+
+    void resize(size_t n) {
+        if (sx.size() < n) { sx.resize(n); sy.resize(n); vz.resize(n); keep.resize(n); }
+    }
+};
+
+class ViewTransform {
+public:
+    Mat3 camera = Mat3::identity();     // view rotation
+    Mat3 model = Mat3::identity();      // object -> world (spin, axis swap, scale)
+    double focal = 600, camDist = 1000; // s = focal / (camDist - z)
+    double cx = 0, cy = 0;              // screen centre
+    double nearZ = 1e30;                // points with view z >= nearZ are culled
+
+    // Camera looking down -z, yaw (about Y) applied first, then pitch (about X)
+    static ViewTransform orbitCamera(double pitch, double yaw, double focal, double camDist, double cx, double cy,
+                                     double nearZ = 1e30) {
+        ViewTransform v;
+        v.camera = Mat3::rotateX(pitch) * Mat3::rotateY(yaw);
+        v.focal = focal; v.camDist = camDist;
+        v.cx = cx; v.cy = cy;
+        v.nearZ = nearZ;
+        v.update();
+        return v;
+    }
+
+    // Same camera, different object placement
+    ViewTransform withModel(const Mat3& m) const {
+        ViewTransform v = *this;
+        v.model = m;
+        v.update();
+        return v;
+    }
+
+    // A world-space direction (e.g. towards the sun) in the model's frame
+    void lightInModel(double wx, double wy, double wz, float& lx, float& ly, float& lz) const {
+        double x, y, z;
+        model.transposed().apply(wx, wy, wz, x, y, z);
+        lx = (float)x; ly = (float)y; lz = (float)z;
+    }
+
+    // Eye position in the model's frame (rotation-only models)
+    void cameraInModel(double& x, double& y, double& z) const {
+        combined.transposed().apply(0, 0, camDist, x, y, z);
+    }
+
+    // camera * model: model -> view coordinates
+    const Mat3& matrix() const { return combined; }
+
+    // n points: screen xy, view z and keep flag, one pass
+    void project(const float* __restrict px, const float* __restrict py, const float* __restrict pz, size_t n,
+                 float* __restrict sx, float* __restrict sy, float* __restrict vz, uint8_t* __restrict keep) const {
+        const float m00 = f[0], m01 = f[1], m02 = f[2], m10 = f[3], m11 = f[4], m12 = f[5], m20 = f[6], m21 = f[7], m22 = f[8];
+        const float F = (float)focal, D = (float)camDist, CX = (float)cx, CY = (float)cy, NZ = (float)nearZ;
+        for (size_t i = 0; i < n; i++) {
+            float x = px[i], y = py[i], z = pz[i];
+            float vx = m00 * x + m01 * y + m02 * z;
+            float vy = m10 * x + m11 * y + m12 * z;
+            float w = m20 * x + m21 * y + m22 * z;
+            float s = F / (D - w);
+            sx[i] = vx * s + CX;
+            sy[i] = vy * s + CY;
+            vz[i] = w;
+            keep[i] = w < NZ;
+        }
+    }
+
+    void project(const PointCloud& pc, ProjectedPoints& out) const {
+        out.resize(pc.size());
+        project(pc.x.data(), pc.y.data(), pc.z.data(), pc.size(), out.sx.data(), out.sy.data(), out.vz.data(), out.keep.data());
+    }
+
+    // Interleaved xyz with a stride of `stride` floats (e.g. TrailSample)
+    void projectStrided(const float* __restrict p, size_t stride, size_t n, float* __restrict sx, float* __restrict sy) const {
+        const float m00 = f[0], m01 = f[1], m02 = f[2], m10 = f[3], m11 = f[4], m12 = f[5], m20 = f[6], m21 = f[7], m22 = f[8];
+        const float F = (float)focal, D = (float)camDist, CX = (float)cx, CY = (float)cy;
+        for (size_t i = 0; i < n; i++) {
+            float x = p[i * stride], y = p[i * stride + 1], z = p[i * stride + 2];
+            float s = F / (D - (m20 * x + m21 * y + m22 * z));
+            sx[i] = (m00 * x + m01 * y + m02 * z) * s + CX;
+            sy[i] = (m10 * x + m11 * y + m12 * z) * s + CY;
+        }
+    }
+
+    // Single point in double precision (stations, sun, satellites)
+    bool projectPoint(double x, double y, double z, float& sx, float& sy, double* viewZ = nullptr) const {
+        double vx, vy, w;
+        combined.apply(x, y, z, vx, vy, w);
+        double s = focal / (camDist - w);
+        sx = (float)(vx * s + cx);
+        sy = (float)(vy * s + cy);
+        if (viewZ) *viewZ = w;
+        return w < nearZ;
+    }
+
+private:
+    void update() {
+        combined = camera * model;
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) f[i * 3 + j] = (float)combined.m[i][j];
+    }
+
+    Mat3 combined = Mat3::identity();
+    float f[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+};
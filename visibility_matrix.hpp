@@ -0,0 +1,250 @@
+#pragma once
+#include "orbit_common.hpp"
+#include "pass_predictor.hpp"
+#include "work_stealing.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+// ============================================================================
+// VisibilityMatrix: which satellites every ground station sees, per step.
+//
+// Stations are fixed in ECEF, so they are bucketed once into a lat/lon cell
+// grid. Each step, every satellite's sub-satellite point and footprint
+// radius (earth central angle at the lowest station mask) select the few
+// cells its footprint can touch, and only the stations in those cells get
+// the exact elevation test. Cost ~ N + candidates instead of S * N.
+//
+// Output is CSR, station-major: the satellites seen by station s are
+// sats[offsets[s] .. offsets[s + 1]), ascending. It is two flat arrays, so
+// a step streams with two fwrite()s (writeTo) or expands to a bitset row.
+// ============================================================================
+
+struct VisibilityStep {
+    double t = 0;
+    std::vector<uint32_t> offsets;      // stations + 1
+    std::vector<uint32_t> sats;         // satellite ids, grouped by station
+
+    size_t stationCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t pairs() const { return sats.size(); }
+    const uint32_t* begin(size_t station) const { return sats.data() + offsets[station]; }
+    const uint32_t* end(size_t station) const { return sats.data() + offsets[station + 1]; }
+    size_t count(size_t station) const { return offsets[station + 1] - offsets[station]; }
+
+    // One station's row as a bitset over nSats satellites
+    void toBitset(size_t station, size_t nSats, std::vector<uint64_t>& bits) const {
+        bits.assign((nSats + 63) / 64, 0);
+        for (const uint32_t* p = begin(station); p != end(station); ++p) bits[*p >> 6] |= 1ull << (*p & 63);
+    }
+
+    // Record: t (f64), stations (u32), pairs (u32), offsets[], sats[]
+    bool writeTo(FILE* f) const {
+        uint32_t header[2] = {(uint32_t)stationCount(), (uint32_t)pairs()};
+        return std::fwrite(&t, sizeof(t), 1, f) == 1 && std::fwrite(header, sizeof(header), 1, f) == 1
+            && std::fwrite(offsets.data(), sizeof(uint32_t), offsets.size(), f) == offsets.size()
+            && std::fwrite(sats.data(), sizeof(uint32_t), sats.size(), f) == sats.size();
+    }
+};
+
+// Station list file: one "name lat lon [alt_m] [mask_deg]" per line, '#' comments
+inline bool loadStationFile(const char* path, std::vector<GroundStation>& stations, std::vector<std::string>& names) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) return false;
+    char line[256], name[64];
+    while (std::fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        GroundStation st = {0.0, 0.0, 0.0, 10.0};
+        if (std::sscanf(line, "%63s %lf %lf %lf %lf", name, &st.lat, &st.lon, &st.alt, &st.minElevation) < 3) continue;
+        stations.push_back(st);
+        names.push_back(name);
+    }
+    std::fclose(f);
+    return true;
+}
+
+class VisibilityMatrix {
+public:
+    explicit VisibilityMatrix(const std::vector<GroundStation>& stations, double cellDeg = 5.0)
+        : cellRad(cellDeg * M_PI / 180.0) {
+        rows = (int)std::ceil(180.0 / cellDeg);
+        cols = (int)std::ceil(360.0 / cellDeg);
+        minMask = M_PI / 2;
+        for (const auto& st : stations) {
+            PassPredictor geo(st);          // reuse its WGS84 station vectors
+            Site s;
+            s.ecef = geo.stationEcef();
+            s.up = geo.stationUp();
+            s.sinMask = std::sin(st.minElevation * M_PI / 180.0);
+            sites.push_back(s);
+            minMask = std::fmin(minMask, st.minElevation * M_PI / 180.0);
+        }
+
+        // Bucket stations by cell (CSR)
+        cellStart.assign(rows * cols + 1, 0);
+        std::vector<int> cellOf(stations.size());
+        for (size_t k = 0; k < stations.size(); k++) {
+            cellOf[k] = cellIndex(stations[k].lat * M_PI / 180.0, stations[k].lon * M_PI / 180.0);
+            cellStart[cellOf[k] + 1]++;
+        }
+        for (int c = 0; c < rows * cols; c++) cellStart[c + 1] += cellStart[c];
+        cellStations.resize(stations.size());
+        std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+        for (size_t k = 0; k < stations.size(); k++) cellStations[fill[cellOf[k]]++] = (uint32_t)k;
+        for (size_t k = 0; k < stations.size(); k++) cellSites.push_back(sites[cellStations[k]]);
+    }
+
+    size_t stationCount() const { return sites.size(); }
+
+    // Station-satellite pairs that got the exact test in the last compute()
+    uint64_t candidatesTested() const { return tested; }
+
+    // Positions in ECI [m], earth rotation angle theta [rad] at this step
+    void compute(double t, double theta, const double* x, const double* y, const double* z, size_t n,
+                 VisibilityStep& out, WorkStealingPool* pool = nullptr) {
+        const size_t GRAIN = 2048;
+        size_t chunks = (n + GRAIN - 1) / GRAIN;
+        if (chunkPairs.size() < chunks) chunkPairs.resize(chunks);
+        if (chunkTested.size() < chunks) chunkTested.resize(chunks);
+        double c = std::cos(theta), s = std::sin(theta);
+
+        auto work = [&](size_t begin, size_t end) {
+            size_t chunk = begin / GRAIN;
+            std::vector<uint64_t>& pairs = chunkPairs[chunk];
+            pairs.clear();
+            uint64_t count = 0;
+            for (size_t i = begin; i < end; i++) {
+                Vector3 r = {c * x[i] + s * y[i], -s * x[i] + c * y[i], z[i]};     // ECI -> ECEF
+                count += querySatellite(r, (uint32_t)i, pairs);
+            }
+            chunkTested[chunk] = count;
+        };
+        if (pool) {
+            pool->parallelFor(n, GRAIN, work);
+        } else {
+            for (size_t b = 0; b < n; b += GRAIN) work(b, std::min(n, b + GRAIN));
+        }
+        gather(t, chunks, out);
+    }
+
+    // Reference: every station against every satellite
+    void computeBruteForce(double t, double theta, const double* x, const double* y, const double* z, size_t n,
+                           VisibilityStep& out) {
+        double c = std::cos(theta), s = std::sin(theta);
+        if (chunkPairs.empty()) chunkPairs.resize(1);
+        if (chunkTested.empty()) chunkTested.resize(1);
+        std::vector<uint64_t>& pairs = chunkPairs[0];
+        pairs.clear();
+        for (size_t i = 0; i < n; i++) {
+            Vector3 r = {c * x[i] + s * y[i], -s * x[i] + c * y[i], z[i]};
+            if (!(r.magnitude() > R_EARTH)) continue;
+            for (size_t k = 0; k < sites.size(); k++) {
+                if (sites[k].sees(r)) pairs.push_back((uint64_t)k << 32 | i);
+            }
+        }
+        chunkTested[0] = (uint64_t)n * sites.size();
+        gather(t, 1, out);
+    }
+
+private:
+    struct Site {
+        Vector3 ecef, up;
+        double sinMask;
+        // sin(el) >= sinMask, squared to keep the sqrt off the hot path
+        bool sees(const Vector3& r) const {
+            Vector3 rho = r - ecef;
+            double d = rho.dot(up), d2 = d * d, m2 = sinMask * sinMask * rho.dot(rho);
+            return sinMask >= 0 ? (d >= 0 && d2 >= m2) : (d >= 0 || d2 <= m2);
+        }
+    };
+
+    int cellIndex(double lat, double lon) const {
+        int row = std::min(rows - 1, std::max(0, (int)((lat + M_PI / 2) / cellRad)));
+        int col = (int)std::floor((lon + M_PI) / cellRad) % cols;
+        if (col < 0) col += cols;
+        return row * cols + col;
+    }
+
+    // Test the stations under one footprint; returns how many were tested
+    uint64_t querySatellite(const Vector3& r, uint32_t id, std::vector<uint64_t>& pairs) const {
+        double rm = r.magnitude();
+        if (!(rm > R_EARTH)) return 0;     // below the surface, or no position (NaN)
+        // Earth central angle of the footprint at the lowest mask. The polar
+        // radius and a small margin keep it conservative against WGS84
+        // station heights and geodetic vs geocentric latitude.
+        const double R_POLAR = 6356752.0, MARGIN = 0.01;
+        double lambda = std::acos(std::fmin(1.0, R_POLAR / rm * std::cos(minMask))) - minMask + MARGIN;
+
+        double lat = std::asin(r.z / rm), lon = std::atan2(r.y, r.x);
+        int row0 = std::max(0, (int)((lat - lambda + M_PI / 2) / cellRad));
+        int row1 = std::min(rows - 1, (int)((lat + lambda + M_PI / 2) / cellRad));
+
+        // Longitude half-width of a spherical cap; a cap over a pole spans all
+        int col0 = 0, col1 = cols - 1;
+        if (std::fabs(lat) + lambda < M_PI / 2) {
+            double dLon = std::asin(std::fmin(1.0, std::sin(lambda) / std::cos(lat)));
+            col0 = (int)std::floor((lon - dLon + M_PI) / cellRad);
+            col1 = (int)std::floor((lon + dLon + M_PI) / cellRad);
+            if (col1 - col0 + 1 >= cols) { col0 = 0; col1 = cols - 1; }
+        }
+
+        // Cells are row-major in the CSR, so a column span within one row is
+        // one contiguous run of stations (two when it wraps at +-180 deg)
+        uint64_t count = 0;
+        // Sites are stored in cell order; write every candidate and advance
+        // only on a hit (no unpredictable branch per station)
+        auto scan = [&](int row, int c0, int c1) {
+            uint32_t k0 = cellStart[row * cols + c0], k1 = cellStart[row * cols + c1 + 1];
+            size_t w = pairs.size();
+            pairs.resize(w + (k1 - k0));
+            for (uint32_t k = k0; k < k1; k++) {
+                pairs[w] = (uint64_t)cellStations[k] << 32 | id;
+                w += cellSites[k].sees(r);
+            }
+            pairs.resize(w);
+            count += k1 - k0;
+        };
+        for (int row = row0; row <= row1; row++) {
+            if (col0 < 0) { scan(row, col0 + cols, cols - 1); scan(row, 0, col1); }
+            else if (col1 >= cols) { scan(row, col0, cols - 1); scan(row, 0, col1 - cols); }
+            else scan(row, col0, col1);
+        }
+        return count;
+    }
+
+    // Counting sort of the per-chunk (station, sat) pairs into CSR. Chunks are
+    // in satellite order, so each station's list comes out ascending.
+    void gather(double t, size_t chunks, VisibilityStep& out) {
+        size_t S = sites.size();
+        out.t = t;
+        out.offsets.assign(S + 1, 0);
+        size_t total = 0;
+        tested = 0;
+        for (size_t ch = 0; ch < chunks; ch++) {
+            for (uint64_t p : chunkPairs[ch]) out.offsets[(p >> 32) + 1]++;
+            total += chunkPairs[ch].size();
+            tested += chunkTested[ch];
+        }
+        for (size_t k = 0; k < S; k++) out.offsets[k + 1] += out.offsets[k];
+        out.sats.resize(total);
+        cursor.assign(out.offsets.begin(), out.offsets.end() - 1);
+        for (size_t ch = 0; ch < chunks; ch++) {
+            for (uint64_t p : chunkPairs[ch]) out.sats[cursor[p >> 32]++] = (uint32_t)p;
+        }
+    }
+
+    double cellRad;
+    int rows, cols;
+    double minMask;
+    std::vector<Site> sites;                        // station order
+    std::vector<Site> cellSites;                    // same, in cell order
+    std::vector<uint32_t> cellStart, cellStations;  // cell -> [start, end) of station ids
+
+    // Scratch reused across steps
+    std::vector<std::vector<uint64_t>> chunkPairs;
+    std::vector<uint64_t> chunkTested;
+    std::vector<uint32_t> cursor;
+    uint64_t tested = 0;
+};
@@ -0,0 +1,178 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// ============================================================================
+// WorkStealingPool: persistent worker threads + parallelFor over chunks.
+//
+// parallelFor(n, grain, fn) cuts [0, n) into chunks of `grain` objects and
+// hands every worker a contiguous run of chunk indices. Each run is a single
+// 64-bit atomic word (lo | hi << 32):
+//   * the owner pops chunks from the front (CAS lo -> lo + 1),
+//   * an idle worker steals the back half of a victim's run (CAS hi -> mid)
+//     and makes it its own.
+// No locks on the hot path, and expensive chunks (high-eccentricity Kepler,
+// integrated objects) get spread out automatically. fn(begin, end) writes
+// into caller-owned output arrays indexed by object id, so results land in
+// one shared buffer without merging.
+// ============================================================================
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        runs = std::make_unique<Run[]>(threads);
+        workerCount = threads;
+        // Worker 0 is the calling thread; spawn the rest.
+        for (unsigned w = 1; w < threads; w++) workers.emplace_back([this, w] { workerLoop(w); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+            generation++;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned threadCount() const { return workerCount; }
+
+    // Blocks until fn has been called for every chunk of [0, n).
+    void parallelFor(size_t n, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+        if (n == 0) return;
+        if (grain == 0) grain = 1;
+        size_t chunks = (n + grain - 1) / grain;
+        if (chunks == 1 || workerCount == 1) { fn(0, n); return; }
+
+        // Deal out contiguous runs of chunks, one per worker
+        for (unsigned w = 0; w < workerCount; w++) {
+            uint64_t lo = chunks * w / workerCount, hi = chunks * (w + 1) / workerCount;
+            runs[w].range.store(pack(lo, hi), std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            job = &fn;
+            jobSize = n;
+            jobGrain = grain;
+            pending.store(chunks, std::memory_order_release);
+            generation++;
+        }
+        wake.notify_all();
+
+        drain(0, fn, n, grain);
+
+        // Wait for stragglers finishing their last chunk; no worker may still
+        // hold `fn` once we return
+        std::unique_lock<std::mutex> lock(mtx);
+        done.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0 && active == 0; });
+        job = nullptr;
+    }
+
+    // Chunks taken by a worker other than their original owner (diagnostics)
+    uint64_t stealCount() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Run { std::atomic<uint64_t> range{0}; };
+
+    static uint64_t pack(uint64_t lo, uint64_t hi) { return lo | (hi << 32); }
+    static uint64_t lo32(uint64_t r) { return r & 0xffffffffu; }
+    static uint64_t hi32(uint64_t r) { return r >> 32; }
+
+    // Pop one chunk from the front of worker w's run
+    bool popFront(unsigned w, uint64_t& chunk) {
+        std::atomic<uint64_t>& range = runs[w].range;
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (lo32(r) < hi32(r)) {
+            if (range.compare_exchange_weak(r, pack(lo32(r) + 1, hi32(r)), std::memory_order_acq_rel)) {
+                chunk = lo32(r);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Move the back half of some victim's run into worker w's (empty) run
+    bool steal(unsigned w) {
+        for (unsigned k = 1; k < workerCount; k++) {
+            unsigned v = (w + k) % workerCount;
+            std::atomic<uint64_t>& range = runs[v].range;
+            uint64_t r = range.load(std::memory_order_acquire);
+            while (lo32(r) < hi32(r)) {
+                uint64_t lo = lo32(r), hi = hi32(r);
+                uint64_t mid = lo + (hi - lo) / 2;      // victim keeps [lo, mid)
+                if (range.compare_exchange_weak(r, pack(lo, mid), std::memory_order_acq_rel)) {
+                    runs[w].range.store(pack(mid, hi), std::memory_order_release);
+                    steals.fetch_add(hi - mid, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void drain(unsigned w, const std::function<void(size_t, size_t)>& fn, size_t jobSize, size_t jobGrain) {
+        uint64_t chunk;
+        for (;;) {
+            while (popFront(w, chunk)) {
+                size_t begin = chunk * jobGrain;
+                size_t end = begin + jobGrain < jobSize ? begin + jobGrain : jobSize;
+                fn(begin, end);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    done.notify_all();
+                }
+            }
+            if (!steal(w)) return;
+        }
+    }
+
+    void workerLoop(unsigned w) {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t, size_t)>* fn;
+            size_t n, grain;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                wake.wait(lock, [&] { return generation != seen; });
+                seen = generation;
+                if (quit) return;
+                if (!job) continue;     // woke after that job already finished
+                fn = job; n = jobSize; grain = jobGrain;
+                active++;
+            }
+            drain(w, *fn, n, grain);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                active--;
+            }
+            done.notify_all();
+        }
+    }
+
+    unsigned workerCount = 1;
+    std::unique_ptr<Run[]> runs;
+    std::vector<std::thread> workers;
+
+    std::mutex mtx;
+    std::condition_variable wake, done;
+    uint64_t generation = 0;
+    unsigned active = 0;        // workers inside drain() for the current job
+    bool quit = false;
+
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t jobSize = 0, jobGrain = 1;
+    std::atomic<size_t> pending{0};
+    std::atomic<uint64_t> steals{0};
+};